@@ -2,11 +2,15 @@
 
 #include <cstdint>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace game {
 
+// Rows of the (4, n, 7^tr) game; Board and EdgeGenerator take other counts
+constexpr int32_t kDefaultRows = 4;
+
 enum class CellState : uint8_t {
     Empty = 0,
     Maker = 1,
@@ -34,28 +38,43 @@ struct Cell {
 
 class Board {
 public:
-    explicit Board(int32_t num_cols);
+    explicit Board(int32_t num_cols, int32_t num_rows = kDefaultRows);
     
-    int32_t rows() const { return 4; }
+    int32_t rows() const { return num_rows_; }
     int32_t cols() const { return num_cols_; }
     
-    CellState get(int32_t row, int32_t col) const;
-    CellState get(const Cell& cell) const;
+    CellState get(int32_t row, int32_t col) const {
+        if (!is_valid(row, col)) {
+            throw std::out_of_range("Cell coordinates out of bounds");
+        }
+        return cells_[static_cast<size_t>(row * num_cols_ + col)];
+    }
+    CellState get(const Cell& cell) const { return get(cell.row, cell.col); }
     
-    bool is_empty(int32_t row, int32_t col) const;
-    bool is_empty(const Cell& cell) const;
+    bool is_empty(int32_t row, int32_t col) const {
+        return is_valid(row, col) && cells_[static_cast<size_t>(row * num_cols_ + col)] == CellState::Empty;
+    }
+    bool is_empty(const Cell& cell) const { return is_empty(cell.row, cell.col); }
     
-    bool is_valid(int32_t row, int32_t col) const;
-    bool is_valid(const Cell& cell) const;
+    bool is_valid(int32_t row, int32_t col) const {
+        return row >= 0 && row < num_rows_ && col >= 0 && col < num_cols_;
+    }
+    bool is_valid(const Cell& cell) const { return is_valid(cell.row, cell.col); }
     
-    void set(int32_t row, int32_t col, CellState state);
-    void set(const Cell& cell, CellState state);
+    void set(int32_t row, int32_t col, CellState state) {
+        if (!is_valid(row, col)) {
+            throw std::out_of_range("Cell coordinates out of bounds");
+        }
+        cells_[static_cast<size_t>(row * num_cols_ + col)] = state;
+    }
+    void set(const Cell& cell, CellState state) { set(cell.row, cell.col, state); }
     
     std::vector<Cell> get_empty_cells() const;
     
     std::string to_string() const;
     
 private:
+    int32_t num_rows_;
     int32_t num_cols_;
     std::vector<CellState> cells_;
 };
@@ -0,0 +1,103 @@
+#include "core/EdgeIndex.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace game {
+
+EdgeIndex::EdgeIndex(int32_t num_cols, const std::vector<Hyperedge>& edges, int32_t num_rows)
+    : num_rows_(num_rows)
+    , num_cols_(num_cols) {
+    if (num_cols <= 0 || num_rows <= 0) {
+        throw std::invalid_argument("Number of rows and columns must be positive");
+    }
+
+    // Edge -> cells
+    edge_offsets_.reserve(edges.size() + 1);
+    edge_offsets_.push_back(0);
+    for (const auto& edge : edges) {
+        for (const auto& cell : edge) {
+            if (cell.row < 0 || cell.row >= rows() || cell.col < 0 || cell.col >= num_cols_) {
+                throw std::out_of_range("Edge cell out of bounds");
+            }
+            edge_cells_.push_back(cell_id(cell));
+        }
+        edge_offsets_.push_back(static_cast<int32_t>(edge_cells_.size()));
+    }
+    index_cells();
+}
+
+EdgeIndex::EdgeIndex(int32_t num_cols, int32_t num_rows, std::vector<int32_t> edge_offsets,
+                     std::vector<int32_t> edge_cells)
+    : num_rows_(num_rows)
+    , num_cols_(num_cols)
+    , edge_offsets_(std::move(edge_offsets))
+    , edge_cells_(std::move(edge_cells)) {
+    if (num_cols <= 0 || num_rows <= 0) {
+        throw std::invalid_argument("Number of rows and columns must be positive");
+    }
+    if (edge_offsets_.empty() || edge_offsets_.front() != 0 ||
+        edge_offsets_.back() != static_cast<int32_t>(edge_cells_.size())) {
+        throw std::invalid_argument("Edge offsets must run from 0 to the number of cells");
+    }
+    for (size_t e = 1; e < edge_offsets_.size(); ++e) {
+        if (edge_offsets_[e] < edge_offsets_[e - 1]) {
+            throw std::invalid_argument("Edge offsets must not decrease");
+        }
+    }
+    for (int32_t id : edge_cells_) {
+        if (id < 0 || id >= num_cells()) {
+            throw std::out_of_range("Edge cell out of bounds");
+        }
+    }
+    index_cells();
+}
+
+void EdgeIndex::index_cells() {
+    // Cell -> edges (counting sort by cell id keeps edge ids ascending)
+    std::vector<int32_t> degree(static_cast<size_t>(num_cells()), 0);
+    for (int32_t id : edge_cells_) {
+        ++degree[static_cast<size_t>(id)];
+    }
+    cell_offsets_.assign(static_cast<size_t>(num_cells()) + 1, 0);
+    for (int32_t c = 0; c < num_cells(); ++c) {
+        cell_offsets_[static_cast<size_t>(c) + 1] = cell_offsets_[static_cast<size_t>(c)] + degree[static_cast<size_t>(c)];
+    }
+    cell_edges_.resize(edge_cells_.size());
+    std::vector<int32_t> fill(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    for (int32_t e = 0; e < num_edges(); ++e) {
+        for (int32_t id : cells_of(e)) {
+            cell_edges_[static_cast<size_t>(fill[static_cast<size_t>(id)]++)] = e;
+        }
+    }
+}
+
+std::span<const int32_t> EdgeIndex::edges_of(int32_t cell) const {
+    auto begin = static_cast<size_t>(cell_offsets_[static_cast<size_t>(cell)]);
+    auto end = static_cast<size_t>(cell_offsets_[static_cast<size_t>(cell) + 1]);
+    return {cell_edges_.data() + begin, end - begin};
+}
+
+std::span<const int32_t> EdgeIndex::cells_of(int32_t edge) const {
+    auto begin = static_cast<size_t>(edge_offsets_[static_cast<size_t>(edge)]);
+    auto end = static_cast<size_t>(edge_offsets_[static_cast<size_t>(edge) + 1]);
+    return {edge_cells_.data() + begin, end - begin};
+}
+
+int32_t EdgeIndex::edge_size(int32_t edge) const {
+    return edge_offsets_[static_cast<size_t>(edge) + 1] - edge_offsets_[static_cast<size_t>(edge)];
+}
+
+bool EdgeIndex::maker_completed_edge(const Board& board) const {
+    auto maker = [&](int32_t id) { return board.get(id / num_cols_, id % num_cols_) == CellState::Maker; };
+    for (int32_t c = 0; c < num_cells(); ++c) {
+        if (!maker(c)) continue;
+        for (int32_t e : edges_of(c)) {
+            auto cells = cells_of(e);
+            if (cells.front() == c && std::all_of(cells.begin() + 1, cells.end(), maker)) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game {
+
+// Flat cell <-> edge incidence structure.
+//
+// Cells are numbered row-major (row * cols + col), matching Board's storage.
+// Both directions are stored in CSR form so that the edges through a cell
+// and the cells of an edge can be walked without allocation.
+class EdgeIndex {
+public:
+    EdgeIndex(int32_t num_cols, const std::vector<Hyperedge>& edges, int32_t num_rows = kDefaultRows);
+
+    // From the edge -> cells direction already in CSR form: edge e holds
+    // cell ids edge_cells[edge_offsets[e]] up to edge_offsets[e + 1]
+    EdgeIndex(int32_t num_cols, int32_t num_rows, std::vector<int32_t> edge_offsets,
+              std::vector<int32_t> edge_cells);
+
+    int32_t rows() const { return num_rows_; }
+    int32_t cols() const { return num_cols_; }
+    int32_t num_cells() const { return num_rows_ * num_cols_; }
+    int32_t num_edges() const { return static_cast<int32_t>(edge_offsets_.size()) - 1; }
+
+    int32_t cell_id(const Cell& cell) const { return cell.row * num_cols_ + cell.col; }
+    Cell cell_at(int32_t id) const { return {id / num_cols_, id % num_cols_}; }
+
+    // Ids of all edges containing the given cell
+    std::span<const int32_t> edges_of(int32_t cell) const;
+
+    // Cell ids of the given edge, in canonical order
+    std::span<const int32_t> cells_of(int32_t edge) const;
+
+    int32_t edge_size(int32_t edge) const;
+
+    // True if Maker holds every cell of some edge of `board` (of this shape).
+    // Each edge is checked once, from its first cell, and only if Maker
+    // holds that cell.
+    bool maker_completed_edge(const Board& board) const;
+
+private:
+    int32_t num_rows_;
+    int32_t num_cols_;
+    std::vector<int32_t> edge_offsets_;
+    std::vector<int32_t> edge_cells_;
+    std::vector<int32_t> cell_offsets_;
+    std::vector<int32_t> cell_edges_;
+
+    void index_cells();
+};
+
+} // namespace game
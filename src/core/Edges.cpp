@@ -1,22 +1,34 @@
 #include "core/Edges.h"
+#include "util/Instrument.h"
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 
 namespace game {
 
-std::vector<Hyperedge> EdgeGenerator::generate_edges(int32_t num_cols) {
+std::vector<Hyperedge> EdgeGenerator::generate_edges(int32_t num_cols, int32_t num_rows, int32_t line_length) {
+    if (num_rows <= 0) {
+        throw std::invalid_argument("Number of rows must be positive");
+    }
+    if (line_length < 2 || line_length > kMaxLineLength) {
+        throw std::invalid_argument("Line length must be between 2 and " + std::to_string(kMaxLineLength));
+    }
+    
+    GAME_SCOPE("EdgeGenerator::generate_edges");
+    const Shape shape{num_rows, line_length, std::min(num_rows, line_length)};
     std::vector<Hyperedge> edges;
     
-    // Add standard horizontal edges (length 7)
-    add_horizontal_edges(edges, num_cols);
+    // Add standard horizontal edges (length k)
+    add_horizontal_edges(edges, num_cols, shape);
     
-    // Add truncated edges (length 4-6 at boundaries)
-    add_truncated_horizontal_edges(edges, num_cols);
+    // Add truncated edges (length d..k-1 at boundaries)
+    add_truncated_horizontal_edges(edges, num_cols, shape);
     
-    // Add vertical edges (all columns, length 4)
-    add_vertical_edges(edges, num_cols);
+    // Add vertical edges (length d)
+    add_vertical_edges(edges, num_cols, shape);
     
-    // Add diagonal edges (length 4)
-    add_diagonal_edges(edges, num_cols);
+    // Add diagonal edges (length d)
+    add_diagonal_edges(edges, num_cols, shape);
     
     // Canonicalize all edges
     for (auto& edge : edges) {
@@ -26,16 +38,17 @@ std::vector<Hyperedge> EdgeGenerator::generate_edges(int32_t num_cols) {
     // Sort and remove duplicates efficiently
     std::sort(edges.begin(), edges.end());
     edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    GAME_COUNT("edges.generated", edges.size());
     
     return edges;
 }
 
-void EdgeGenerator::add_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols) {
-    // For each row, generate all length-7 horizontal lines
-    for (int32_t row = 0; row < 4; ++row) {
-        for (int32_t start_col = 0; start_col + 7 <= num_cols; ++start_col) {
+void EdgeGenerator::add_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape) {
+    // For each row, generate all length-k horizontal lines
+    for (int32_t row = 0; row < shape.rows; ++row) {
+        for (int32_t start_col = 0; start_col + shape.k <= num_cols; ++start_col) {
             Hyperedge edge;
-            for (int32_t i = 0; i < 7; ++i) {
+            for (int32_t i = 0; i < shape.k; ++i) {
                 edge.push_back({row, start_col + i});
             }
             edges.push_back(edge);
@@ -43,13 +56,14 @@ void EdgeGenerator::add_horizontal_edges(std::vector<Hyperedge>& edges, int32_t
     }
 }
 
-void EdgeGenerator::add_truncated_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols) {
-    // According to the (4,n,7^tr) definition, we include truncated edges at boundaries
-    // These are lines of length 4-6 at the left and right boundaries
+void EdgeGenerator::add_truncated_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols,
+                                                   const Shape& shape) {
+    // According to the (r,n,k^tr) definition, we include truncated edges at boundaries
+    // These are lines of length d..k-1 at the left and right boundaries (4-6 for 4 x 7)
     
-    for (int32_t row = 0; row < 4; ++row) {
-        // Left boundary: length 4-6 starting from column 0
-        for (int32_t len = 4; len <= 6 && len <= num_cols; ++len) {
+    for (int32_t row = 0; row < shape.rows; ++row) {
+        // Left boundary: length d..k-1 starting from column 0
+        for (int32_t len = shape.short_length; len < shape.k && len <= num_cols; ++len) {
             Hyperedge edge;
             for (int32_t i = 0; i < len; ++i) {
                 edge.push_back({row, i});
@@ -57,50 +71,55 @@ void EdgeGenerator::add_truncated_horizontal_edges(std::vector<Hyperedge>& edges
             edges.push_back(edge);
         }
         
-        // Right boundary: length 4-6 ending at last column
-        for (int32_t len = 4; len <= 6 && len <= num_cols; ++len) {
+        // Right boundary: length d..k-1 ending at last column
+        for (int32_t len = shape.short_length; len < shape.k && len <= num_cols; ++len) {
             Hyperedge edge;
             for (int32_t i = 0; i < len; ++i) {
                 edge.push_back({row, num_cols - len + i});
             }
-            // Only add if it doesn't overlap with full length-7 edges or left boundary
-            if (num_cols - len >= 7 || num_cols < 7) {
+            // Only add if it doesn't overlap with full length-k edges or left boundary
+            if (num_cols - len >= shape.k || num_cols < shape.k) {
                 edges.push_back(edge);
             }
         }
     }
 }
 
-void EdgeGenerator::add_vertical_edges(std::vector<Hyperedge>& edges, int32_t num_cols) {
-    // Every column forms a vertical edge of length 4
+void EdgeGenerator::add_vertical_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape) {
+    // Every column holds vertical edges of length d; one full column when r <= k
     for (int32_t col = 0; col < num_cols; ++col) {
-        Hyperedge edge;
-        for (int32_t row = 0; row < 4; ++row) {
-            edge.push_back({row, col});
+        for (int32_t start_row = 0; start_row + shape.short_length <= shape.rows; ++start_row) {
+            Hyperedge edge;
+            for (int32_t i = 0; i < shape.short_length; ++i) {
+                edge.push_back({start_row + i, col});
+            }
+            edges.push_back(edge);
         }
-        edges.push_back(edge);
     }
 }
 
-void EdgeGenerator::add_diagonal_edges(std::vector<Hyperedge>& edges, int32_t num_cols) {
-    // Diagonals of length 4 (the board is 4 rows tall)
+void EdgeGenerator::add_diagonal_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape) {
+    // Diagonals of length d (4 on the 4-row board, corner to corner)
+    const int32_t d = shape.short_length;
     
-    // Down-right diagonals: starting from (0, col)
-    for (int32_t start_col = 0; start_col + 4 <= num_cols; ++start_col) {
-        Hyperedge edge;
-        for (int32_t i = 0; i < 4; ++i) {
-            edge.push_back({i, start_col + i});
+    for (int32_t start_row = 0; start_row + d <= shape.rows; ++start_row) {
+        // Down-right diagonals: starting from (start_row, col)
+        for (int32_t start_col = 0; start_col + d <= num_cols; ++start_col) {
+            Hyperedge edge;
+            for (int32_t i = 0; i < d; ++i) {
+                edge.push_back({start_row + i, start_col + i});
+            }
+            edges.push_back(edge);
         }
-        edges.push_back(edge);
-    }
-    
-    // Up-right diagonals: starting from (3, col)
-    for (int32_t start_col = 0; start_col + 4 <= num_cols; ++start_col) {
-        Hyperedge edge;
-        for (int32_t i = 0; i < 4; ++i) {
-            edge.push_back({3 - i, start_col + i});
+        
+        // Up-right diagonals: starting from (start_row + d - 1, col)
+        for (int32_t start_col = 0; start_col + d <= num_cols; ++start_col) {
+            Hyperedge edge;
+            for (int32_t i = 0; i < d; ++i) {
+                edge.push_back({start_row + d - 1 - i, start_col + i});
+            }
+            edges.push_back(edge);
         }
-        edges.push_back(edge);
     }
 }
 
@@ -108,4 +127,82 @@ void EdgeGenerator::canonicalize(Hyperedge& edge) {
     std::sort(edge.begin(), edge.end());
 }
 
+EdgeSweep::EdgeSweep(int32_t num_cols, int32_t num_rows, int32_t line_length)
+    : num_cols_(num_cols)
+    , num_rows_(num_rows)
+    , line_length_(line_length)
+    , tail_(0) {
+    regenerate();
+}
+
+void EdgeSweep::regenerate() {
+    edges_ = EdgeGenerator::generate_edges(num_cols_, num_rows_, line_length_);
+    
+    // Horizontal edges shorter than k that end at the last column but do not
+    // start at column 0 move to the tail. Single cells stay: they are also
+    // the vertical edges of a one-row board.
+    auto right_truncated = [this](const Hyperedge& edge) {
+        bool horizontal = edge.size() > 1 && edge.front().row == edge.back().row;
+        return horizontal && static_cast<int32_t>(edge.size()) < line_length_ && edge.front().col > 0 &&
+               edge.back().col == num_cols_ - 1;
+    };
+    auto tail = std::stable_partition(edges_.begin(), edges_.end(),
+                                      [&](const Hyperedge& edge) { return !right_truncated(edge); });
+    tail_ = static_cast<size_t>(tail - edges_.begin());
+}
+
+void EdgeSweep::advance() {
+    GAME_SCOPE("EdgeSweep::advance");
+    ++num_cols_;
+    if (num_cols_ <= line_length_) {
+        regenerate();
+        return;
+    }
+    
+    // Edges whose last cell is in the new column. With d = 1 vertical and
+    // diagonal edges coincide, so each is added once.
+    const int32_t col = num_cols_ - 1;
+    const int32_t k = line_length_;
+    const int32_t d = std::min(num_rows_, k);
+    edges_.resize(tail_);
+    auto add = [this](Hyperedge edge) {
+        std::sort(edge.begin(), edge.end());
+        if (std::find(edges_.begin() + static_cast<std::ptrdiff_t>(tail_), edges_.end(), edge) == edges_.end()) {
+            edges_.push_back(std::move(edge));
+        }
+    };
+    for (int32_t row = 0; row < num_rows_; ++row) {
+        Hyperedge edge;
+        for (int32_t i = 0; i < k; ++i) {
+            edge.push_back({row, col - k + 1 + i});
+        }
+        add(std::move(edge));
+    }
+    for (int32_t start_row = 0; start_row + d <= num_rows_; ++start_row) {
+        Hyperedge vertical;
+        Hyperedge down;
+        Hyperedge up;
+        for (int32_t i = 0; i < d; ++i) {
+            vertical.push_back({start_row + i, col});
+            down.push_back({start_row + i, col - d + 1 + i});
+            up.push_back({start_row + d - 1 - i, col - d + 1 + i});
+        }
+        add(std::move(vertical));
+        add(std::move(down));
+        add(std::move(up));
+    }
+    
+    // Right-boundary truncated edges of the new width
+    tail_ = edges_.size();
+    for (int32_t row = 0; row < num_rows_; ++row) {
+        for (int32_t len = std::max(d, 2); len < k && num_cols_ - len >= k; ++len) {
+            Hyperedge edge;
+            for (int32_t i = 0; i < len; ++i) {
+                edge.push_back({row, num_cols_ - len + i});
+            }
+            edges_.push_back(edge);
+        }
+    }
+}
+
 } // namespace game
@@ -9,26 +9,68 @@ namespace game {
 // Hyperedge is a set of cells that form a winning line
 using Hyperedge = std::vector<Cell>;
 
+// Line length k of the (4, n, 7^tr) game
+constexpr int32_t kDefaultLineLength = 7;
+
+// Longest line length k supported, bounded by the l-line histogram
+constexpr int32_t kMaxLineLength = 16;
+
 class EdgeGenerator {
 public:
-    // Generate all hyperedges for a (4, n, 7^tr) game
-    static std::vector<Hyperedge> generate_edges(int32_t num_cols);
+    // Generate all hyperedges for an (r, n, k^tr) game, (4, n, 7^tr) by
+    // default. With d = min(r, k) these are the horizontal lines of k cells,
+    // the horizontal lines of d..k-1 cells truncated at the board
+    // boundaries, and the vertical and diagonal lines of d cells.
+    static std::vector<Hyperedge> generate_edges(int32_t num_cols, int32_t num_rows = kDefaultRows,
+                                                 int32_t line_length = kDefaultLineLength);
     
 private:
-    // Generate standard horizontal edges (length 7)
-    static void add_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols);
+    struct Shape {
+        int32_t rows;
+        int32_t k;
+        int32_t short_length;  // d = min(rows, k)
+    };
+    
+    // Generate standard horizontal edges (length k)
+    static void add_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape);
     
     // Generate truncated horizontal edges at board boundaries
-    static void add_truncated_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols);
+    static void add_truncated_horizontal_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape);
     
-    // Generate vertical edges (full column, length 4)
-    static void add_vertical_edges(std::vector<Hyperedge>& edges, int32_t num_cols);
+    // Generate vertical edges (length d, the full column when r <= k)
+    static void add_vertical_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape);
     
-    // Generate diagonal edges (length 4)
-    static void add_diagonal_edges(std::vector<Hyperedge>& edges, int32_t num_cols);
+    // Generate diagonal edges (length d)
+    static void add_diagonal_edges(std::vector<Hyperedge>& edges, int32_t num_cols, const Shape& shape);
     
     // Helper to ensure edges are in canonical form (sorted)
     static void canonicalize(Hyperedge& edge);
 };
 
+// Edge sets of consecutive widths. advance() turns the edges of n into those
+// of n + 1 by appending the edges through the new column and replacing the
+// truncated edges at the right boundary, so each step costs O(edges added)
+// rather than a full generate_edges. The set equals generate_edges() of the
+// same shape but is not sorted. Widths up to k are regenerated, since short
+// boards share and skip truncated edges.
+class EdgeSweep {
+public:
+    explicit EdgeSweep(int32_t num_cols, int32_t num_rows = kDefaultRows,
+                       int32_t line_length = kDefaultLineLength);
+
+    int32_t num_cols() const { return num_cols_; }
+    const std::vector<Hyperedge>& edges() const { return edges_; }
+
+    void advance();
+
+private:
+    int32_t num_cols_;
+    int32_t num_rows_;
+    int32_t line_length_;
+    std::vector<Hyperedge> edges_;
+    size_t tail_;  // First right-boundary truncated edge; they are kept last
+
+    void regenerate();
+};
+
 } // namespace game
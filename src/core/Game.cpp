@@ -1,16 +1,39 @@
 #include "core/Game.h"
+#include "util/Instrument.h"
 #include <stdexcept>
+#include <utility>
 
 namespace game {
 
 Game::Game(int32_t num_cols, const std::vector<Hyperedge>& edges)
-    : board_(num_cols)
-    , edges_(edges)
-    , current_player_(Player::Maker)
-    , move_count_(0) {
+    : Game(Board(num_cols), edges, Player::Maker) {
+}
+
+Game::Game(const Board& board, const std::vector<Hyperedge>& edges, Player to_move)
+    : Game(board, std::make_shared<const EdgeIndex>(board.cols(), edges, board.rows()), to_move) {
+}
+
+Game::Game(const Board& board, std::shared_ptr<const EdgeIndex> index, Player to_move)
+    : board_(board)
+    , index_(std::move(index))
+    , current_player_(to_move)
+    , move_count_(0)
+    , won_at_(-1) {
+    if (index_->rows() != board_.rows() || index_->cols() != board_.cols()) {
+        throw std::invalid_argument("Edge index is for another board shape");
+    }
+    for (int32_t r = 0; r < board_.rows(); ++r) {
+        for (int32_t c = 0; c < board_.cols(); ++c) {
+            if (!board_.is_empty(r, c)) ++move_count_;
+        }
+    }
+    if (check_maker_win()) {
+        won_at_ = 0;
+    }
 }
 
 MoveResult Game::make_move(const Cell& cell) {
+    GAME_SCOPE("Game::make_move");
     if (!board_.is_valid(cell)) {
         throw std::invalid_argument("Invalid cell coordinates");
     }
@@ -21,16 +44,26 @@ MoveResult Game::make_move(const Cell& cell) {
     // Place the mark
     CellState state = (current_player_ == Player::Maker) ? CellState::Maker : CellState::Breaker;
     board_.set(cell, state);
+    history_.push_back(cell);
     
     // Increment move count
     ++move_count_;
     
-    // Check for Maker win
+    // Check for Maker win: a first win must use an edge through this cell
     MoveResult result;
-    result.maker_wins = check_maker_win();
-    if (result.maker_wins) {
+    if (won_at_ < 0 && state == CellState::Maker) {
+        for (int32_t e : index_->edges_of(index_->cell_id(cell))) {
+            GAME_COUNT("game.win_check_edges", 1);
+            if (is_edge_complete(e)) {
+                won_at_ = static_cast<int64_t>(history_.size());
+                result.winning_edge = edge_cells(e);
+                break;
+            }
+        }
+    } else if (won_at_ >= 0) {
         result.winning_edge = find_winning_edge();
     }
+    result.maker_wins = won_at_ >= 0;
     
     // Switch player
     current_player_ = (current_player_ == Player::Maker) ? Player::Breaker : Player::Maker;
@@ -38,9 +71,22 @@ MoveResult Game::make_move(const Cell& cell) {
     return result;
 }
 
+void Game::undo_move() {
+    if (history_.empty()) {
+        throw std::logic_error("No move to undo");
+    }
+    if (won_at_ == static_cast<int64_t>(history_.size())) {
+        won_at_ = -1;
+    }
+    board_.set(history_.back(), CellState::Empty);
+    history_.pop_back();
+    --move_count_;
+    current_player_ = (current_player_ == Player::Maker) ? Player::Breaker : Player::Maker;
+}
+
 bool Game::check_maker_win() const {
-    for (const auto& edge : edges_) {
-        if (is_edge_complete(edge)) {
+    for (int32_t e = 0; e < index_->num_edges(); ++e) {
+        if (is_edge_complete(e)) {
             return true;
         }
     }
@@ -48,21 +94,29 @@ bool Game::check_maker_win() const {
 }
 
 std::optional<Hyperedge> Game::find_winning_edge() const {
-    for (const auto& edge : edges_) {
-        if (is_edge_complete(edge)) {
-            return edge;
+    for (int32_t e = 0; e < index_->num_edges(); ++e) {
+        if (is_edge_complete(e)) {
+            return edge_cells(e);
         }
     }
     return std::nullopt;
 }
 
-bool Game::is_edge_complete(const Hyperedge& edge) const {
-    for (const auto& cell : edge) {
-        if (board_.get(cell) != CellState::Maker) {
+bool Game::is_edge_complete(int32_t edge) const {
+    for (int32_t id : index_->cells_of(edge)) {
+        if (board_.get(index_->cell_at(id)) != CellState::Maker) {
             return false;
         }
     }
     return true;
 }
 
+Hyperedge Game::edge_cells(int32_t edge) const {
+    Hyperedge cells;
+    for (int32_t id : index_->cells_of(edge)) {
+        cells.push_back(index_->cell_at(id));
+    }
+    return cells;
+}
+
 } // namespace game
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "core/Board.h"
+#include "core/EdgeIndex.h"
 #include "core/Edges.h"
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -16,31 +18,44 @@ class Game {
 public:
     Game(int32_t num_cols, const std::vector<Hyperedge>& edges);
     
+    // Continue from an arbitrary position; move_count() is the number of marks
+    Game(const Board& board, const std::vector<Hyperedge>& edges, Player to_move);
+
+    // Shares an index built once, e.g. from a mapped edge list
+    Game(const Board& board, std::shared_ptr<const EdgeIndex> index, Player to_move);
+    
     const Board& board() const { return board_; }
     Board& board() { return board_; }
     
     Player current_player() const { return current_player_; }
     int32_t move_count() const { return move_count_; }
     
-    // Make a move and return result
+    // Make a move and return result. Only the edges through the moved cell
+    // are checked, so a move costs O(degree), not O(edges).
     MoveResult make_move(const Cell& cell);
     
+    // Take back the last move made with make_move
+    void undo_move();
+    
     // Check if Maker has won
     bool check_maker_win() const;
     
     // Find the winning edge if Maker has won
     std::optional<Hyperedge> find_winning_edge() const;
     
-    const std::vector<Hyperedge>& edges() const { return edges_; }
+    const std::shared_ptr<const EdgeIndex>& index() const { return index_; }
     
 private:
     Board board_;
-    std::vector<Hyperedge> edges_;
+    std::shared_ptr<const EdgeIndex> index_;
     Player current_player_;
     int32_t move_count_;
+    std::vector<Cell> history_;
+    int64_t won_at_;  // History length when Maker first completed an edge, -1 if not yet
     
     // Check if an edge is fully occupied by Maker
-    bool is_edge_complete(const Hyperedge& edge) const;
+    bool is_edge_complete(int32_t edge) const;
+    Hyperedge edge_cells(int32_t edge) const;
 };
 
 } // namespace game
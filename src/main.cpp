@@ -1,39 +1,156 @@
 #include "core/Board.h"
 #include "core/Edges.h"
 #include "core/Game.h"
+#include "metrics/ExpectedPotential.h"
+#include "metrics/IncrementalPotential.h"
 #include "metrics/Potential.h"
+#include "metrics/Trajectory.h"
+#include "search/Certifier.h"
+#include "search/Decomposition.h"
+#include "search/Mcts.h"
+#include "search/Pairing.h"
+#include "search/Perft.h"
+#include "search/ProofNumber.h"
+#include "search/Tablebase.h"
+#include "service/BulkEvaluator.h"
+#include "service/Coordinator.h"
+#include "service/EvalServer.h"
+#include "service/PlayoutPipeline.h"
+#include "service/WidthSweep.h"
 #include "util/Cli.h"
+#include "util/EdgeFile.h"
 #include "util/Format.h"
+#include "util/Instrument.h"
+#include "util/MappedFile.h"
+#include "util/Position.h"
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <random>
+#include <unistd.h>
 
-void print_edges_command(int32_t num_cols) {
-    auto edges = game::EdgeGenerator::generate_edges(num_cols);
-    std::cout << game::Formatter::format_all_edges(edges);
+void print_edges_command(const game::CliArgs& args) {
+    // csv is the shared --format default, so it stands for text here
+    if (args.format != "text" && args.format != "csv" && args.format != "bin") {
+        throw std::invalid_argument("print-edges output is text or bin, not " + args.format);
+    }
+    auto edges = game::EdgeGenerator::generate_edges(args.num_cols, args.num_rows, args.line_length);
+    
+    int fd = STDOUT_FILENO;
+    if (!args.output.empty()) {
+        fd = ::open(args.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + args.output + " for writing");
+        }
+    }
+    try {
+        if (args.format == "bin") {
+            game::EdgeWriter::write_binary(fd, edges, args.num_rows, args.num_cols, args.line_length);
+        } else {
+            game::EdgeWriter::write_text(fd, edges);
+        }
+    } catch (...) {
+        if (fd != STDOUT_FILENO) ::close(fd);  // The write error is the one reported
+        throw;
+    }
+    // Delayed write errors (NFS, quota) surface only here
+    if (fd != STDOUT_FILENO && ::close(fd) != 0) {
+        throw std::runtime_error("Cannot write " + args.output + ": " + std::strerror(errno));
+    }
+}
+
+// Start from --position (or the empty board of --cols) and replay --moves.
+// Reports and returns nothing when Maker has already won.
+std::optional<game::Game> start_position(const game::CliArgs& args,
+                                         const std::shared_ptr<const game::EdgeIndex>& index) {
+    game::Position start = args.position.empty()
+        ? game::Position{game::Board(args.num_cols, args.num_rows), game::Player::Maker}
+        : game::PositionCodec::parse(args.position, args.num_rows);
+    game::Game g(start.board, index, start.to_move);
+    bool won = g.check_maker_win();
+    for (size_t i = 0; i < args.moves.size() && !won; ++i) {
+        won = g.make_move(args.moves[i]).maker_wins;
+    }
+    if (won) {
+        std::cout << "Maker has already won after " << g.move_count() << " moves.\n";
+        return std::nullopt;
+    }
+    return g;
+}
+
+int32_t position_cols(const game::CliArgs& args) {
+    return args.position.empty() ? args.num_cols : game::PositionCodec::parse(args.position, args.num_rows).board.cols();
+}
+
+// Edges of the (--rows, n, --k) game at the width of the start position,
+// read from --edges when given
+std::shared_ptr<const game::EdgeIndex> position_index(const game::CliArgs& args) {
+    if (args.edges_file.empty()) {
+        int32_t cols = position_cols(args);
+        auto edges = game::EdgeGenerator::generate_edges(cols, args.num_rows, args.line_length);
+        return std::make_shared<const game::EdgeIndex>(cols, edges, args.num_rows);
+    }
+    game::EdgeList list(args.edges_file);
+    if (list.cols() != position_cols(args) || list.rows() != args.num_rows || list.line_length() != args.line_length) {
+        throw std::invalid_argument(args.edges_file + " holds the edges of a " + std::to_string(list.rows()) + "x" +
+                                    std::to_string(list.cols()) + " board with k = " +
+                                    std::to_string(list.line_length()) + ", not of this game");
+    }
+    return list.index();
+}
+
+// --tablebase, or null without it; a table of another width is an error
+std::unique_ptr<game::Tablebase> open_tablebase(const game::CliArgs& args) {
+    if (args.tablebase.empty()) return nullptr;
+    auto tablebase = std::make_unique<game::Tablebase>(args.tablebase);
+    if (tablebase->cols() != args.num_cols) {
+        throw std::invalid_argument("Tablebase covers n=" + std::to_string(tablebase->cols()) + ", not n=" +
+                                    std::to_string(args.num_cols));
+    }
+    return tablebase;
 }
 
-void compute_potential_command(int32_t num_cols) {
-    game::Board board(num_cols);
-    auto edges = game::EdgeGenerator::generate_edges(num_cols);
-    game::PotentialCalculator calc(board, edges);
+void compute_potential_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto g = start_position(args, index);
+    if (!g) return;
+    game::IncrementalPotential state(g->board(), index, args.line_length);
     
-    auto hist = calc.compute_histogram();
-    double pot = calc.compute_potential();
+    const auto& hist = state.histogram();
+    double pot = state.potential();
     
     std::cout << game::Formatter::format_histogram(hist);
     std::cout << "Potential: " << game::Formatter::format_potential(pot) << "\n";
+    
+    if (auto tablebase = open_tablebase(args)) {
+        // The table stores the side to move implied by the counts
+        std::optional<bool> value;
+        if (g->current_player() == game::PositionCodec::infer_to_move(g->board())) {
+            value = tablebase->maker_wins(g->board());
+        }
+        std::cout << "Tablebase: " << (!value ? "not covered" : *value ? "Maker wins" : "Breaker wins") << "\n";
+    }
 }
 
-void simulate_random_game(int32_t num_cols, int32_t seed, int32_t max_moves) {
-    std::mt19937 rng(static_cast<uint32_t>(seed));
+void simulate_random_game(const game::CliArgs& args) {
+    std::mt19937 rng(static_cast<uint32_t>(args.seed));
     
-    auto edges = game::EdgeGenerator::generate_edges(num_cols);
-    game::Game g(num_cols, edges);
+    auto edges = game::EdgeGenerator::generate_edges(args.num_cols, args.num_rows, args.line_length);
+    game::Game g(game::Board(args.num_cols, args.num_rows), edges, game::Player::Maker);
     
-    std::cout << "Starting random simulation with n=" << num_cols 
-              << ", seed=" << seed << "\n\n";
+    std::cout << "Starting random simulation with n=" << args.num_cols 
+              << ", seed=" << args.seed << "\n\n";
     
-    for (int32_t move = 1; move <= max_moves; ++move) {
+    for (int32_t move = 1; move <= args.max_moves; ++move) {
         auto empty = g.board().get_empty_cells();
         if (empty.empty()) {
             std::cout << "Board full, game ends in draw.\n";
@@ -79,25 +196,599 @@ void simulate_random_game(int32_t num_cols, int32_t seed, int32_t max_moves) {
     std::cout << g.board().to_string();
 }
 
+// Set by SIGINT or SIGTERM while a checkpointed command runs
+std::atomic<bool> stop_requested{false};
+
+extern "C" void request_stop(int) {
+    stop_requested.store(true);
+}
+
+// With --checkpoint, the first SIGINT or SIGTERM stops the run after a final
+// checkpoint; a second one terminates as usual
+game::CheckpointOptions checkpoint_options(const game::CliArgs& args) {
+    game::CheckpointOptions options;
+    options.path = args.checkpoint;
+    options.interval_seconds = args.checkpoint_every;
+    options.resume = args.resume;
+    if (!options.path.empty()) {
+        options.stop = &stop_requested;
+        struct sigaction action{};
+        action.sa_handler = request_stop;
+        action.sa_flags = SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+    }
+    return options;
+}
+
+void print_stage(const char* name, const game::StageStats& stage) {
+    std::cerr << "  " << std::left << std::setw(10) << name << std::right << stage.threads << " threads, "
+              << stage.blocks << " blocks, " << stage.items << " items, "
+              << static_cast<int64_t>(stage.items_per_second()) << " items/s, busy " << stage.busy_seconds
+              << " s, waiting on input " << stage.input_wait_seconds << " s, on output "
+              << stage.output_wait_seconds << " s\n";
+}
+
+void print_queue(const char* name, const game::QueueStats& queue) {
+    std::cerr << "  " << std::left << std::setw(10) << name << std::right << queue.capacity << " slots, mean "
+              << queue.mean_occupancy << " / max " << queue.max_occupancy << " occupied, " << queue.full_waits
+              << " full, " << queue.empty_waits << " empty\n";
+}
+
+// simulate --games: many random games through the generate/evaluate/write
+// pipeline, one CSV row per move
+void simulate_games_command(const game::CliArgs& args) {
+    game::PipelineOptions options;
+    options.num_cols = args.num_cols;
+    options.num_rows = args.num_rows;
+    options.line_length = args.line_length;
+    options.games = args.games;
+    options.max_moves = args.max_moves;
+    options.seed = static_cast<uint32_t>(args.seed);
+    options.generate_threads = args.stage_threads[0];
+    options.evaluate_threads = args.stage_threads[1];
+    options.write_threads = args.stage_threads[2];
+    options.games_per_block = args.batch;
+    if (!args.trajectories && !args.checkpoint.empty() && args.output.empty()) {
+        throw std::invalid_argument("simulate --checkpoint writes rows to a file only (-o PATH)");
+    }
+    options.checkpoint = checkpoint_options(args);
+    game::PlayoutPipeline pipeline(options);
+    if (args.trajectories && args.format != "csv" && args.format != "json") {
+        throw std::invalid_argument("Trajectory output is csv or json, not " + args.format);
+    }
+    
+    // A resumed run continues the rows already in the file
+    std::ofstream file;
+    if (!args.output.empty()) {
+        bool append = !args.trajectories && args.resume && ::access(args.checkpoint.c_str(), F_OK) == 0;
+        file.open(args.output, append ? std::ios::binary | std::ios::in | std::ios::out : std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + args.output + " for writing");
+        }
+    }
+    std::ostream& out = args.output.empty() ? std::cout : file;
+    game::PipelineStats stats;
+    if (args.trajectories) {
+        game::TrajectoryStats trajectories(pipeline.max_plies(), args.line_length);
+        stats = pipeline.run(trajectories);
+        if (args.format == "json") {
+            trajectories.write_json(out);
+        } else {
+            trajectories.write_csv(out);
+        }
+    } else {
+        stats = pipeline.run(out);
+    }
+    
+    std::cerr << "Played " << stats.games << " games, " << stats.positions << " positions, " << stats.maker_wins
+              << " Maker wins in " << stats.seconds << " s";
+    if (stats.seconds > 0.0) {
+        std::cerr << " (" << static_cast<int64_t>(static_cast<double>(stats.positions) / stats.seconds)
+                  << " positions/s)";
+    }
+    std::cerr << "\n";
+    print_stage("generate", stats.generate);
+    print_stage("evaluate", stats.evaluate);
+    print_stage(args.trajectories ? "summarize" : "write", stats.write);
+    print_queue("moves", stats.moves_queue);
+    print_queue("results", stats.results_queue);
+}
+
+void certify_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    game::Game& g = *position;
+    
+    game::IncrementalPotential state(g.board(), index, args.line_length);
+    std::cout << "Position after " << g.move_count() << " moves, "
+              << (g.current_player() == game::Player::Maker ? "Maker" : "Breaker") << " to move\n";
+    std::cout << "Potential: " << game::Formatter::format_potential(state.potential()) << "\n";
+    
+    game::CertifyOptions options;
+    options.depth = args.depth;
+    options.replies = args.exhaustive ? game::BreakerReplies::Exhaustive : game::BreakerReplies::Greedy;
+    auto tablebase = open_tablebase(args);
+    options.tablebase = tablebase.get();
+    game::Certifier certifier(g.board(), index, options);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto result = certifier.certify(g.current_player());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "Certificate (depth " << args.depth << ", "
+              << (args.exhaustive ? "exhaustive" : "greedy") << " Breaker): "
+              << (result.certified ? "found" : "not found") << "\n";
+    std::cout << "Nodes: " << result.nodes << " in " << seconds * 1000.0 << " ms";
+    if (seconds > 0.0) {
+        std::cout << " (" << static_cast<int64_t>(static_cast<double>(result.nodes) / seconds) << " nodes/s)";
+    }
+    std::cout << "\n";
+}
+
+void decompose_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    game::Game& g = *position;
+    
+    auto parts = game::Decomposer::decompose(g.board(), *index);
+    std::cout << "Components: " << parts.size() << "\n";
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const auto& part = parts[i];
+        game::PotentialCalculator calc(part.board, part.edges);
+        game::Certifier certifier(part.board, part.edges, {args.depth, game::BreakerReplies::Greedy});
+        bool certified = certifier.certify(game::Player::Maker).certified;
+        
+        std::cout << "\n" << i + 1 << ". columns " << part.first_col << ".." << part.last_col
+                  << " | edges=" << part.edges.size()
+                  << " | empty=" << part.empty_cells
+                  << " | pot=" << game::Formatter::format_potential(calc.compute_potential())
+                  << " | breaker_cert(depth " << args.depth << ")=" << (certified ? "true" : "false") << "\n";
+        std::cout << part.board.to_string();
+    }
+}
+
+void mcts_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    game::Game& g = *position;
+    
+    game::MctsOptions options;
+    options.iterations = args.iterations;
+    options.time_ms = args.time_ms;
+    options.threads = args.threads;
+    options.mode = (args.mode == "root") ? game::MctsMode::RootParallel : game::MctsMode::TreeParallel;
+    options.seed = static_cast<uint64_t>(args.seed);
+    
+    game::MctsEngine engine(g, options);
+    auto result = engine.search();
+    
+    std::cout << "MCTS (" << args.mode << "-parallel, " << args.threads << " threads) from "
+              << (g.current_player() == game::Player::Maker ? "Maker" : "Breaker") << " to move\n";
+    std::cout << "Playouts: " << result.playouts << " in " << result.seconds * 1000.0 << " ms";
+    if (result.seconds > 0.0) {
+        std::cout << " (" << static_cast<int64_t>(static_cast<double>(result.playouts) / result.seconds)
+                  << " playouts/s)";
+    }
+    std::cout << "\n";
+    std::cout << "Tree nodes: " << result.nodes << "\n";
+    std::cout << "Maker win rate: " << game::Formatter::format_potential(result.maker_win_rate) << "\n";
+    std::cout << "Principal variation:";
+    for (const auto& cell : result.principal_variation) {
+        std::cout << " " << game::Formatter::format_cell(cell);
+    }
+    std::cout << "\n";
+}
+
+void proof_number_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    game::Game& g = *position;
+    
+    game::PnOptions options;
+    options.max_expansions = args.max_expansions;
+    options.memory_limit_bytes = static_cast<size_t>(args.mem_mb) << 20;
+    options.checkpoint = checkpoint_options(args);
+    auto tablebase = open_tablebase(args);
+    options.tablebase = tablebase.get();
+    game::ProofNumberSearch search(g.board(), index, g.current_player(), options);
+    auto result = search.solve();
+    
+    const char* value = "unknown";
+    if (result.value == game::PnValue::Proved) value = "Maker wins";
+    if (result.value == game::PnValue::Disproved) value = "Breaker wins";
+    
+    std::cout << "Proof-number search from "
+              << (g.current_player() == game::Player::Maker ? "Maker" : "Breaker") << " to move\n";
+    std::cout << "Result: " << value << "\n";
+    std::cout << "Expansions: " << result.expansions << " in " << result.seconds * 1000.0 << " ms";
+    if (result.seconds > 0.0) {
+        std::cout << " (" << static_cast<int64_t>(static_cast<double>(result.expansions) / result.seconds)
+                  << " expansions/s)";
+    }
+    std::cout << "\n";
+    std::cout << "Peak nodes: " << result.peak_nodes << " x " << result.bytes_per_node << " bytes/node = "
+              << (result.peak_nodes * static_cast<int64_t>(result.bytes_per_node)) / 1024 << " KiB\n";
+    std::cout << "GC runs: " << result.gc_runs << ", nodes collected: " << result.nodes_collected << "\n";
+    std::cout << "Peak RSS: " << result.peak_rss_bytes / (1024 * 1024) << " MiB\n";
+}
+
+void report_serve_stats(const game::ServeStats& stats) {
+    std::cerr << "Served " << stats.requests << " requests in " << stats.batches << " batches, "
+              << stats.seconds * 1000.0 << " ms | latency us p50=" << stats.p50_us
+              << " p90=" << stats.p90_us << " p99=" << stats.p99_us << " max=" << stats.max_us << "\n";
+}
+
+void serve_command(const game::CliArgs& args) {
+    game::ServeOptions options;
+    options.threads = args.threads;
+    options.max_batch = args.batch;
+    game::EvalServer server(options);
+    
+    // Responses go to stdout, the latency report to stderr
+    if (args.socket_path.empty()) {
+        report_serve_stats(server.serve(STDIN_FILENO, STDOUT_FILENO));
+    } else {
+        std::cerr << "Listening on " << args.socket_path << "\n";
+        server.serve_socket(args.socket_path, report_serve_stats);
+    }
+}
+
+void eval_file_command(const game::CliArgs& args) {
+    if (args.input.empty()) {
+        throw std::invalid_argument("eval-file needs --input <PATH>");
+    }
+    if (args.format != "csv" && args.format != "bin") {
+        throw std::invalid_argument("eval-file output is csv or bin, not " + args.format);
+    }
+    game::MappedFile input(args.input);
+    
+    game::BulkOptions options;
+    options.threads = args.threads;
+    options.depth = args.depth;
+    options.format = (args.format == "bin") ? game::BulkFormat::Columnar : game::BulkFormat::Csv;
+    game::BulkEvaluator evaluator(options);
+    
+    std::ofstream file;
+    if (!args.output.empty()) {
+        file.open(args.output, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + args.output + " for writing");
+        }
+    }
+    std::ostream& out = args.output.empty() ? std::cout : file;
+    auto stats = evaluator.run(input.data(), out);
+    
+    // Results may be on stdout, so the summary goes to stderr
+    std::cerr << "Evaluated " << stats.positions << " positions in " << stats.seconds * 1000.0 << " ms";
+    if (stats.seconds > 0.0) {
+        std::cerr << " (" << static_cast<int64_t>(static_cast<double>(stats.positions) / stats.seconds)
+                  << " positions/s)";
+    }
+    std::cerr << "\n";
+}
+
+void perft_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    
+    game::PerftOptions options;
+    options.depth = args.depth;
+    options.stop_at_certificate = args.stop_at_certificate;
+    options.count_distinct = args.count_distinct;
+    options.threads = args.threads;
+    game::Perft perft(*position, options);
+    auto result = perft.run();
+    
+    std::cout << "Perft to depth " << args.depth << " from " << position->move_count() << " moves on n="
+              << position->board().cols() << ", " << args.threads << " threads"
+              << (args.stop_at_certificate ? ", stopping at certificates" : "") << "\n";
+    std::cout << std::setw(4) << "ply" << std::setw(16) << "sequences" << std::setw(14) << "distinct"
+              << std::setw(14) << "maker_wins" << std::setw(14) << "certificates" << "\n";
+    for (size_t ply = 1; ply < result.plies.size(); ++ply) {
+        const auto& counts = result.plies[ply];
+        std::cout << std::setw(4) << ply << std::setw(16) << counts.sequences;
+        if (args.count_distinct) {
+            std::cout << std::setw(14) << counts.distinct;
+        } else {
+            std::cout << std::setw(14) << "-";
+        }
+        std::cout << std::setw(14) << counts.maker_wins << std::setw(14) << counts.certificates << "\n";
+    }
+    std::cout << "Nodes: " << result.nodes << " in " << result.seconds * 1000.0 << " ms";
+    if (result.seconds > 0.0) {
+        std::cout << " (" << static_cast<int64_t>(static_cast<double>(result.nodes) / result.seconds)
+                  << " nodes/s)";
+    }
+    std::cout << "\n";
+}
+
+void tablebase_command(const game::CliArgs& args) {
+    if (args.output.empty()) {
+        throw std::invalid_argument("tablebase needs an output file (-o PATH)");
+    }
+    auto edges = game::EdgeGenerator::generate_edges(args.num_cols);
+    game::TablebaseOptions options;
+    options.max_empty = args.max_empty;
+    options.threads = args.threads;
+    options.checkpoint = checkpoint_options(args);
+    auto stats = game::Tablebase::build(args.num_cols, edges, args.output, options);
+    
+    std::cout << "Tablebase for n=" << args.num_cols << " written to " << args.output << "\n";
+    std::cout << "Positions: " << stats.positions << " (" << stats.evaluated << " solved, symmetry group of "
+              << stats.symmetries << ")\n";
+    std::cout << "Maker wins: " << stats.maker_wins << "\n";
+    std::cout << "Size: " << stats.bytes << " bytes, " << stats.seconds * 1000.0 << " ms\n";
+}
+
+void find_pairing_command(const game::CliArgs& args) {
+    if (!args.input.empty()) {
+        game::MappedFile file(args.input);
+        auto pairing = game::Pairing::parse(std::string(file.data()));
+        int32_t width = pairing.periodic ? args.num_cols : pairing.num_cols;
+        auto edges = game::EdgeGenerator::generate_edges(width);
+        auto uncovered = pairing.find_uncovered(width, edges);
+        if (uncovered) {
+            std::cout << "Pairing fails on n=" << width << ": no pair in " << game::Formatter::format_edge(*uncovered)
+                      << "\n";
+        } else {
+            std::cout << "Pairing covers all " << edges.size() << " edges on n=" << width << "\n";
+        }
+        return;
+    }
+    
+    game::PairingOptions options;
+    options.span = args.span;
+    game::PairingFinder finder(options);
+    game::PairingResult result;
+    if (args.periodic) {
+        result = finder.find_periodic(game::PairingFinder::strip_templates());
+        if (result.pairing) {
+            std::cout << "Periodic pairing with period " << result.period;
+        } else {
+            std::cout << "No pairing of the strip with any period";
+        }
+    } else {
+        result = finder.find(args.num_cols, game::EdgeGenerator::generate_edges(args.num_cols));
+        if (result.pairing) {
+            std::cout << "Pairing for n=" << args.num_cols;
+        } else {
+            std::cout << "No pairing for n=" << args.num_cols << ": every choice fails by column " << result.columns;
+        }
+    }
+    std::cout << " (span " << args.span << ", " << result.states << " states, " << result.seconds * 1000.0
+              << " ms)\n";
+    
+    if (result.pairing) {
+        if (args.output.empty()) {
+            std::cout << result.pairing->format();
+        } else {
+            std::ofstream file(args.output);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + args.output + " for writing");
+            }
+            file << result.pairing->format();
+        }
+    }
+}
+
+void sweep_command(const game::CliArgs& args) {
+    game::SweepOptions options;
+    options.from = args.from;
+    options.to = args.to;
+    options.threads = args.threads;
+    options.games = args.games;
+    options.seed = static_cast<uint32_t>(args.seed);
+    options.solve_expansions = args.max_expansions;
+    options.solve_memory_bytes = static_cast<size_t>(args.mem_mb) << 20;
+    options.checkpoint = checkpoint_options(args);
+    game::WidthSweep sweep(options);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto rows = sweep.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::ofstream file;
+    if (!args.output.empty()) {
+        file.open(args.output);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + args.output + " for writing");
+        }
+    }
+    sweep.write_csv(rows, args.output.empty() ? std::cout : file);
+    
+    // The table may be on stdout, so the summary goes to stderr
+    std::cerr << "Swept " << rows.size() << " widths in " << seconds * 1000.0 << " ms\n";
+}
+
+void solve_dist_command(const game::CliArgs& args) {
+    auto index = position_index(args);
+    auto position = start_position(args, index);
+    if (!position) return;
+    game::Game& g = *position;
+    
+    game::CoordinatorOptions options;
+    options.workers = args.workers;
+    options.socket_path = args.socket_path;
+    options.split_depth = args.split_depth;
+    options.unit_expansions = args.unit_expansions;
+    options.memory_limit_bytes = static_cast<size_t>(args.mem_mb) << 20;
+    options.checkpoint = checkpoint_options(args);
+    game::Coordinator coordinator(g.board(), g.current_player(), options, args.line_length);
+    if (args.workers == 0) {
+        std::cerr << "Waiting for workers on " << coordinator.socket_path() << "\n";
+    }
+    auto stats = coordinator.run();
+    
+    const char* value = "unknown";
+    if (stats.value == game::PnValue::Proved) value = "Maker wins";
+    if (stats.value == game::PnValue::Disproved) value = "Breaker wins";
+    
+    std::cout << "Distributed proof-number search from "
+              << (g.current_player() == game::Player::Maker ? "Maker" : "Breaker") << " to move\n";
+    std::cout << "Result: " << value << "\n";
+    std::cout << "Units: " << stats.units << " sent, " << stats.solved << " solved, " << stats.budget_splits
+              << " split on budget, " << stats.straggler_splits << " stragglers split, " << stats.requeued
+              << " requeued\n";
+    std::cout << "Expansions: " << stats.expansions << " in " << stats.seconds * 1000.0 << " ms ("
+              << static_cast<int64_t>(stats.nodes_per_second()) << " nodes/s across " << stats.workers.size()
+              << " workers)\n";
+    for (size_t w = 0; w < stats.workers.size(); ++w) {
+        const auto& worker = stats.workers[w];
+        std::cout << "  worker " << w << ": " << worker.units << " units, " << worker.expansions << " expansions, "
+                  << worker.busy_seconds * 1000.0 << " ms busy\n";
+    }
+}
+
+void expected_potential_command(const game::CliArgs& args) {
+    auto edges = game::EdgeGenerator::generate_edges(args.num_cols, args.num_rows, args.line_length);
+    int32_t num_cells = args.num_cols * args.num_rows;
+    game::ExpectedPotential expected(edges, num_cells, args.line_length);
+    std::vector<game::SampledPly> sampled;
+    if (args.games > 0) {
+        sampled = game::ExpectedPotential::sample(args.num_cols, args.num_rows, edges, args.line_length, args.games,
+                                                  static_cast<uint32_t>(args.seed));
+    }
+    
+    std::ofstream file;
+    if (!args.output.empty()) {
+        file.open(args.output);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + args.output + " for writing");
+        }
+    }
+    std::ostream& out = args.output.empty() ? std::cout : file;
+    out << "ply,maker,breaker";
+    for (int32_t l = 1; l <= expected.line_length(); ++l) {
+        out << ",x_" << l;
+    }
+    out << ",pot";
+    if (!sampled.empty()) out << ",mc_pot,mc_stderr";
+    out << "\n" << std::setprecision(15);
+    
+    double worst = 0.0;
+    int32_t worst_ply = 0;
+    for (int32_t ply = 0; ply <= num_cells; ++ply) {
+        auto row = expected.at(ply);
+        out << ply << "," << (ply + 1) / 2 << "," << ply / 2;
+        for (int32_t l = 1; l <= expected.line_length(); ++l) {
+            out << "," << row.lines[static_cast<size_t>(l - 1)];
+        }
+        out << "," << row.potential;
+        if (!sampled.empty()) {
+            const auto& mc = sampled[static_cast<size_t>(ply)];
+            out << "," << mc.potential << "," << mc.potential_stderr;
+            double error = std::abs(static_cast<double>(row.potential) - mc.potential);
+            double z = mc.potential_stderr > 0.0 ? error / mc.potential_stderr : (error > 1e-9 ? 1e9 : 0.0);
+            if (z > worst) {
+                worst = z;
+                worst_ply = ply;
+            }
+        }
+        out << "\n";
+    }
+    
+    // The table may be on stdout, so the comparison goes to stderr
+    if (!sampled.empty()) {
+        std::cerr << "Largest gap to " << args.games << " Monte-Carlo games: " << worst
+                  << " standard errors (ply " << worst_ply << ")\n";
+    }
+}
+
+void worker_command(const game::CliArgs& args) {
+    auto solved = game::DistWorker::run(args.socket_path);
+    std::cerr << "Solved " << solved << " units\n";
+}
+
 int main(int argc, char* argv[]) {
     try {
         game::CliArgs args = game::CliParser::parse(argc, argv);
+        bool instrumented = args.profile || args.hw_counters || !args.trace.empty();
+        if (instrumented && !game::Instrument::kEnabled) {
+            std::cerr << "Warning: --profile, --trace and --hw-counters need a build with -DGAME_INSTRUMENT=ON\n";
+            instrumented = false;
+        }
+        if (instrumented) {
+            game::InstrumentOptions options;
+            options.trace = !args.trace.empty();
+            options.hardware = args.hw_counters;
+            game::Instrument::start(options);
+        }
         
         switch (args.command) {
             case game::CliCommand::PrintEdges:
-                print_edges_command(args.num_cols);
+                print_edges_command(args);
                 break;
             case game::CliCommand::SimulateRandom:
-                simulate_random_game(args.num_cols, args.seed, args.max_moves);
+                if (args.games > 0) {
+                    simulate_games_command(args);
+                } else {
+                    simulate_random_game(args);
+                }
                 break;
             case game::CliCommand::ComputePotential:
-                compute_potential_command(args.num_cols);
+                compute_potential_command(args);
+                break;
+            case game::CliCommand::Certify:
+                certify_command(args);
+                break;
+            case game::CliCommand::Decompose:
+                decompose_command(args);
+                break;
+            case game::CliCommand::Mcts:
+                mcts_command(args);
+                break;
+            case game::CliCommand::ProofNumber:
+                proof_number_command(args);
+                break;
+            case game::CliCommand::Serve:
+                serve_command(args);
+                break;
+            case game::CliCommand::EvalFile:
+                eval_file_command(args);
+                break;
+            case game::CliCommand::Perft:
+                perft_command(args);
+                break;
+            case game::CliCommand::Tablebase:
+                tablebase_command(args);
+                break;
+            case game::CliCommand::FindPairing:
+                find_pairing_command(args);
+                break;
+            case game::CliCommand::Sweep:
+                sweep_command(args);
+                break;
+            case game::CliCommand::Distribute:
+                solve_dist_command(args);
+                break;
+            case game::CliCommand::Worker:
+                worker_command(args);
+                break;
+            case game::CliCommand::ExpectedPotential:
+                expected_potential_command(args);
                 break;
             case game::CliCommand::Help:
                 game::CliParser::print_help();
                 break;
         }
         
+        if (instrumented) {
+            if (args.profile || args.hw_counters) {
+                game::Instrument::write_summary(std::cerr);
+            }
+            if (!args.trace.empty()) {
+                std::ofstream out(args.trace);
+                if (!out) throw std::runtime_error("Cannot open " + args.trace + " for writing");
+                game::Instrument::write_trace(out);
+            }
+        }
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
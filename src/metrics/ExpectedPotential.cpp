@@ -0,0 +1,130 @@
+#include "metrics/ExpectedPotential.h"
+#include "metrics/IncrementalPotential.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+namespace game {
+
+ExpectedPotential::ExpectedPotential(const std::vector<Hyperedge>& edges, int32_t num_cells, int32_t line_length)
+    : num_cells_(num_cells)
+    , line_length_(line_length) {
+    if (num_cells <= 0) {
+        throw std::invalid_argument("Expected potential needs a non-empty board");
+    }
+    std::map<int32_t, int64_t> counts;
+    for (const auto& edge : edges) {
+        auto size = static_cast<int32_t>(edge.size());
+        if (size > kMaxLineLength) {
+            throw std::invalid_argument("Line length exceeds kMaxLineLength");
+        }
+        line_length_ = std::max(line_length_, size);
+        ++counts[size];
+    }
+    lengths_.assign(counts.begin(), counts.end());
+}
+
+long double ExpectedPotential::line_probability(int32_t size, int32_t empty_cells, int32_t maker, int32_t breaker,
+                                                int32_t num_cells) {
+    int32_t makers = size - empty_cells;
+    int32_t free = num_cells - maker - breaker;
+    if (makers < 0 || makers > maker || empty_cells > free || size > num_cells) {
+        return 0.0L;
+    }
+    // C(s, l) * (m)_{s-l} * (free)_l / (N)_s, one factor of each product at a time
+    long double p = 1.0L;
+    for (int32_t i = 0; i < empty_cells; ++i) {
+        p *= static_cast<long double>(size - i) / static_cast<long double>(i + 1);
+    }
+    int32_t drawn = 0;
+    for (int32_t i = 0; i < makers; ++i, ++drawn) {
+        p *= static_cast<long double>(maker - i) / static_cast<long double>(num_cells - drawn);
+    }
+    for (int32_t i = 0; i < empty_cells; ++i, ++drawn) {
+        p *= static_cast<long double>(free - i) / static_cast<long double>(num_cells - drawn);
+    }
+    return p;
+}
+
+ExpectedPly ExpectedPotential::at(int32_t ply) const {
+    if (ply < 0 || ply > num_cells_) {
+        throw std::out_of_range("Ply outside 0.." + std::to_string(num_cells_));
+    }
+    ExpectedPly result;
+    result.ply = ply;
+    int32_t maker = (ply + 1) / 2;
+    int32_t breaker = ply / 2;
+    for (int32_t l = 1; l <= line_length_; ++l) {
+        long double expected = 0.0L;
+        for (const auto& [size, count] : lengths_) {
+            expected += static_cast<long double>(count) * line_probability(size, l, maker, breaker, num_cells_);
+        }
+        result.lines[static_cast<size_t>(l - 1)] = expected;
+        result.potential += std::ldexp(expected, -(l - 1));
+    }
+    return result;
+}
+
+std::vector<SampledPly> ExpectedPotential::sample(int32_t num_cols, int32_t num_rows,
+                                                  const std::vector<Hyperedge>& edges, int32_t line_length,
+                                                  int32_t games, uint32_t seed) {
+    if (games <= 0) {
+        throw std::invalid_argument("Sampling needs at least one game");
+    }
+    IncrementalPotential tracker(Board(num_cols, num_rows), edges, line_length);
+    auto num_cells = static_cast<size_t>(num_cols) * static_cast<size_t>(num_rows);
+    std::vector<SampledPly> plies(num_cells + 1);
+    std::vector<double> squares(num_cells + 1, 0.0);
+    std::vector<int32_t> empty;
+
+    auto record = [&](size_t ply) {
+        SampledPly& sampled = plies[ply];
+        const LLineHistogram& hist = tracker.histogram();
+        for (size_t l = 0; l < hist.size(); ++l) {
+            sampled.lines[l] += hist[l];
+        }
+        double pot = tracker.potential();
+        sampled.potential += pot;
+        squares[ply] += pot * pot;
+    };
+
+    // The move rule of simulate_random_game, without stopping at a win
+    for (int32_t g = 0; g < games; ++g) {
+        std::seed_seq seq{seed, static_cast<uint32_t>(g)};
+        std::mt19937 rng(seq);
+        empty.resize(num_cells);
+        for (size_t i = 0; i < empty.size(); ++i) {
+            empty[i] = static_cast<int32_t>(i);
+        }
+        bool maker_turn = true;
+        record(0);
+        while (!empty.empty()) {
+            std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+            size_t pick = dist(rng);
+            std::swap(empty[pick], empty.back());
+            tracker.place(empty.back(), maker_turn ? CellState::Maker : CellState::Breaker);
+            empty.pop_back();
+            maker_turn = !maker_turn;
+            record(static_cast<size_t>(tracker.num_placed()));
+        }
+        while (tracker.num_placed() > 0) {
+            tracker.undo();
+        }
+    }
+
+    auto n = static_cast<double>(games);
+    for (size_t ply = 0; ply < plies.size(); ++ply) {
+        SampledPly& sampled = plies[ply];
+        for (double& mean : sampled.lines) {
+            mean /= n;
+        }
+        sampled.potential /= n;
+        double variance = games > 1 ? (squares[ply] - n * sampled.potential * sampled.potential) / (n - 1.0) : 0.0;
+        sampled.potential_stderr = std::sqrt(std::max(variance, 0.0) / n);
+    }
+    return plies;
+}
+
+} // namespace game
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+struct ExpectedPly {
+    int32_t ply = 0;
+    std::array<long double, kMaxLineLength> lines{};   // E[x_l] at index l - 1
+    long double potential = 0.0L;                      // E[pot]
+};
+
+struct SampledPly {
+    std::array<double, kMaxLineLength> lines{};        // Mean x_l at index l - 1
+    double potential = 0.0;                            // Mean pot
+    double potential_stderr = 0.0;                     // Standard error of the mean
+};
+
+// Exact expected l-line histogram and potential after each ply of random
+// play, where every move is a uniformly random empty cell and Maker moves
+// first.
+//
+// After ply t Maker holds m = ceil(t/2) and Breaker b = floor(t/2) cells,
+// and the two sets are uniformly random. A given edge of s cells is an
+// l-line (s - l Maker cells, l empty, no Breaker cell) with probability
+//
+//     C(s, l) * (m)_{s-l} * (N - m - b)_l / (N)_s
+//
+// in falling factorials over the N cells. By linearity E[x_l] is that times
+// the number of edges of each length, summed over the lengths, so a ply
+// costs O(lengths × k²) whatever the width. Play continues past a Maker
+// win, as if every game filled the board.
+class ExpectedPotential {
+public:
+    // The histogram has `line_length` entries, or more if some edge is longer
+    ExpectedPotential(const std::vector<Hyperedge>& edges, int32_t num_cells,
+                      int32_t line_length = kDefaultLineLength);
+
+    int32_t num_cells() const { return num_cells_; }
+    int32_t line_length() const { return line_length_; }
+
+    ExpectedPly at(int32_t ply) const;
+
+    static long double line_probability(int32_t size, int32_t empty_cells, int32_t maker, int32_t breaker,
+                                        int32_t num_cells);
+
+    // Monte-Carlo estimate over `games` random fills of the empty board, one
+    // entry per ply from 0 to full. Game g is seeded from (seed, g).
+    static std::vector<SampledPly> sample(int32_t num_cols, int32_t num_rows, const std::vector<Hyperedge>& edges,
+                                          int32_t line_length, int32_t games, uint32_t seed);
+
+private:
+    int32_t num_cells_;
+    int32_t line_length_;
+    std::vector<std::pair<int32_t, int64_t>> lengths_;  // Edge size and number of edges of that size
+};
+
+} // namespace game
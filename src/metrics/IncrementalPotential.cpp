@@ -0,0 +1,152 @@
+#include "metrics/IncrementalPotential.h"
+#include "util/Instrument.h"
+#include <stdexcept>
+
+namespace game {
+
+IncrementalPotential::IncrementalPotential(const Board& board, const std::vector<Hyperedge>& edges,
+                                           int32_t line_length)
+    : IncrementalPotential(board, std::make_shared<const EdgeIndex>(board.cols(), edges, board.rows()),
+                           line_length) {}
+
+IncrementalPotential::IncrementalPotential(const Board& board, std::shared_ptr<const EdgeIndex> index,
+                                           int32_t line_length)
+    : board_(board)
+    , index_(std::move(index))
+    , edge_maker_(static_cast<size_t>(index_->num_edges()), 0)
+    , edge_breaker_(static_cast<size_t>(index_->num_edges()), 0)
+    , hist_(line_length)
+    , scaled_pot_(0)
+    , complete_edges_(0)
+    , num_empty_(0)
+    , edge_keys_(static_cast<size_t>(index_->num_edges()))
+    , live_degree_(static_cast<size_t>(index_->num_cells()), 0)
+    , live_signature_(static_cast<size_t>(index_->num_cells()), 0) {
+    if (index_->cols() != board.cols() || index_->rows() != board.rows()) {
+        throw std::invalid_argument("Edge index is for another board shape");
+    }
+    // splitmix64 keys give every edge an independent 64-bit signature
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto& key : edge_keys_) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        key = z ^ (z >> 31);
+    }
+    
+    for (int32_t c = 0; c < index_->num_cells(); ++c) {
+        CellState state = board_.get(index_->cell_at(c));
+        if (state == CellState::Empty) {
+            ++num_empty_;
+            continue;
+        }
+        for (int32_t e : index_->edges_of(c)) {
+            if (state == CellState::Maker) {
+                ++edge_maker_[static_cast<size_t>(e)];
+            } else {
+                ++edge_breaker_[static_cast<size_t>(e)];
+            }
+        }
+    }
+    for (int32_t e = 0; e < index_->num_edges(); ++e) {
+        if (static_cast<size_t>(index_->edge_size(e)) > hist_.size()) {
+            hist_.resize(index_->edge_size(e));
+        }
+        add_line(e, +1);
+        if (is_live_edge(e)) {
+            toggle_live(e, +1);
+        }
+    }
+}
+
+void IncrementalPotential::place(int32_t cell, CellState state) {
+    if (state == CellState::Empty || !is_empty(cell)) {
+        throw std::invalid_argument("Cell is already occupied");
+    }
+    board_.set(index_->cell_at(cell), state);
+    --num_empty_;
+    history_.push_back(cell);
+    GAME_COUNT("incremental.places", 1);
+    GAME_COUNT("incremental.edges_updated", index_->edges_of(cell).size());
+
+    for (int32_t e : index_->edges_of(cell)) {
+        add_line(e, -1);
+        if (state == CellState::Maker) {
+            ++edge_maker_[static_cast<size_t>(e)];
+        } else {
+            if (is_live_edge(e)) {
+                toggle_live(e, -1);
+            }
+            ++edge_breaker_[static_cast<size_t>(e)];
+        }
+        add_line(e, +1);
+    }
+}
+
+void IncrementalPotential::undo() {
+    if (history_.empty()) {
+        throw std::logic_error("No move to undo");
+    }
+    int32_t cell = history_.back();
+    history_.pop_back();
+    CellState state = board_.get(index_->cell_at(cell));
+
+    for (int32_t e : index_->edges_of(cell)) {
+        add_line(e, -1);
+        if (state == CellState::Maker) {
+            --edge_maker_[static_cast<size_t>(e)];
+        } else {
+            --edge_breaker_[static_cast<size_t>(e)];
+            if (is_live_edge(e)) {
+                toggle_live(e, +1);
+            }
+        }
+        add_line(e, +1);
+    }
+
+    board_.set(index_->cell_at(cell), CellState::Empty);
+    ++num_empty_;
+}
+
+bool IncrementalPotential::is_empty(int32_t cell) const {
+    return board_.get(index_->cell_at(cell)) == CellState::Empty;
+}
+
+double IncrementalPotential::potential() const {
+    return static_cast<double>(scaled_pot_) / static_cast<double>(kScale);
+}
+
+int64_t IncrementalPotential::breaker_gain(int32_t cell) const {
+    int64_t gain = 0;
+    for (int32_t e : index_->edges_of(cell)) {
+        if (edge_breaker_[static_cast<size_t>(e)] == 0) {
+            gain += weight(index_->edge_size(e) - edge_maker_[static_cast<size_t>(e)]);
+        }
+    }
+    return gain;
+}
+
+void IncrementalPotential::add_line(int32_t edge, int32_t sign) {
+    // Adds (sign = +1) or removes (sign = -1) the edge's contribution
+    if (edge_breaker_[static_cast<size_t>(edge)] != 0) {
+        return;
+    }
+    int32_t empty = index_->edge_size(edge) - edge_maker_[static_cast<size_t>(edge)];
+    if (empty == 0) {
+        complete_edges_ += sign;
+        return;
+    }
+    hist_[static_cast<size_t>(empty - 1)] += sign;
+    scaled_pot_ += sign * weight(empty);
+}
+
+void IncrementalPotential::toggle_live(int32_t edge, int32_t sign) {
+    // Adds (sign = +1) or removes (sign = -1) the edge from its cells' live sets
+    uint64_t key = edge_keys_[static_cast<size_t>(edge)];
+    for (int32_t c : index_->cells_of(edge)) {
+        live_degree_[static_cast<size_t>(c)] += sign;
+        live_signature_[static_cast<size_t>(c)] ^= key;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/EdgeIndex.h"
+#include "metrics/Potential.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game {
+
+// Potential tracker with per-edge counters and in-place undo.
+//
+// Where PotentialCalculator rescans every edge, this keeps the Maker and
+// Breaker count of each edge and the l-line histogram up to date, so a move
+// or its undo costs O(degree of the moved cell). The potential is held as
+// an exact integer scaled by 2^(K-1) for K = kMaxLineLength, which covers
+// every supported line length; pot(b) < 1 is then scaled < kScale.
+//
+// For move generation it also tracks, per cell, how many live edges (no
+// Breaker cell) pass through it and an XOR signature of their ids. These
+// only change when a Breaker move kills an edge.
+class IncrementalPotential {
+public:
+    // Scaled value of pot(b) = 1
+    static constexpr int64_t kScale = int64_t{1} << (kMaxLineLength - 1);
+
+    // The histogram has `line_length` entries, or more if some edge is longer
+    IncrementalPotential(const Board& board, const std::vector<Hyperedge>& edges,
+                         int32_t line_length = kDefaultLineLength);
+
+    // Shares an index built once for the board's shape, e.g. by WidthCache
+    IncrementalPotential(const Board& board, std::shared_ptr<const EdgeIndex> index,
+                         int32_t line_length = kDefaultLineLength);
+
+    const Board& board() const { return board_; }
+    const EdgeIndex& index() const { return *index_; }
+
+    // Place a mark on an empty cell, or take back the last placement
+    void place(int32_t cell, CellState state);
+    void place(const Cell& cell, CellState state) { place(index_->cell_id(cell), state); }
+    void undo();
+
+    bool is_empty(int32_t cell) const;
+    int32_t num_empty() const { return num_empty_; }
+    int32_t num_placed() const { return static_cast<int32_t>(history_.size()); }
+
+    const LLineHistogram& histogram() const { return hist_; }
+    int64_t scaled_potential() const { return scaled_pot_; }
+    double potential() const;
+
+    // Maker has fully occupied at least one edge
+    bool maker_won() const { return complete_edges_ > 0; }
+
+    // pot(b) < 1; only meaningful on Breaker's turn
+    bool has_breaker_certificate() const { return scaled_pot_ < kScale; }
+
+    // Scaled potential Breaker would remove by taking the given empty cell
+    int64_t breaker_gain(int32_t cell) const;
+    
+    // Number of live edges through a cell; an empty cell with none is dead
+    int32_t live_degree(int32_t cell) const { return live_degree_[static_cast<size_t>(cell)]; }
+    
+    // Equal for cells lying in the same set of live edges
+    uint64_t live_signature(int32_t cell) const { return live_signature_[static_cast<size_t>(cell)]; }
+    
+    bool is_live_edge(int32_t edge) const { return edge_breaker_[static_cast<size_t>(edge)] == 0; }
+
+    // Scaled weight of a live edge with l empty cells: 2^(K-l)
+    static int64_t weight(int32_t empty) { return int64_t{1} << (kMaxLineLength - empty); }
+
+private:
+    Board board_;
+    std::shared_ptr<const EdgeIndex> index_;
+    std::vector<int32_t> edge_maker_;
+    std::vector<int32_t> edge_breaker_;
+    LLineHistogram hist_;
+    int64_t scaled_pot_;
+    int32_t complete_edges_;
+    int32_t num_empty_;
+    std::vector<int32_t> history_;
+    std::vector<uint64_t> edge_keys_;
+    std::vector<int32_t> live_degree_;
+    std::vector<uint64_t> live_signature_;
+
+    void add_line(int32_t edge, int32_t sign);
+    void toggle_live(int32_t edge, int32_t sign);
+};
+
+} // namespace game
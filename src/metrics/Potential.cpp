@@ -1,11 +1,14 @@
 #include "metrics/Potential.h"
+#include "util/Instrument.h"
 #include <cmath>
 
 namespace game {
 
-PotentialCalculator::PotentialCalculator(const Board& board, const std::vector<Hyperedge>& edges)
+PotentialCalculator::PotentialCalculator(const Board& board, const std::vector<Hyperedge>& edges,
+                                         int32_t line_length)
     : board_(board)
-    , edges_(edges) {
+    , edges_(edges)
+    , line_length_(line_length) {
 }
 
 double PotentialCalculator::compute_potential() const {
@@ -13,23 +16,27 @@ double PotentialCalculator::compute_potential() const {
     double pot = 0.0;
     
     // pot(b) = sum_{l=1..k} x_l * 2^{-(l-1)}
-    for (int32_t l = 1; l <= 7; ++l) {
-        int32_t x_l = hist[static_cast<size_t>(l - 1)];
-        double weight = std::pow(2.0, -static_cast<double>(l - 1));
-        pot += static_cast<double>(x_l) * weight;
+    for (size_t l = 1; l <= hist.size(); ++l) {
+        pot += std::ldexp(static_cast<double>(hist[l - 1]), -static_cast<int>(l - 1));
     }
     
     return pot;
 }
 
 LLineHistogram PotentialCalculator::compute_histogram() const {
-    LLineHistogram hist = {0, 0, 0, 0, 0, 0, 0};
+    GAME_SCOPE("PotentialCalculator::compute_histogram");
+    GAME_COUNT("potential.recomputes", 1);
+    GAME_COUNT("potential.edges_scanned", edges_.size());
+    LLineHistogram hist(line_length_);
     
     for (const auto& edge : edges_) {
+        if (edge.size() > hist.size()) {
+            hist.resize(static_cast<int32_t>(edge.size()));
+        }
         // An l-line has no Breaker cells and exactly l empty cells
         if (!has_breaker_cell(edge)) {
             int32_t empty_count = count_empty_cells(edge);
-            if (empty_count >= 1 && empty_count <= 7) {
+            if (empty_count >= 1) {
                 ++hist[static_cast<size_t>(empty_count - 1)];
             }
         }
@@ -2,17 +2,51 @@
 
 #include "core/Board.h"
 #include "core/Edges.h"
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <stdexcept>
 
 namespace game {
 
-// Histogram of l-lines for l = 1..7
-using LLineHistogram = std::array<int32_t, 7>;
+// Counts x_1..x_k of l-lines. Storage is fixed at kMaxLineLength entries;
+// size() is the line length k of the game, so the default game keeps seven.
+class LLineHistogram {
+public:
+    LLineHistogram() = default;
+    explicit LLineHistogram(int32_t line_length)
+        : size_(0) {
+        resize(line_length);
+    }
+    
+    size_t size() const { return static_cast<size_t>(size_); }
+    int32_t& operator[](size_t l) { return counts_[l]; }
+    int32_t operator[](size_t l) const { return counts_[l]; }
+    const int32_t* begin() const { return counts_.data(); }
+    const int32_t* end() const { return counts_.data() + size_; }
+    
+    // Extends the histogram to at least `line_length` entries
+    void resize(int32_t line_length) {
+        if (line_length > kMaxLineLength) {
+            throw std::invalid_argument("Line length exceeds kMaxLineLength");
+        }
+        size_ = std::max(size_, line_length);
+    }
+    
+    bool operator==(const LLineHistogram& other) const {
+        return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+    }
+    
+private:
+    std::array<int32_t, kMaxLineLength> counts_{};
+    int32_t size_ = kDefaultLineLength;
+};
 
 class PotentialCalculator {
 public:
-    PotentialCalculator(const Board& board, const std::vector<Hyperedge>& edges);
+    // The histogram has `line_length` entries, or more if some edge is longer
+    PotentialCalculator(const Board& board, const std::vector<Hyperedge>& edges,
+                        int32_t line_length = kDefaultLineLength);
     
     // Compute potential: pot(b) = sum_{l=1..k} x_l * 2^{-(l-1)}
     double compute_potential() const;
@@ -26,6 +60,7 @@ public:
 private:
     const Board& board_;
     const std::vector<Hyperedge>& edges_;
+    int32_t line_length_;
     
     // Check if an edge is an l-line (no Breaker cells, exactly l empty cells)
     int32_t count_empty_cells(const Hyperedge& edge) const;
@@ -0,0 +1,275 @@
+#include "metrics/Trajectory.h"
+#include "metrics/IncrementalPotential.h"
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace game {
+
+namespace {
+
+constexpr const char* kOutcomeNames[] = {"maker_win", "board_full", "unfinished", "all"};
+
+std::string format_number(double value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    return std::string(buf, result.ptr);
+}
+
+} // namespace
+
+size_t QuantileSketch::bucket(uint64_t value) {
+    if (value < (uint64_t{1} << kExactBits)) {
+        return static_cast<size_t>(value);
+    }
+    auto octave = static_cast<int32_t>(std::bit_width(value)) - 1;
+    if (octave >= kMaxBits) {
+        return kBuckets - 1;
+    }
+    auto sub = static_cast<size_t>((value >> (octave - kSubBits)) & ((uint64_t{1} << kSubBits) - 1));
+    return (size_t{1} << kExactBits) + (static_cast<size_t>(octave - kExactBits) << kSubBits) + sub;
+}
+
+double QuantileSketch::value_of(size_t bucket) {
+    if (bucket < (size_t{1} << kExactBits)) {
+        return static_cast<double>(bucket);
+    }
+    size_t index = bucket - (size_t{1} << kExactBits);
+    auto octave = static_cast<int32_t>(index >> kSubBits) + kExactBits;
+    auto sub = static_cast<uint64_t>(index & ((size_t{1} << kSubBits) - 1));
+    uint64_t width = uint64_t{1} << (octave - kSubBits);
+    uint64_t lower = ((uint64_t{1} << kSubBits) + sub) * width;
+    return static_cast<double>(lower) + static_cast<double>(width - 1) / 2.0;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    for (size_t b = 0; b < kBuckets; ++b) {
+        if (static_cast<uint64_t>(counts_[b]) + other.counts_[b] > std::numeric_limits<uint32_t>::max()) {
+            throw std::overflow_error("Quantile sketch bucket exceeds 2^32 values");
+        }
+        counts_[b] += other.counts_[b];
+    }
+    count_ += other.count_;
+}
+
+void QuantileSketch::save(CheckpointBuffer& out) const {
+    out.put_bytes(counts_.data(), sizeof(counts_));
+    out.put(count_);
+}
+
+void QuantileSketch::load(CheckpointReader& in) {
+    in.get_bytes(counts_.data(), sizeof(counts_));
+    count_ = in.get<int64_t>();
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    auto rank = static_cast<int64_t>(std::ceil(q * static_cast<double>(count_)));
+    rank = std::max<int64_t>(rank, 1);
+    int64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        seen += counts_[b];
+        if (seen >= rank) {
+            return value_of(b);
+        }
+    }
+    return value_of(kBuckets - 1);
+}
+
+TrajectoryStats::TrajectoryStats(int32_t max_plies, int32_t line_length)
+    : max_plies_(max_plies)
+    , line_length_(line_length) {
+    if (max_plies < 0) {
+        throw std::invalid_argument("Trajectory ply count must not be negative");
+    }
+    if (line_length < 1 || line_length > kMaxLineLength) {
+        throw std::invalid_argument("Line length outside 1..kMaxLineLength");
+    }
+    size_t slots = static_cast<size_t>(kGameOutcomes) * static_cast<size_t>(max_plies);
+    reached_.assign(slots, 0);
+    ended_.assign(slots, 0);
+    certified_.assign(slots, 0);
+    series_.resize(slots * static_cast<size_t>(line_length + 1));
+}
+
+void TrajectoryStats::add_game(GameOutcome outcome, std::span<const int64_t> scaled_pots,
+                               std::span<const int32_t> lines, int32_t cert_move) {
+    auto plies = static_cast<int32_t>(scaled_pots.size());
+    auto stride = static_cast<size_t>(line_length_);
+    if (plies > max_plies_ || lines.size() != scaled_pots.size() * stride) {
+        throw std::invalid_argument("Game does not fit the trajectory shape");
+    }
+    auto o = static_cast<int32_t>(outcome);
+    ++games_[static_cast<size_t>(o)];
+    if (plies > 0) {
+        ++ended_[slot(o, plies)];
+    }
+    if (cert_move > 0 && cert_move <= plies) {
+        ++certified_[slot(o, cert_move)];
+    }
+    for (int32_t ply = 1; ply <= plies; ++ply) {
+        size_t s = slot(o, ply);
+        ++reached_[s];
+        auto p = static_cast<size_t>(ply - 1);
+        Series* series = &series_[s * (stride + 1)];
+        series[0].sum += scaled_pots[p];
+        series[0].sketch.add(static_cast<uint64_t>(scaled_pots[p]));
+        for (size_t l = 0; l < stride; ++l) {
+            int32_t count = lines[p * stride + l];
+            series[l + 1].sum += count;
+            series[l + 1].sketch.add(static_cast<uint64_t>(count));
+        }
+    }
+}
+
+void TrajectoryStats::merge(const TrajectoryStats& other) {
+    if (other.max_plies_ != max_plies_ || other.line_length_ != line_length_) {
+        throw std::invalid_argument("Cannot merge trajectories of different shapes");
+    }
+    for (size_t o = 0; o < games_.size(); ++o) {
+        games_[o] += other.games_[o];
+    }
+    for (size_t s = 0; s < reached_.size(); ++s) {
+        reached_[s] += other.reached_[s];
+        ended_[s] += other.ended_[s];
+        certified_[s] += other.certified_[s];
+    }
+    for (size_t s = 0; s < series_.size(); ++s) {
+        series_[s].sum += other.series_[s].sum;
+        series_[s].sketch.merge(other.series_[s].sketch);
+    }
+}
+
+void TrajectoryStats::save(CheckpointBuffer& out) const {
+    out.put(max_plies_);
+    out.put(line_length_);
+    out.put_bytes(games_.data(), sizeof(games_));
+    out.put_bytes(reached_.data(), reached_.size() * sizeof(int64_t));
+    out.put_bytes(ended_.data(), ended_.size() * sizeof(int64_t));
+    out.put_bytes(certified_.data(), certified_.size() * sizeof(int64_t));
+    for (const Series& series : series_) {
+        out.put(series.sum);
+        series.sketch.save(out);
+    }
+}
+
+void TrajectoryStats::load(CheckpointReader& in) {
+    auto max_plies = in.get<int32_t>();
+    auto line_length = in.get<int32_t>();
+    if (max_plies != max_plies_ || line_length != line_length_) {
+        throw std::invalid_argument("Saved trajectories have another shape");
+    }
+    in.get_bytes(games_.data(), sizeof(games_));
+    in.get_bytes(reached_.data(), reached_.size() * sizeof(int64_t));
+    in.get_bytes(ended_.data(), ended_.size() * sizeof(int64_t));
+    in.get_bytes(certified_.data(), certified_.size() * sizeof(int64_t));
+    for (Series& series : series_) {
+        series.sum = in.get<int64_t>();
+        series.sketch.load(in);
+    }
+}
+
+int64_t TrajectoryStats::total_games(int32_t outcome) const {
+    if (outcome >= 0) {
+        return games_[static_cast<size_t>(outcome)];
+    }
+    return games_[0] + games_[1] + games_[2];
+}
+
+TrajectoryStats::PlySummary TrajectoryStats::summarize(int32_t outcome, int32_t ply) const {
+    auto stride = static_cast<size_t>(line_length_) + 1;
+    int32_t first = outcome >= 0 ? outcome : 0;
+    int32_t last = outcome >= 0 ? outcome : kGameOutcomes - 1;
+    PlySummary summary;
+    std::array<int64_t, kMaxLineLength + 1> sums{};
+    std::vector<QuantileSketch> sketches(stride);
+    for (int32_t o = first; o <= last; ++o) {
+        size_t s = slot(o, ply);
+        summary.games += reached_[s];
+        summary.ended += ended_[s];
+        summary.certified += certified_[s];
+        for (size_t i = 0; i < stride; ++i) {
+            sums[i] += series_[s * stride + i].sum;
+            sketches[i].merge(series_[s * stride + i].sketch);
+        }
+    }
+    if (summary.games == 0) {
+        return summary;
+    }
+    for (size_t i = 0; i < stride; ++i) {
+        // pot is stored scaled; the x_l are plain counts
+        double scale = i == 0 ? static_cast<double>(IncrementalPotential::kScale) : 1.0;
+        summary.series[i].mean = static_cast<double>(sums[i]) / static_cast<double>(summary.games) / scale;
+        summary.series[i].p50 = sketches[i].quantile(0.50) / scale;
+        summary.series[i].p99 = sketches[i].quantile(0.99) / scale;
+    }
+    return summary;
+}
+
+void TrajectoryStats::write_csv(std::ostream& out) const {
+    out << "outcome,ply,games,ended,certified,pot_mean,pot_p50,pot_p99";
+    for (int32_t l = 1; l <= line_length_; ++l) {
+        out << ",x" << l << "_mean,x" << l << "_p50,x" << l << "_p99";
+    }
+    out << "\n";
+    for (int32_t outcome = 0; outcome <= kGameOutcomes; ++outcome) {
+        int32_t selected = outcome < kGameOutcomes ? outcome : -1;
+        for (int32_t ply = 1; ply <= max_plies_; ++ply) {
+            PlySummary summary = summarize(selected, ply);
+            if (summary.games == 0) break;
+            out << kOutcomeNames[outcome] << "," << ply << "," << summary.games << "," << summary.ended << ","
+                << summary.certified;
+            for (size_t i = 0; i <= static_cast<size_t>(line_length_); ++i) {
+                const Summary& series = summary.series[i];
+                out << "," << format_number(series.mean) << "," << format_number(series.p50) << ","
+                    << format_number(series.p99);
+            }
+            out << "\n";
+        }
+    }
+}
+
+void TrajectoryStats::write_json(std::ostream& out) const {
+    auto write_summary = [&](const Summary& series) {
+        out << "{\"mean\":" << format_number(series.mean) << ",\"p50\":" << format_number(series.p50)
+            << ",\"p99\":" << format_number(series.p99) << "}";
+    };
+
+    out << "{\"line_length\":" << line_length_ << ",\"max_plies\":" << max_plies_ << ",\"outcomes\":{";
+    for (int32_t outcome = 0; outcome <= kGameOutcomes; ++outcome) {
+        int32_t selected = outcome < kGameOutcomes ? outcome : -1;
+        std::vector<PlySummary> plies;
+        int64_t certified = 0;
+        for (int32_t ply = 1; ply <= max_plies_; ++ply) {
+            plies.push_back(summarize(selected, ply));
+            if (plies.back().games == 0) {
+                plies.pop_back();
+                break;
+            }
+            certified += plies.back().certified;
+        }
+        out << (outcome > 0 ? ",\n" : "\n") << "\"" << kOutcomeNames[outcome] << "\":{\"games\":"
+            << total_games(selected) << ",\"certified\":" << certified << ",\"plies\":[";
+        for (size_t p = 0; p < plies.size(); ++p) {
+            const PlySummary& summary = plies[p];
+            out << (p > 0 ? ",\n" : "\n") << "{\"ply\":" << p + 1 << ",\"games\":" << summary.games
+                << ",\"ended\":" << summary.ended << ",\"certified\":" << summary.certified << ",\"pot\":";
+            write_summary(summary.series[0]);
+            out << ",\"x\":[";
+            for (size_t l = 1; l <= static_cast<size_t>(line_length_); ++l) {
+                if (l > 1) out << ",";
+                write_summary(summary.series[l]);
+            }
+            out << "]}";
+        }
+        out << "]}";
+    }
+    out << "\n}}\n";
+}
+
+} // namespace game
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "core/Edges.h"
+#include "util/Checkpoint.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace game {
+
+// Log-bucketed counts of non-negative integers, mergeable by adding counts.
+//
+// Values below 32 get a bucket each and are exact. Above that every octave
+// has 16 buckets, so a quantile reported as its bucket's midpoint is within
+// 1/32 of the true value. Values from 2^40 share the top bucket. The
+// buckets are a fixed array of 32-bit counts: adding never allocates, and
+// adding or merging past 2^32 - 1 values in one bucket throws.
+class QuantileSketch {
+public:
+    static constexpr int32_t kExactBits = 5;
+    static constexpr int32_t kSubBits = 4;
+    static constexpr int32_t kMaxBits = 40;
+    static constexpr size_t kBuckets = (size_t{1} << kExactBits) + static_cast<size_t>(kMaxBits - kExactBits) *
+                                                                       (size_t{1} << kSubBits);
+
+    void add(uint64_t value) {
+        uint32_t& slot = counts_[bucket(value)];
+        if (slot == std::numeric_limits<uint32_t>::max()) {
+            throw std::overflow_error("Quantile sketch bucket exceeds 2^32 values");
+        }
+        ++slot;
+        ++count_;
+    }
+
+    void merge(const QuantileSketch& other);
+
+    void save(CheckpointBuffer& out) const;
+    void load(CheckpointReader& in);
+
+    int64_t count() const { return count_; }
+
+    // Nearest-rank q-quantile, 0 when empty
+    double quantile(double q) const;
+
+    static size_t bucket(uint64_t value);
+
+    // Midpoint of a bucket's integer range
+    static double value_of(size_t bucket);
+
+private:
+    std::array<uint32_t, kBuckets> counts_{};
+    int64_t count_ = 0;
+};
+
+enum class GameOutcome : uint8_t {
+    MakerWin = 0,      // Maker completed an edge
+    BoardFull = 1,     // Every cell taken without one: Breaker won
+    Unfinished = 2     // Stopped at the move limit
+};
+
+constexpr int32_t kGameOutcomes = 3;
+
+// Distribution of pot(b) and of each x_l at every ply across many random
+// games, split by how the game ended.
+//
+// For each outcome and ply p it keeps how many games reached p, ended at p,
+// or first had a Breaker certificate (pot < 1 before Breaker's move) at move
+// p, and for pot and each x_l an exact sum and a QuantileSketch. Storage is
+// sized once for max_plies, so add_game() never allocates; each thread
+// fills its own and merge() folds them together. Sums are integers (pot is
+// kept scaled by IncrementalPotential::kScale), so merged results do not
+// depend on how the games were split.
+class TrajectoryStats {
+public:
+    TrajectoryStats(int32_t max_plies, int32_t line_length = kDefaultLineLength);
+
+    int32_t max_plies() const { return max_plies_; }
+    int32_t line_length() const { return line_length_; }
+    int64_t games(GameOutcome outcome) const { return games_[static_cast<size_t>(outcome)]; }
+
+    // One game of scaled_pots.size() moves. Entry p of scaled_pots, and
+    // entries p*k..p*k+k-1 of lines, describe the position after move p + 1.
+    // cert_move is the first Breaker move made with pot < 1, or 0 for none.
+    void add_game(GameOutcome outcome, std::span<const int64_t> scaled_pots, std::span<const int32_t> lines,
+                  int32_t cert_move);
+
+    void merge(const TrajectoryStats& other);
+
+    // Everything added so far, for checkpoints; load() replaces the contents
+    // and throws if the saved statistics have another shape
+    void save(CheckpointBuffer& out) const;
+    void load(CheckpointReader& in);
+
+    // One row per outcome (and "all") and ply reached:
+    //
+    //     outcome,ply,games,ended,certified,pot_mean,pot_p50,pot_p99,x1_mean,...,xk_p99
+    void write_csv(std::ostream& out) const;
+
+    // The same figures nested by outcome, with per-outcome totals
+    void write_json(std::ostream& out) const;
+
+private:
+    struct Series {
+        int64_t sum = 0;
+        QuantileSketch sketch;
+    };
+
+    struct Summary {
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    struct PlySummary {
+        int64_t games = 0;
+        int64_t ended = 0;
+        int64_t certified = 0;
+        std::array<Summary, kMaxLineLength + 1> series{};   // pot, then x_1..x_k
+    };
+
+    int32_t max_plies_;
+    int32_t line_length_;
+    std::array<int64_t, kGameOutcomes> games_{};
+    std::vector<int64_t> reached_;      // [outcome][ply]
+    std::vector<int64_t> ended_;
+    std::vector<int64_t> certified_;
+    std::vector<Series> series_;        // [outcome][ply][pot, x_1..x_k]
+
+    size_t slot(int32_t outcome, int32_t ply) const {
+        return static_cast<size_t>(outcome) * static_cast<size_t>(max_plies_) + static_cast<size_t>(ply - 1);
+    }
+
+    // Outcome -1 combines all three
+    PlySummary summarize(int32_t outcome, int32_t ply) const;
+    int64_t total_games(int32_t outcome) const;
+};
+
+} // namespace game
@@ -0,0 +1,100 @@
+#include "search/Certifier.h"
+#include "util/Instrument.h"
+#include <stdexcept>
+
+namespace game {
+
+Certifier::Certifier(const Board& board, const std::vector<Hyperedge>& edges, CertifyOptions options)
+    : Certifier(board, std::make_shared<const EdgeIndex>(board.cols(), edges, board.rows()), options) {}
+
+Certifier::Certifier(const Board& board, std::shared_ptr<const EdgeIndex> index, CertifyOptions options)
+    : state_(board, std::move(index))
+    , options_(options)
+    , nodes_(0) {
+    if (options.depth < 0) {
+        throw std::invalid_argument("Certificate depth must be non-negative");
+    }
+    moves_.resize(static_cast<size_t>(options.depth) + 1);
+}
+
+CertifyResult Certifier::certify(Player to_move) {
+    GAME_SCOPE("Certifier::certify");
+    nodes_ = 0;
+    CertifyResult result;
+    if (!state_.maker_won()) {
+        result.certified = (to_move == Player::Maker) ? maker_node(options_.depth)
+                                                      : breaker_node(options_.depth);
+    }
+    result.nodes = nodes_;
+    GAME_COUNT("certifier.nodes", nodes_);
+    return result;
+}
+
+std::optional<bool> Certifier::probe(Player to_move) const {
+    // Mark count first: scanning the board for shallow nodes would be wasted
+    const Tablebase* tablebase = options_.tablebase;
+    const Board& board = state_.board();
+    if (!tablebase || board.rows() * board.cols() - state_.num_empty() < tablebase->first_layer()) {
+        return std::nullopt;
+    }
+    return tablebase->probe(board, to_move);
+}
+
+bool Certifier::maker_node(int32_t plies_left) {
+    ++nodes_;
+    if (state_.num_empty() == 0) {
+        return true;
+    }
+    if (auto maker_wins = probe(Player::Maker)) {
+        return !*maker_wins;
+    }
+    if (plies_left == 0) {
+        return false;
+    }
+    
+    // Every Maker move must be refuted; no live cell means no threat left
+    auto& moves = moves_[static_cast<size_t>(plies_left)];
+    generator_.generate(state_, moves);
+    for (int32_t c : moves) {
+        state_.place(c, CellState::Maker);
+        bool refuted = !state_.maker_won() && breaker_node(plies_left - 1);
+        state_.undo();
+        if (!refuted) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Certifier::breaker_node(int32_t plies_left) {
+    ++nodes_;
+    if (state_.has_breaker_certificate() || state_.num_empty() == 0) {
+        return true;
+    }
+    if (auto maker_wins = probe(Player::Breaker)) {
+        return !*maker_wins;
+    }
+    if (plies_left == 0) {
+        return false;
+    }
+    
+    // Moves come ordered by potential removed, so the greedy reply is first
+    auto& moves = moves_[static_cast<size_t>(plies_left)];
+    generator_.generate(state_, moves);
+    if (options_.replies == BreakerReplies::Greedy && moves.size() > 1) {
+        moves.erase(moves.begin() + 1, moves.end());
+    }
+    
+    // One Breaker reply suffices
+    for (int32_t c : moves) {
+        state_.place(c, CellState::Breaker);
+        bool certified = maker_node(plies_left - 1);
+        state_.undo();
+        if (certified) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/IncrementalPotential.h"
+#include "search/MoveGenerator.h"
+#include "search/Tablebase.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace game {
+
+enum class BreakerReplies : uint8_t {
+    Greedy = 0,     // Breaker takes the cell removing the most potential
+    Exhaustive = 1  // Any Breaker reply may be used
+};
+
+struct CertifyOptions {
+    int32_t depth = 4;
+    BreakerReplies replies = BreakerReplies::Greedy;
+    const Tablebase* tablebase = nullptr;  // Exact values where it covers the board
+};
+
+struct CertifyResult {
+    bool certified = false;
+    int64_t nodes = 0;
+};
+
+// Lookahead Breaker certificate.
+//
+// Searches every Maker move and Breaker's replies (greedy or exhaustive) for
+// up to `depth` plies. The position is certified when every line reaches a
+// Breaker turn with pot(b) < 1, or a full board without a Maker win, before
+// the depth runs out. With depth 0 this is exactly has_breaker_certificate().
+// Moves come from MoveGenerator, so dead and equivalent cells are skipped.
+class Certifier {
+public:
+    Certifier(const Board& board, const std::vector<Hyperedge>& edges, CertifyOptions options);
+
+    // Reuses an index built once for the board's shape
+    Certifier(const Board& board, std::shared_ptr<const EdgeIndex> index, CertifyOptions options);
+
+    CertifyResult certify(Player to_move);
+
+private:
+    IncrementalPotential state_;
+    CertifyOptions options_;
+    int64_t nodes_;
+    std::vector<std::vector<int32_t>> moves_;
+    MoveGenerator generator_;
+
+    bool maker_node(int32_t plies_left);
+    bool breaker_node(int32_t plies_left);
+    std::optional<bool> probe(Player to_move) const;
+};
+
+} // namespace game
@@ -0,0 +1,132 @@
+#include "search/Decomposition.h"
+#include "util/Instrument.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+namespace game {
+
+namespace {
+
+int32_t find_root(std::vector<int32_t>& parent, int32_t x) {
+    while (parent[static_cast<size_t>(x)] != x) {
+        parent[static_cast<size_t>(x)] = parent[static_cast<size_t>(parent[static_cast<size_t>(x)])];
+        x = parent[static_cast<size_t>(x)];
+    }
+    return x;
+}
+
+bool is_live(const Board& board, const EdgeIndex& index, int32_t edge) {
+    bool has_empty = false;
+    for (int32_t id : index.cells_of(edge)) {
+        CellState state = board.get(index.cell_at(id));
+        if (state == CellState::Breaker) return false;
+        if (state == CellState::Empty) has_empty = true;
+    }
+    return has_empty;
+}
+
+} // namespace
+
+std::vector<Subgame> Decomposer::decompose(const Board& board, const std::vector<Hyperedge>& edges) {
+    return decompose(board, EdgeIndex(board.cols(), edges, board.rows()));
+}
+
+std::vector<Subgame> Decomposer::decompose(const Board& board, const EdgeIndex& index) {
+    GAME_SCOPE("Decomposer::decompose");
+    std::vector<int32_t> parent(static_cast<size_t>(index.num_cells()));
+    std::iota(parent.begin(), parent.end(), 0);
+    
+    // Union the cells of every live edge
+    std::vector<int32_t> live;
+    for (int32_t e = 0; e < index.num_edges(); ++e) {
+        if (!is_live(board, index, e)) continue;
+        live.push_back(e);
+        auto cells = index.cells_of(e);
+        int32_t root = find_root(parent, cells[0]);
+        for (int32_t c : cells) {
+            int32_t other = find_root(parent, c);
+            if (other != root) parent[static_cast<size_t>(other)] = root;
+        }
+    }
+    
+    // Group live edges by component, ordered by leftmost column
+    std::map<int32_t, std::vector<int32_t>> groups;
+    for (int32_t e : live) {
+        groups[find_root(parent, index.cells_of(e)[0])].push_back(e);
+    }
+    struct Span {
+        int32_t first_col;
+        int32_t last_col;
+        int32_t root;
+        bool operator<(const Span& other) const {
+            if (first_col != other.first_col) return first_col < other.first_col;
+            return root < other.root;
+        }
+    };
+    std::vector<Span> spans;
+    for (const auto& [root, group] : groups) {
+        Span span{board.cols(), -1, root};
+        for (int32_t e : group) {
+            for (int32_t id : index.cells_of(e)) {
+                Cell cell = index.cell_at(id);
+                span.first_col = std::min(span.first_col, cell.col);
+                span.last_col = std::max(span.last_col, cell.col);
+            }
+        }
+        spans.push_back(span);
+    }
+    std::sort(spans.begin(), spans.end());
+    
+    std::vector<Subgame> result;
+    for (const auto& [first_col, last_col, root] : spans) {
+        const auto& group = groups[root];
+        
+        Subgame sub{first_col, last_col, Board(last_col - first_col + 1, board.rows()), {}, 0, ""};
+        for (int32_t r = 0; r < board.rows(); ++r) {
+            for (int32_t c = first_col; c <= last_col; ++c) {
+                // Cells outside every live edge are their own singleton root
+                bool member = find_root(parent, index.cell_id({r, c})) == root;
+                CellState state = member ? board.get(r, c) : CellState::Breaker;
+                sub.board.set(r, c - first_col, state);
+                if (state == CellState::Empty) ++sub.empty_cells;
+            }
+        }
+        
+        std::ostringstream key;
+        key << sub.board.cols() << '|';
+        for (int32_t r = 0; r < board.rows(); ++r) {
+            for (int32_t c = 0; c < sub.board.cols(); ++c) {
+                CellState state = sub.board.get(r, c);
+                key << (state == CellState::Maker ? 'M' : state == CellState::Breaker ? 'B' : '.');
+            }
+        }
+        for (int32_t e : group) {
+            Hyperedge edge;
+            key << '|';
+            for (int32_t id : index.cells_of(e)) {
+                Cell cell = index.cell_at(id);
+                cell.col -= first_col;
+                key << cell.row * sub.board.cols() + cell.col << ',';
+                edge.push_back(cell);
+            }
+            sub.edges.push_back(std::move(edge));
+        }
+        sub.key = key.str();
+        result.push_back(std::move(sub));
+    }
+    
+    return result;
+}
+
+bool Decomposer::maker_wins_sum(const std::vector<SubgameOutcome>& outcomes, Player to_move) {
+    int32_t first_wins = 0;
+    for (const auto& outcome : outcomes) {
+        if (to_move == Player::Breaker && outcome.maker_wins_moving_second) return true;
+        if (outcome.maker_wins_moving_first) ++first_wins;
+    }
+    return to_move == Player::Maker ? first_wins >= 1 : first_wins >= 2;
+}
+
+} // namespace game
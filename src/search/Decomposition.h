@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/EdgeIndex.h"
+#include "core/Edges.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace game {
+
+// An independent piece of a position.
+//
+// `board` and `edges` are translated so the component starts at column 0 and
+// can be handed to PotentialCalculator, Certifier or a search on its own.
+// Cells inside the column span that belong to other components are marked as
+// Breaker cells so that they are never generated as moves.
+struct Subgame {
+    int32_t first_col;
+    int32_t last_col;
+    Board board;
+    std::vector<Hyperedge> edges;
+    int32_t empty_cells;
+
+    // Translation-invariant identity, usable as a cache key
+    std::string key;
+};
+
+// Value of a component with each side moving first
+struct SubgameOutcome {
+    bool maker_wins_moving_first;
+    bool maker_wins_moving_second;
+};
+
+class Decomposer {
+public:
+    // Split the live edges (no Breaker cell) of a position into connected
+    // components of the cell/edge hypergraph. Edges without an empty cell are
+    // ignored, so check for a Maker win first.
+    static std::vector<Subgame> decompose(const Board& board, const std::vector<Hyperedge>& edges);
+    static std::vector<Subgame> decompose(const Board& board, const EdgeIndex& index);
+
+    // Combine per-component results into the value of the whole position.
+    // Extra moves never hurt in a Maker-Breaker game, so with Maker to move
+    // Maker needs one component won moving first. With Breaker to move,
+    // Breaker may spend the tempo on one Maker-first win but not two.
+    static bool maker_wins_sum(const std::vector<SubgameOutcome>& outcomes, Player to_move);
+};
+
+} // namespace game
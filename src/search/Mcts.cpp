@@ -0,0 +1,358 @@
+#include "search/Mcts.h"
+#include "metrics/IncrementalPotential.h"
+#include "search/MoveGenerator.h"
+#include "util/Instrument.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace game {
+
+namespace {
+
+enum Expansion : uint8_t {
+    kLeaf = 0,
+    kExpanding = 1,
+    kExpanded = 2,
+    kArenaFull = 3
+};
+
+struct Node {
+    std::atomic<int32_t> visits{0};      // Includes in-flight (virtual loss) visits
+    std::atomic<int32_t> wins{0};        // Won by the player who moved into the node
+    std::atomic<uint8_t> expansion{kLeaf};
+    int32_t first_child = -1;            // Published by the release store to `expansion`
+    int32_t num_children = 0;
+    int32_t cell = -1;
+};
+
+// Fixed-capacity node arena; children of a node occupy one contiguous block
+class Tree {
+public:
+    explicit Tree(int32_t capacity)
+        : nodes_(std::make_unique<Node[]>(static_cast<size_t>(capacity)))
+        , capacity_(capacity)
+        , size_(1) {
+    }
+
+    Node& node(int32_t id) { return nodes_[static_cast<size_t>(id)]; }
+    int32_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    // First id of a block of `count` nodes, or -1 when the arena is full
+    int32_t allocate(int32_t count) {
+        int32_t first = size_.load(std::memory_order_relaxed);
+        do {
+            if (first > capacity_ - count) return -1;
+        } while (!size_.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+        return first;
+    }
+
+private:
+    std::unique_ptr<Node[]> nodes_;
+    int32_t capacity_;
+    std::atomic<int32_t> size_;
+};
+
+Player opponent(Player p) {
+    return p == Player::Maker ? Player::Breaker : Player::Maker;
+}
+
+CellState mark_of(Player p) {
+    return p == Player::Maker ? CellState::Maker : CellState::Breaker;
+}
+
+std::optional<Player> terminal_winner(const IncrementalPotential& state, Player to_move) {
+    if (state.maker_won()) return Player::Maker;
+    if (state.num_empty() == 0) return Player::Breaker;
+    if (to_move == Player::Breaker && state.has_breaker_certificate()) return Player::Breaker;
+    return std::nullopt;
+}
+
+// Per-thread search context: a private copy of the position plus scratch space
+class Worker {
+public:
+    Worker(const Board& board, std::shared_ptr<const EdgeIndex> index, Player root_player,
+           double exploration, uint64_t seed)
+        : state_(board, std::move(index))
+        , root_player_(root_player)
+        , exploration_(exploration)
+        , rng_(seed) {
+    }
+
+    void iterate(Tree& tree) {
+        path_.clear();
+        Player to_move = root_player_;
+        int32_t id = 0;
+        std::optional<Player> winner;
+
+        while (true) {
+            Node& node = tree.node(id);
+            path_.push_back(id);
+            int32_t visits = node.visits.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            winner = terminal_winner(state_, to_move);
+            if (winner) break;
+
+            // Leaves other than the root are expanded on their second visit
+            uint8_t expansion = node.expansion.load(std::memory_order_acquire);
+            if (expansion == kLeaf && (visits > 1 || id == 0)) {
+                expand(tree, node);
+                expansion = node.expansion.load(std::memory_order_acquire);
+                if (expansion == kExpanded && node.num_children == 0) {
+                    // No live cell left: Maker cannot complete any edge
+                    winner = Player::Breaker;
+                    break;
+                }
+            }
+            if (expansion != kExpanded || node.num_children == 0) {
+                winner = playout(to_move);
+                break;
+            }
+
+            id = select(tree, node);
+            state_.place(tree.node(id).cell, mark_of(to_move));
+            to_move = opponent(to_move);
+        }
+
+        // Node i on the path was entered by the root player when i is odd
+        for (size_t i = 0; i < path_.size(); ++i) {
+            Player mover = (i % 2 == 1) ? root_player_ : opponent(root_player_);
+            if (*winner == mover) {
+                tree.node(path_[i]).wins.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 1; i < path_.size(); ++i) {
+            state_.undo();
+        }
+    }
+
+private:
+    IncrementalPotential state_;
+    Player root_player_;
+    double exploration_;
+    std::mt19937_64 rng_;
+    std::vector<int32_t> path_;
+    std::vector<int32_t> moves_;
+    std::vector<int32_t> empty_;
+    MoveGenerator generator_;
+
+    void expand(Tree& tree, Node& node) {
+        uint8_t expected = kLeaf;
+        if (!node.expansion.compare_exchange_strong(expected, kExpanding, std::memory_order_acquire)) {
+            return;
+        }
+        generator_.generate(state_, moves_);
+        int32_t count = static_cast<int32_t>(moves_.size());
+        int32_t first = count > 0 ? tree.allocate(count) : 0;
+        if (first < 0) {
+            node.expansion.store(kArenaFull, std::memory_order_release);
+            return;
+        }
+        for (int32_t i = 0; i < count; ++i) {
+            tree.node(first + i).cell = moves_[static_cast<size_t>(i)];
+        }
+        node.first_child = first;
+        node.num_children = count;
+        node.expansion.store(kExpanded, std::memory_order_release);
+    }
+
+    int32_t select(Tree& tree, const Node& node) {
+        double log_parent = std::log(static_cast<double>(std::max(1, node.visits.load(std::memory_order_relaxed))));
+        int32_t best = node.first_child;
+        double best_score = -std::numeric_limits<double>::infinity();
+        for (int32_t i = 0; i < node.num_children; ++i) {
+            const Node& child = tree.node(node.first_child + i);
+            int32_t visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0) {
+                return node.first_child + i;
+            }
+            double mean = static_cast<double>(child.wins.load(std::memory_order_relaxed)) / visits;
+            double score = mean + exploration_ * std::sqrt(log_parent / visits);
+            if (score > best_score) {
+                best_score = score;
+                best = node.first_child + i;
+            }
+        }
+        return best;
+    }
+
+    Player playout(Player to_move) {
+        empty_.clear();
+        for (int32_t c = 0; c < state_.index().num_cells(); ++c) {
+            if (state_.is_empty(c)) empty_.push_back(c);
+        }
+
+        int32_t placed = 0;
+        std::optional<Player> winner;
+        while (!(winner = terminal_winner(state_, to_move))) {
+            std::uniform_int_distribution<size_t> dist(0, empty_.size() - 1);
+            size_t pick = dist(rng_);
+            state_.place(empty_[pick], mark_of(to_move));
+            empty_[pick] = empty_.back();
+            empty_.pop_back();
+            ++placed;
+            to_move = opponent(to_move);
+        }
+
+        for (int32_t i = 0; i < placed; ++i) {
+            state_.undo();
+        }
+        return *winner;
+    }
+};
+
+int32_t most_visited_child(Tree& tree, const Node& node) {
+    // Children seen only once carry no information beyond a single playout
+    int32_t best = -1;
+    int32_t best_visits = 1;
+    for (int32_t i = 0; i < node.num_children; ++i) {
+        int32_t visits = tree.node(node.first_child + i).visits.load(std::memory_order_relaxed);
+        if (visits > best_visits) {
+            best_visits = visits;
+            best = node.first_child + i;
+        }
+    }
+    return best;
+}
+
+// Follow the most visited children from `id`, appending their moves
+void extend_variation(Tree& tree, int32_t id, const IncrementalPotential& shape, std::vector<Cell>& pv) {
+    while (tree.node(id).expansion.load(std::memory_order_acquire) == kExpanded) {
+        id = most_visited_child(tree, tree.node(id));
+        if (id < 0) break;
+        pv.push_back(shape.index().cell_at(tree.node(id).cell));
+    }
+}
+
+} // namespace
+
+MctsEngine::MctsEngine(const Game& game, MctsOptions options)
+    : board_(game.board())
+    , index_(game.index())
+    , to_move_(game.current_player())
+    , options_(options) {
+    if (options.threads <= 0) {
+        throw std::invalid_argument("Thread count must be positive");
+    }
+    if (options.max_nodes < options.threads) {
+        throw std::invalid_argument("Node arena too small for the thread count");
+    }
+    if (options.iterations < 0 || options.time_ms < 0) {
+        throw std::invalid_argument("MCTS budgets must not be negative");
+    }
+    if (options.iterations == 0 && options.time_ms == 0) {
+        throw std::invalid_argument("MCTS needs an iteration or time budget: -i 0 requires --time-ms");
+    }
+}
+
+MctsResult MctsEngine::search() {
+    GAME_SCOPE("MctsEngine::search");
+    bool shared = options_.mode == MctsMode::TreeParallel;
+    int32_t num_trees = shared ? 1 : options_.threads;
+    std::vector<std::unique_ptr<Tree>> trees;
+    for (int32_t t = 0; t < num_trees; ++t) {
+        trees.push_back(std::make_unique<Tree>(options_.max_nodes / num_trees));
+    }
+
+    // iterations == 0 means time only; the constructor guarantees a deadline then
+    int64_t budget = options_.iterations > 0 ? options_.iterations : std::numeric_limits<int64_t>::max();
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(options_.time_ms);
+    std::atomic<int64_t> claimed{0};
+    std::atomic<int64_t> completed{0};
+
+    auto run = [&](int32_t t) {
+        Worker worker(board_, index_, to_move_, options_.exploration,
+                      options_.seed + static_cast<uint64_t>(t) * 0x9E3779B97F4A7C15ULL);
+        Tree& tree = *trees[static_cast<size_t>(shared ? 0 : t)];
+        int64_t done = 0;
+        while (claimed.fetch_add(1, std::memory_order_relaxed) < budget) {
+            worker.iterate(tree);
+            ++done;
+            if (options_.time_ms > 0 && done % 16 == 0 && std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        completed.fetch_add(done, std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> pool;
+    for (int32_t t = 1; t < options_.threads; ++t) {
+        pool.emplace_back(run, t);
+    }
+    run(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    MctsResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.playouts = completed.load();
+
+    // Sum root statistics over the trees; the root was entered by the opponent
+    int64_t root_visits = 0;
+    int64_t root_wins = 0;
+    for (const auto& tree : trees) {
+        result.nodes += tree->size();
+        root_visits += tree->node(0).visits.load();
+        root_wins += tree->node(0).wins.load();
+    }
+    if (root_visits > 0) {
+        int64_t maker_wins = (to_move_ == Player::Maker) ? root_visits - root_wins : root_wins;
+        result.maker_win_rate = static_cast<double>(maker_wins) / static_cast<double>(root_visits);
+    }
+
+    // Best root move by summed visits, then continue in the tree that saw it most
+    IncrementalPotential shape(board_, index_);
+    std::vector<std::pair<int64_t, int32_t>> totals;
+    for (const auto& tree : trees) {
+        Node& root = tree->node(0);
+        if (root.expansion.load(std::memory_order_acquire) != kExpanded) continue;
+        for (int32_t i = 0; i < root.num_children; ++i) {
+            const Node& child = tree->node(root.first_child + i);
+            auto it = std::find_if(totals.begin(), totals.end(),
+                                   [&](const auto& entry) { return entry.second == child.cell; });
+            if (it == totals.end()) {
+                totals.push_back({child.visits.load(), child.cell});
+            } else {
+                it->first += child.visits.load();
+            }
+        }
+    }
+    auto best = std::max_element(totals.begin(), totals.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    });
+    if (best == totals.end() || best->first == 0) {
+        return result;
+    }
+    result.principal_variation.push_back(shape.index().cell_at(best->second));
+
+    Tree* best_tree = nullptr;
+    int32_t best_child = -1;
+    int32_t best_visits = -1;
+    for (const auto& tree : trees) {
+        Node& root = tree->node(0);
+        if (root.expansion.load(std::memory_order_acquire) != kExpanded) continue;
+        for (int32_t i = 0; i < root.num_children; ++i) {
+            const Node& child = tree->node(root.first_child + i);
+            if (child.cell == best->second && child.visits.load() > best_visits) {
+                best_visits = child.visits.load();
+                best_tree = tree.get();
+                best_child = root.first_child + i;
+            }
+        }
+    }
+    extend_variation(*best_tree, best_child, shape, result.principal_variation);
+
+    return result;
+}
+
+} // namespace game
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Game.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game {
+
+enum class MctsMode : uint8_t {
+    RootParallel = 0,  // Independent trees per thread, root statistics summed
+    TreeParallel = 1   // One shared tree, threads kept apart by virtual loss
+};
+
+struct MctsOptions {
+    int64_t iterations = 10000;   // Total playouts across all threads; 0 for time only
+    int64_t time_ms = 0;          // Wall-clock budget; 0 means iterations only
+    int32_t threads = 1;
+    MctsMode mode = MctsMode::TreeParallel;
+    double exploration = 1.4;
+    uint64_t seed = 42;
+    int32_t max_nodes = 1 << 20;  // Arena capacity, shared by all threads
+};
+
+struct MctsResult {
+    std::vector<Cell> principal_variation;
+    int64_t playouts = 0;
+    int64_t nodes = 0;
+    double seconds = 0.0;
+    double maker_win_rate = 0.0;  // Over all playouts from the root
+};
+
+// Monte-Carlo tree search over a Game position.
+//
+// Selection is UCT on the win rate of the player who moved into a node. Tree
+// moves come from MoveGenerator; playouts pick uniformly random empty cells
+// as in simulate, and stop as soon as Maker completes an edge, the board is
+// full, or has_breaker_certificate() fires on Breaker's turn. Nodes live in
+// a preallocated arena with children stored contiguously and are expanded on
+// their second visit; once the arena is full, leaves are no longer expanded
+// and searches continue with playouts only.
+class MctsEngine {
+public:
+    MctsEngine(const Game& game, MctsOptions options);
+
+    MctsResult search();
+
+private:
+    Board board_;
+    std::shared_ptr<const EdgeIndex> index_;
+    Player to_move_;
+    MctsOptions options_;
+};
+
+} // namespace game
@@ -0,0 +1,74 @@
+#include "search/MoveGenerator.h"
+#include <algorithm>
+#include <utility>
+
+namespace game {
+
+void MoveGenerator::generate(const IncrementalPotential& state, std::vector<int32_t>& moves) {
+    moves.clear();
+    
+    // Live empty cells grouped by signature
+    auto& live = live_;
+    live.clear();
+    for (int32_t c = 0; c < state.index().num_cells(); ++c) {
+        if (state.live_degree(c) > 0 && state.is_empty(c)) {
+            live.push_back({state.live_signature(c), c});
+        }
+    }
+    std::sort(live.begin(), live.end());
+    
+    for (size_t i = 0; i < live.size(); ++i) {
+        bool duplicate = false;
+        for (size_t j = i; j > 0 && live[j - 1].first == live[i].first; --j) {
+            if (same_live_edges(state, live[j - 1].second, live[i].second)) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            moves.push_back(live[i].second);
+        }
+    }
+    
+    auto& scored = scored_;
+    scored.clear();
+    for (int32_t c : moves) {
+        scored.push_back({-state.breaker_gain(c), c});
+    }
+    std::sort(scored.begin(), scored.end());
+    for (size_t i = 0; i < scored.size(); ++i) {
+        moves[i] = scored[i].second;
+    }
+}
+
+std::vector<int32_t> MoveGenerator::generate(const IncrementalPotential& state) {
+    std::vector<int32_t> moves;
+    MoveGenerator generator;
+    generator.generate(state, moves);
+    return moves;
+}
+
+bool MoveGenerator::same_live_edges(const IncrementalPotential& state, int32_t a, int32_t b) {
+    // Signatures matched; confirm so a hash collision can never merge cells
+    if (state.live_degree(a) != state.live_degree(b)) {
+        return false;
+    }
+    auto edges_a = state.index().edges_of(a);
+    auto edges_b = state.index().edges_of(b);
+    size_t i = 0;
+    size_t j = 0;
+    while (true) {
+        while (i < edges_a.size() && !state.is_live_edge(edges_a[i])) ++i;
+        while (j < edges_b.size() && !state.is_live_edge(edges_b[j])) ++j;
+        if (i == edges_a.size() || j == edges_b.size()) {
+            return i == edges_a.size() && j == edges_b.size();
+        }
+        if (edges_a[i] != edges_b[j]) {
+            return false;
+        }
+        ++i;
+        ++j;
+    }
+}
+
+} // namespace game
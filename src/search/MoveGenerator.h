@@ -0,0 +1,37 @@
+#pragma once
+
+#include "metrics/IncrementalPotential.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+// Pruned move generation over an IncrementalPotential.
+//
+// Instead of every empty cell, generate() yields:
+//   - only live cells (in at least one edge without a Breaker cell); a dead
+//     cell is a pass, which never helps either side;
+//   - one representative per class of cells lying in exactly the same live
+//     edges, since swapping such cells maps the game onto itself;
+//   - in decreasing order of potential contribution (the scaled potential a
+//     Breaker mark there would remove), ties broken by cell id.
+// An empty result means Maker can no longer complete any edge.
+//
+// A generator keeps its sort buffers between calls, so a search holding one
+// does not allocate per node once they have grown to the board's size.
+class MoveGenerator {
+public:
+    void generate(const IncrementalPotential& state, std::vector<int32_t>& moves);
+    
+    // One-off generation with fresh buffers
+    static std::vector<int32_t> generate(const IncrementalPotential& state);
+    
+private:
+    std::vector<std::pair<uint64_t, int32_t>> live_;     // (signature, cell) of live empty cells
+    std::vector<std::pair<int64_t, int32_t>> scored_;    // (-breaker gain, cell) of the representatives
+
+    static bool same_live_edges(const IncrementalPotential& state, int32_t a, int32_t b);
+};
+
+} // namespace game
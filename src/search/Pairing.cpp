@@ -0,0 +1,475 @@
+#include "search/Pairing.h"
+#include "util/Instrument.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace game {
+
+namespace {
+
+constexpr uint8_t kUnpaired = 0xFF;
+
+// Edges through one column. Window bit (c - col) * 4 + row addresses the
+// cells of columns [c - span, c]; the new column is bits 0-3.
+struct ColumnStep {
+    std::vector<uint32_t> masks;  // Active edges restricted to the window
+    std::vector<uint8_t> ends;    // Edge has no cells right of this column
+    size_t live_in = 0;           // Leading edges carried over from the previous column
+    std::vector<uint8_t> useful;  // [row * window_bits + bit]: pair lies inside some active edge
+};
+
+struct State {
+    uint32_t free = 0;      // Window cells (minus the oldest column) still unpaired
+    uint64_t covered = 0;   // Live edges that already contain a pair
+
+    bool operator==(const State& other) const { return free == other.free && covered == other.covered; }
+};
+
+struct StateHash {
+    size_t operator()(const State& s) const {
+        uint64_t h = s.covered * 0x9E3779B97F4A7C15ULL ^ s.free;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+struct Link {
+    State parent;
+    uint32_t choice;  // Byte r: window bit paired with new cell r, or kUnpaired
+};
+
+void finish_step(ColumnStep& step, int32_t span) {
+    if (step.masks.size() > 64) {
+        throw std::invalid_argument("More than 64 edges cross one column");
+    }
+    auto bits = static_cast<size_t>(4 * (span + 1));
+    step.useful.assign(4 * bits, 0);
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t w = 0; w < bits; ++w) {
+            uint32_t pair = (uint32_t{1} << r) | (uint32_t{1} << w);
+            for (uint32_t mask : step.masks) {
+                if (w != r && (mask & pair) == pair) step.useful[r * bits + w] = 1;
+            }
+        }
+    }
+}
+
+uint32_t window_mask(const Hyperedge& edge, int32_t col, int32_t span) {
+    uint32_t mask = 0;
+    for (const auto& cell : edge) {
+        int32_t age = col - cell.col;
+        if (age >= 0 && age <= span) mask |= uint32_t{1} << (age * 4 + cell.row);
+    }
+    return mask;
+}
+
+int32_t first_col(const Hyperedge& edge) {
+    int32_t col = edge.front().col;
+    for (const auto& cell : edge) col = std::min(col, cell.col);
+    return col;
+}
+
+int32_t last_col(const Hyperedge& edge) {
+    int32_t col = edge.front().col;
+    for (const auto& cell : edge) col = std::max(col, cell.col);
+    return col;
+}
+
+// Every way to pair the new column's cells; calls `emit` for each surviving successor
+void expand(const State& state, const ColumnStep& step, int32_t span,
+            const std::function<void(const State&, uint32_t)>& emit) {
+    auto bits = static_cast<size_t>(4 * (span + 1));
+    uint32_t window = (state.free << 4) | 0xF;
+    uint64_t covered = state.covered;
+
+    std::function<void(int32_t, uint32_t, uint64_t, uint32_t)> place =
+        [&](int32_t r, uint32_t free, uint64_t cov, uint32_t choice) {
+        if (r == 4) {
+            uint64_t next_covered = 0;
+            size_t out = 0;
+            for (size_t i = 0; i < step.masks.size(); ++i) {
+                bool has_pair = (cov >> i) & 1;
+                if (step.ends[i]) {
+                    if (!has_pair) return;
+                } else {
+                    next_covered |= static_cast<uint64_t>(has_pair) << out++;
+                }
+            }
+            uint32_t keep = (span == 0) ? 0 : (uint32_t{1} << (4 * span)) - 1;
+            emit(State{free & keep, next_covered}, choice);
+            return;
+        }
+        if (!(free & (uint32_t{1} << r))) {
+            place(r + 1, free, cov, choice);
+            return;
+        }
+        place(r + 1, free, cov, choice);
+        for (size_t w = 0; w < bits; ++w) {
+            // Pairs inside the new column are chosen by their lower cell
+            if (w < 4 && static_cast<int32_t>(w) <= r) continue;
+            if (!(free & (uint32_t{1} << w)) || !step.useful[static_cast<size_t>(r) * bits + w]) continue;
+            uint32_t pair = (uint32_t{1} << r) | (uint32_t{1} << w);
+            uint64_t next = cov;
+            for (size_t i = 0; i < step.masks.size(); ++i) {
+                if ((step.masks[i] & pair) == pair) next |= uint64_t{1} << i;
+            }
+            if (next == cov) continue;
+            uint32_t byte = static_cast<uint32_t>(w) << (8 * r);
+            place(r + 1, free & ~pair, next, (choice & ~(uint32_t{0xFF} << (8 * r))) | byte);
+        }
+    };
+    place(0, window, covered, 0xFFFFFFFFu);
+}
+
+std::pair<Cell, Cell> ordered_pair(Cell a, Cell b) {
+    if (b.col < a.col || (b.col == a.col && b.row < a.row)) std::swap(a, b);
+    return {a, b};
+}
+
+void append_pairs(uint32_t choice, int32_t col, std::vector<std::pair<Cell, Cell>>& pairs) {
+    for (int32_t r = 0; r < 4; ++r) {
+        uint32_t w = (choice >> (8 * r)) & 0xFF;
+        if (w == kUnpaired) continue;
+        Cell partner{static_cast<int32_t>(w % 4), col - static_cast<int32_t>(w / 4)};
+        pairs.push_back(ordered_pair(partner, Cell{r, col}));
+    }
+}
+
+double elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+Pairing Pairing::parse(const std::string& text) {
+    Pairing pairing;
+    bool have_header = false;
+    std::istringstream lines(text);
+    std::string line;
+    for (int32_t number = 1; std::getline(lines, line); ++number) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        if (!have_header) {
+            std::string word;
+            std::string kind;
+            if (!(iss >> word >> kind >> pairing.num_cols) || word != "pairing" ||
+                (kind != "width" && kind != "period") || pairing.num_cols <= 0) {
+                throw std::invalid_argument("Line " + std::to_string(number) +
+                                            ": expected \"pairing width N\" or \"pairing period P\"");
+            }
+            pairing.periodic = kind == "period";
+            have_header = true;
+            continue;
+        }
+        Cell a{};
+        Cell b{};
+        char comma1 = 0;
+        char comma2 = 0;
+        std::string rest;
+        if (!(iss >> a.row >> comma1 >> a.col >> b.row >> comma2 >> b.col) || comma1 != ',' || comma2 != ',' ||
+            (iss >> rest) || a.row < 0 || a.row >= 4 || b.row < 0 || b.row >= 4 || a.col < 0 || b.col < 0 ||
+            a == b) {
+            throw std::invalid_argument("Line " + std::to_string(number) + ": expected a pair \"r,c r,c\"");
+        }
+        pairing.pairs.push_back(ordered_pair(a, b));
+    }
+    if (!have_header) {
+        throw std::invalid_argument("Pairing file has no header");
+    }
+    return pairing;
+}
+
+std::string Pairing::format() const {
+    std::ostringstream oss;
+    oss << "pairing " << (periodic ? "period " : "width ") << num_cols << "\n";
+    for (const auto& [a, b] : pairs) {
+        oss << a.row << "," << a.col << " " << b.row << "," << b.col << "\n";
+    }
+    return oss.str();
+}
+
+std::vector<std::pair<Cell, Cell>> Pairing::expand(int32_t width) const {
+    std::vector<std::pair<Cell, Cell>> result;
+    for (const auto& [a, b] : pairs) {
+        int32_t step = periodic ? num_cols : 0;
+        int32_t first = periodic ? -(std::max(a.col, b.col) / step) - 1 : 0;
+        int32_t last = periodic ? width / step + 1 : 0;
+        for (int32_t k = first; k <= last; ++k) {
+            Cell x{a.row, a.col + k * step};
+            Cell y{b.row, b.col + k * step};
+            if (std::min(x.col, y.col) >= 0 && std::max(x.col, y.col) < width) {
+                result.push_back({x, y});
+            }
+        }
+    }
+
+    std::vector<uint8_t> used(static_cast<size_t>(4 * width), 0);
+    for (const auto& [a, b] : result) {
+        for (const Cell& cell : {a, b}) {
+            auto& slot = used[static_cast<size_t>(cell.row * width + cell.col)];
+            if (slot) {
+                throw std::invalid_argument("Pairing uses cell (" + std::to_string(cell.row) + "," +
+                                            std::to_string(cell.col) + ") twice");
+            }
+            slot = 1;
+        }
+    }
+    return result;
+}
+
+std::optional<Hyperedge> Pairing::find_uncovered(int32_t width, const std::vector<Hyperedge>& edges) const {
+    std::vector<int32_t> partner(static_cast<size_t>(4 * width), -1);
+    for (const auto& [a, b] : expand(width)) {
+        partner[static_cast<size_t>(a.row * width + a.col)] = b.row * width + b.col;
+        partner[static_cast<size_t>(b.row * width + b.col)] = a.row * width + a.col;
+    }
+    for (const auto& edge : edges) {
+        bool covered = false;
+        for (size_t i = 0; i < edge.size() && !covered; ++i) {
+            int32_t other = partner[static_cast<size_t>(edge[i].row * width + edge[i].col)];
+            for (size_t j = i + 1; j < edge.size() && !covered; ++j) {
+                covered = other == edge[j].row * width + edge[j].col;
+            }
+        }
+        if (!covered) return edge;
+    }
+    return std::nullopt;
+}
+
+PairingFinder::PairingFinder(PairingOptions options)
+    : options_(options) {
+    if (options.span < 0 || options.span > 6) {
+        throw std::invalid_argument("Pair span must be between 0 and 6 columns");
+    }
+}
+
+PairingResult PairingFinder::find(int32_t num_cols, const std::vector<Hyperedge>& edges) const {
+    GAME_SCOPE("PairingFinder::find");
+    auto start = std::chrono::steady_clock::now();
+    const int32_t span = options_.span;
+
+    // Edge lists per column, in the order the state's covered bits use
+    std::vector<std::vector<size_t>> starting(static_cast<size_t>(num_cols));
+    for (size_t e = 0; e < edges.size(); ++e) {
+        starting[static_cast<size_t>(first_col(edges[e]))].push_back(e);
+    }
+    std::vector<ColumnStep> steps(static_cast<size_t>(num_cols));
+    std::vector<size_t> live;
+    for (int32_t c = 0; c < num_cols; ++c) {
+        ColumnStep& step = steps[static_cast<size_t>(c)];
+        step.live_in = live.size();
+        std::vector<size_t> active = live;
+        active.insert(active.end(), starting[static_cast<size_t>(c)].begin(), starting[static_cast<size_t>(c)].end());
+        live.clear();
+        for (size_t e : active) {
+            bool ends = last_col(edges[e]) == c;
+            step.masks.push_back(window_mask(edges[e], c, span));
+            step.ends.push_back(ends ? 1 : 0);
+            if (!ends) live.push_back(e);
+        }
+        finish_step(step, span);
+    }
+
+    PairingResult result;
+    std::vector<std::unordered_map<State, Link, StateHash>> layers(static_cast<size_t>(num_cols));
+    std::unordered_map<State, Link, StateHash> initial{{State{}, Link{State{}, 0}}};
+    for (int32_t c = 0; c < num_cols; ++c) {
+        const auto& previous = c == 0 ? initial : layers[static_cast<size_t>(c - 1)];
+        auto& layer = layers[static_cast<size_t>(c)];
+        for (const auto& [state, link] : previous) {
+            expand(state, steps[static_cast<size_t>(c)], span, [&](const State& next, uint32_t choice) {
+                layer.emplace(next, Link{state, choice});
+            });
+        }
+        result.states += static_cast<int64_t>(layer.size());
+        if (layer.size() > options_.max_states) {
+            throw std::runtime_error("Pairing search exceeded " + std::to_string(options_.max_states) +
+                                     " states at column " + std::to_string(c));
+        }
+        if (layer.empty()) {
+            result.columns = c;
+            result.seconds = elapsed(start);
+            return result;
+        }
+    }
+    result.columns = num_cols;
+
+    Pairing pairing;
+    pairing.num_cols = num_cols;
+    State state = layers.back().begin()->first;
+    for (int32_t c = num_cols - 1; c >= 0; --c) {
+        const Link& link = layers[static_cast<size_t>(c)].at(state);
+        append_pairs(link.choice, c, pairing.pairs);
+        state = link.parent;
+    }
+    std::sort(pairing.pairs.begin(), pairing.pairs.end(), [](const auto& x, const auto& y) {
+        return std::make_pair(x.first.col, x.first.row) < std::make_pair(y.first.col, y.first.row);
+    });
+    result.pairing = std::move(pairing);
+    result.seconds = elapsed(start);
+    return result;
+}
+
+std::vector<Hyperedge> PairingFinder::strip_templates() {
+    // Far enough from both ends of the board that no edge is truncated
+    const int32_t margin = 7;
+    std::vector<Hyperedge> templates;
+    for (auto& edge : EdgeGenerator::generate_edges(3 * margin)) {
+        if (first_col(edge) != margin) continue;
+        for (auto& cell : edge) cell.col -= margin;
+        templates.push_back(std::move(edge));
+    }
+    return templates;
+}
+
+PairingResult PairingFinder::find_periodic(const std::vector<Hyperedge>& templates) const {
+    GAME_SCOPE("PairingFinder::find_periodic");
+    auto start = std::chrono::steady_clock::now();
+    const int32_t span = options_.span;
+    int32_t width = 1;
+    for (const auto& edge : templates) {
+        if (first_col(edge) != 0) {
+            throw std::invalid_argument("Edge templates must start at column 0");
+        }
+        width = std::max(width, last_col(edge) + 1);
+    }
+
+    // The step is the same at every column: active edges are the template
+    // translates that reach column 0, ordered by start
+    ColumnStep step;
+    for (int32_t s = 1 - width; s <= 0; ++s) {
+        for (const auto& edge : templates) {
+            int32_t last = s + last_col(edge);
+            if (last < 0) continue;
+            Hyperedge shifted = edge;
+            for (auto& cell : shifted) cell.col += s;
+            step.masks.push_back(window_mask(shifted, 0, span));
+            step.ends.push_back(last == 0 ? 1 : 0);
+            if (s < 0) ++step.live_in;
+        }
+    }
+    finish_step(step, span);
+
+    // Every state of a periodic pairing is reachable from the optimistic
+    // state: all window cells free and every live edge covered
+    State optimistic{(span == 0) ? 0 : (uint32_t{1} << (4 * span)) - 1,
+                     step.live_in == 64 ? ~uint64_t{0} : (uint64_t{1} << step.live_in) - 1};
+    std::vector<State> nodes{optimistic};
+    std::unordered_map<State, int32_t, StateHash> ids{{optimistic, 0}};
+    std::vector<std::vector<std::pair<int32_t, uint32_t>>> successors;
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        successors.emplace_back();
+        expand(nodes[v], step, span, [&](const State& next, uint32_t choice) {
+            auto [it, inserted] = ids.emplace(next, static_cast<int32_t>(nodes.size()));
+            if (inserted) nodes.push_back(next);
+            successors[v].push_back({it->second, choice});
+        });
+        if (nodes.size() > options_.max_states) {
+            throw std::runtime_error("Pairing search exceeded " + std::to_string(options_.max_states) + " states");
+        }
+    }
+
+    PairingResult result;
+    result.states = static_cast<int64_t>(nodes.size());
+
+    // Drop states without successors or predecessors until none remain
+    std::vector<uint8_t> alive(nodes.size(), 1);
+    std::vector<int32_t> in_degree(nodes.size(), 0);
+    std::vector<int32_t> out_degree(nodes.size(), 0);
+    std::vector<std::vector<int32_t>> predecessors(nodes.size());
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        for (const auto& [w, choice] : successors[v]) {
+            ++out_degree[v];
+            ++in_degree[static_cast<size_t>(w)];
+            predecessors[static_cast<size_t>(w)].push_back(static_cast<int32_t>(v));
+        }
+    }
+    std::vector<int32_t> dead;
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        if (in_degree[v] == 0 || out_degree[v] == 0) {
+            alive[v] = 0;
+            dead.push_back(static_cast<int32_t>(v));
+        }
+    }
+    while (!dead.empty()) {
+        auto v = static_cast<size_t>(dead.back());
+        dead.pop_back();
+        auto drop = [&](int32_t u, std::vector<int32_t>& degree) {
+            auto ui = static_cast<size_t>(u);
+            if (alive[ui] && --degree[ui] == 0) {
+                alive[ui] = 0;
+                dead.push_back(u);
+            }
+        };
+        for (const auto& [w, choice] : successors[v]) drop(w, in_degree);
+        for (int32_t u : predecessors[v]) drop(u, out_degree);
+    }
+
+    // Shortest cycle, by breadth-first search from each remaining state
+    std::vector<std::pair<int32_t, uint32_t>> cycle;  // (state, choice taken from it)
+    auto best = static_cast<int32_t>(nodes.size()) + 1;
+    std::vector<int32_t> depth(nodes.size(), -1);
+    std::vector<std::pair<int32_t, uint32_t>> parent(nodes.size());
+    for (size_t root = 0; root < nodes.size(); ++root) {
+        if (!alive[root]) continue;
+        std::fill(depth.begin(), depth.end(), -1);
+        std::deque<int32_t> queue{static_cast<int32_t>(root)};
+        depth[root] = 0;
+        bool found = false;
+        while (!queue.empty() && !found) {
+            int32_t v = queue.front();
+            queue.pop_front();
+            if (depth[static_cast<size_t>(v)] + 1 >= best) break;
+            for (const auto& [w, choice] : successors[static_cast<size_t>(v)]) {
+                auto wi = static_cast<size_t>(w);
+                if (!alive[wi]) continue;
+                if (wi == root) {
+                    best = depth[static_cast<size_t>(v)] + 1;
+                    cycle.clear();
+                    cycle.push_back({v, choice});
+                    for (int32_t u = v; u != static_cast<int32_t>(root); u = parent[static_cast<size_t>(u)].first) {
+                        cycle.push_back(parent[static_cast<size_t>(u)]);
+                    }
+                    std::reverse(cycle.begin(), cycle.end());
+                    found = true;
+                    break;
+                }
+                if (depth[wi] < 0) {
+                    depth[wi] = depth[static_cast<size_t>(v)] + 1;
+                    parent[wi] = {v, choice};
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+
+    if (!cycle.empty()) {
+        Pairing pairing;
+        pairing.periodic = true;
+        pairing.num_cols = best;
+        std::vector<std::pair<Cell, Cell>> pairs;
+        for (size_t c = 0; c < cycle.size(); ++c) {
+            append_pairs(cycle[c].second, static_cast<int32_t>(c), pairs);
+        }
+        // Shift each pair so its left cell lies in [0, period)
+        for (auto& [a, b] : pairs) {
+            int32_t shift = ((a.col % best) + best) % best - a.col;
+            a.col += shift;
+            b.col += shift;
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const auto& x, const auto& y) {
+            return std::make_pair(x.first.col, x.first.row) < std::make_pair(y.first.col, y.first.row);
+        });
+        pairing.pairs = std::move(pairs);
+        result.pairing = std::move(pairing);
+        result.period = best;
+    }
+    result.seconds = elapsed(start);
+    return result;
+}
+
+} // namespace game
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+// Breaker pairing strategy: disjoint cell pairs such that every edge contains
+// a whole pair. Breaker answers Maker's move in a pair with its partner, so
+// Maker never completes an edge.
+//
+// A width pairing lists every pair of a 4 x n board. A periodic pairing
+// lists the pairs whose left cell lies in columns [0, period); the pairing of
+// the strip is their translates by multiples of the period.
+struct Pairing {
+    int32_t num_cols = 0;  // Width, or period when `periodic`
+    bool periodic = false;
+    std::vector<std::pair<Cell, Cell>> pairs;
+
+    // Text form: "pairing width N" or "pairing period P", then one
+    // "r,c r,c" pair per line. Lines starting with '#' are comments.
+    static Pairing parse(const std::string& text);
+    std::string format() const;
+
+    // Pairs that lie on a 4 x num_cols board; periodic pairs are translated
+    // and those crossing the boundary dropped. Throws if pairs overlap.
+    std::vector<std::pair<Cell, Cell>> expand(int32_t num_cols) const;
+
+    // First edge of `edges` (a 4 x num_cols board) without a whole pair
+    std::optional<Hyperedge> find_uncovered(int32_t num_cols, const std::vector<Hyperedge>& edges) const;
+};
+
+struct PairingOptions {
+    int32_t span = 6;               // Maximum column distance between paired cells
+    size_t max_states = size_t{1} << 22;
+};
+
+struct PairingResult {
+    std::optional<Pairing> pairing;
+    int32_t columns = 0;    // Width mode: columns processed before every state failed
+    int64_t states = 0;     // States generated
+    int32_t period = 0;     // Periodic mode: period of the pairing found
+    double seconds = 0.0;
+};
+
+// Transfer-matrix search over columns. After column c the state is the set
+// of cells in the last `span` columns still free to pair, plus which edges
+// crossing into column c+1 already contain a pair. A new column chooses
+// pairs for its four cells against free cells in the window; an edge that
+// ends at c without a pair kills the state. Only pairs that put a pair into
+// an edge without one are tried: dropping any other pair leaves a state
+// with more free cells and the same covered edges.
+class PairingFinder {
+public:
+    explicit PairingFinder(PairingOptions options);
+
+    // Pairing of the 4 x num_cols board for `edges`, or none
+    PairingResult find(int32_t num_cols, const std::vector<Hyperedge>& edges) const;
+
+    // Pairing of the infinite strip whose edges are the translates of
+    // `templates` (edges starting at column 0) to every column. The search
+    // only keeps pairs that cover a new edge, which preserves whether an
+    // infinite pairing exists; a cycle in the reduced transfer graph is then
+    // a periodic one, and the shortest cycle is returned. No cycle proves
+    // that no pairing of any period exists for this span.
+    PairingResult find_periodic(const std::vector<Hyperedge>& templates) const;
+
+    // Interior edges of EdgeGenerator starting at column 0
+    static std::vector<Hyperedge> strip_templates();
+
+private:
+    PairingOptions options_;
+};
+
+} // namespace game
@@ -0,0 +1,241 @@
+#include "search/Perft.h"
+#include "metrics/IncrementalPotential.h"
+#include "util/Instrument.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace game {
+
+namespace {
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// One random key per (cell, mark); a position's key is the XOR over its marks
+class Zobrist {
+public:
+    explicit Zobrist(int32_t num_cells) {
+        uint64_t state = 0x5EED;
+        keys_.resize(static_cast<size_t>(num_cells) * 2);
+        for (auto& key : keys_) {
+            key = splitmix64(state);
+        }
+    }
+
+    uint64_t key(int32_t cell, CellState mark) const {
+        return keys_[static_cast<size_t>(cell) * 2 + (mark == CellState::Maker ? 0 : 1)];
+    }
+
+private:
+    std::vector<uint64_t> keys_;
+};
+
+// Set of position keys sharded by the top key bits, so threads flushing
+// different shards do not contend
+class KeySet {
+public:
+    static constexpr size_t kShards = 64;
+
+    // Inserts and clears `keys`
+    void insert(std::vector<uint64_t>& keys) {
+        std::sort(keys.begin(), keys.end());
+        for (size_t begin = 0; begin < keys.size();) {
+            size_t shard = keys[begin] >> 58;
+            size_t end = begin;
+            while (end < keys.size() && (keys[end] >> 58) == shard) ++end;
+            std::lock_guard<std::mutex> lock(shards_[shard].mutex);
+            shards_[shard].keys.insert(keys.begin() + static_cast<std::ptrdiff_t>(begin),
+                                       keys.begin() + static_cast<std::ptrdiff_t>(end));
+            begin = end;
+        }
+        keys.clear();
+    }
+
+    int64_t size() const {
+        int64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += static_cast<int64_t>(shard.keys.size());
+        }
+        return total;
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<uint64_t> keys;
+    };
+    std::array<Shard, kShards> shards_;
+};
+
+constexpr size_t kFlushKeys = size_t{1} << 12;
+
+// Per-thread depth-first walker over its own copy of the start position
+class Walker {
+public:
+    Walker(const Game& start, const PerftOptions& options, const Zobrist& zobrist, uint64_t start_key,
+           std::vector<std::unique_ptr<KeySet>>& sets)
+        : game_(start)
+        , options_(options)
+        , zobrist_(zobrist)
+        , key_(start_key)
+        , sets_(sets)
+        , counts_(static_cast<size_t>(options.depth) + 1)
+        , pending_(static_cast<size_t>(options.depth) + 1) {
+        if (options.stop_at_certificate) {
+            potential_.emplace(start.board(), start.index());
+        }
+    }
+
+    const std::vector<PerftPly>& counts() const { return counts_; }
+
+    void visit(const Cell& cell, int32_t ply) {
+        CellState mark = (game_.current_player() == Player::Maker) ? CellState::Maker : CellState::Breaker;
+        bool won = game_.make_move(cell).maker_wins;
+        if (potential_) potential_->place(cell, mark);
+        int32_t id = cell.row * game_.board().cols() + cell.col;
+        key_ ^= zobrist_.key(id, mark);
+
+        PerftPly& counts = counts_[static_cast<size_t>(ply)];
+        ++counts.sequences;
+        if (options_.count_distinct) {
+            auto& pending = pending_[static_cast<size_t>(ply)];
+            pending.push_back(key_);
+            if (pending.size() >= kFlushKeys) sets_[static_cast<size_t>(ply)]->insert(pending);
+        }
+
+        if (won) {
+            ++counts.maker_wins;
+        } else if (potential_ && game_.current_player() == Player::Breaker &&
+                   potential_->has_breaker_certificate()) {
+            ++counts.certificates;
+        } else if (ply < options_.depth) {
+            const Board& board = game_.board();
+            for (int32_t r = 0; r < board.rows(); ++r) {
+                for (int32_t c = 0; c < board.cols(); ++c) {
+                    if (board.is_empty(r, c)) visit({r, c}, ply + 1);
+                }
+            }
+        }
+
+        key_ ^= zobrist_.key(id, mark);
+        if (potential_) potential_->undo();
+        game_.undo_move();
+    }
+
+    void flush() {
+        for (size_t ply = 0; ply < pending_.size(); ++ply) {
+            if (!pending_[ply].empty()) sets_[ply]->insert(pending_[ply]);
+        }
+    }
+
+private:
+    Game game_;
+    const PerftOptions& options_;
+    const Zobrist& zobrist_;
+    uint64_t key_;
+    std::vector<std::unique_ptr<KeySet>>& sets_;
+    std::optional<IncrementalPotential> potential_;
+    std::vector<PerftPly> counts_;
+    std::vector<std::vector<uint64_t>> pending_;
+};
+
+} // namespace
+
+Perft::Perft(const Game& start, PerftOptions options)
+    : start_(start)
+    , options_(options) {
+    if (options.depth < 0) {
+        throw std::invalid_argument("Perft depth must be non-negative");
+    }
+    if (options.threads <= 0) {
+        throw std::invalid_argument("Thread count must be positive");
+    }
+}
+
+PerftResult Perft::run() {
+    GAME_SCOPE("Perft::run");
+    auto start = std::chrono::steady_clock::now();
+    const Board& board = start_.board();
+    Zobrist zobrist(board.rows() * board.cols());
+
+    uint64_t start_key = 0;
+    std::vector<Cell> root_moves;
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < board.cols(); ++c) {
+            CellState state = board.get(r, c);
+            if (state == CellState::Empty) {
+                root_moves.push_back({r, c});
+            } else {
+                start_key ^= zobrist.key(r * board.cols() + c, state);
+            }
+        }
+    }
+
+    PerftResult result;
+    result.plies.resize(static_cast<size_t>(options_.depth) + 1);
+    result.plies[0].sequences = 1;
+    result.plies[0].distinct = 1;
+
+    // The start position may already be terminal
+    bool terminal = start_.check_maker_win();
+    if (options_.stop_at_certificate && start_.current_player() == Player::Breaker) {
+        terminal = terminal || IncrementalPotential(board, start_.index()).has_breaker_certificate();
+    }
+    if (terminal || options_.depth == 0) {
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    std::vector<std::unique_ptr<KeySet>> sets;
+    for (int32_t ply = 0; ply <= options_.depth; ++ply) {
+        sets.push_back(std::make_unique<KeySet>());
+    }
+
+    std::atomic<size_t> next{0};
+    std::mutex merge_mutex;
+    auto run = [&] {
+        Walker walker(start_, options_, zobrist, start_key, sets);
+        for (size_t i = next.fetch_add(1); i < root_moves.size(); i = next.fetch_add(1)) {
+            walker.visit(root_moves[i], 1);
+        }
+        walker.flush();
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (size_t ply = 1; ply < result.plies.size(); ++ply) {
+            const PerftPly& counts = walker.counts()[ply];
+            result.plies[ply].sequences += counts.sequences;
+            result.plies[ply].maker_wins += counts.maker_wins;
+            result.plies[ply].certificates += counts.certificates;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    int32_t threads = std::min<int32_t>(options_.threads, static_cast<int32_t>(root_moves.size()));
+    for (int32_t t = 1; t < threads; ++t) {
+        pool.emplace_back(run);
+    }
+    run();
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    for (size_t ply = 1; ply < result.plies.size(); ++ply) {
+        result.plies[ply].distinct = options_.count_distinct ? sets[ply]->size() : 0;
+        result.nodes += result.plies[ply].sequences;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+} // namespace game
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/Game.h"
+#include <cstdint>
+#include <vector>
+
+namespace game {
+
+struct PerftOptions {
+    int32_t depth = 4;
+    bool stop_at_certificate = false;  // Treat pot(b) < 1 on Breaker's turn as terminal
+    bool count_distinct = true;        // Hash every node; costs memory per distinct position
+    int32_t threads = 1;
+};
+
+// Counts per ply below the start position; index 0 is the start itself
+struct PerftPly {
+    int64_t sequences = 0;             // Move sequences reaching this ply
+    int64_t distinct = 0;              // Distinct positions among them
+    int64_t maker_wins = 0;            // Sequences ending here with a Maker win
+    int64_t certificates = 0;          // Sequences stopped here by pot(b) < 1
+};
+
+struct PerftResult {
+    std::vector<PerftPly> plies;
+    int64_t nodes = 0;                 // Sum of sequences over plies 1..depth
+    double seconds = 0.0;
+};
+
+// Reachable-position enumerator in the style of chess perft.
+//
+// Every legal move (every empty cell) is played with Game::make_move and
+// taken back with Game::undo_move, depth first. A sequence ends early when
+// Maker completes an edge, the board is full, or, with stop_at_certificate,
+// pot(b) < 1 on Breaker's turn. Distinct positions are counted through
+// 64-bit Zobrist keys in per-ply sets. The root moves are shared out to the
+// threads one at a time, each thread working on its own Game copy.
+class Perft {
+public:
+    Perft(const Game& start, PerftOptions options);
+
+    PerftResult run();
+
+private:
+    Game start_;
+    PerftOptions options_;
+};
+
+} // namespace game
@@ -0,0 +1,438 @@
+#include "search/ProofNumber.h"
+#include "util/Position.h"
+#include "util/Resource.h"
+#include "util/Instrument.h"
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+namespace game {
+
+namespace {
+
+constexpr uint32_t kInfinity = 0xFFFFFFFFu;
+
+Player opponent(Player p) {
+    return p == Player::Maker ? Player::Breaker : Player::Maker;
+}
+
+CellState mark_of(Player p) {
+    return p == Player::Maker ? CellState::Maker : CellState::Breaker;
+}
+
+uint32_t saturating_add(uint32_t a, uint32_t b) {
+    if (a == kInfinity || b == kInfinity) return kInfinity;
+    uint64_t sum = uint64_t{a} + b;
+    return sum >= kInfinity ? kInfinity - 1 : static_cast<uint32_t>(sum);
+}
+
+void set_leaf(PnNode& node, const IncrementalPotential& state, Player to_move, const Tablebase* tablebase) {
+    const Board& board = state.board();
+    std::optional<bool> known;
+    if (state.maker_won()) {
+        known = true;
+    } else if (state.num_empty() == 0 || (to_move == Player::Breaker && state.has_breaker_certificate())) {
+        known = false;
+    } else if (tablebase && board.rows() * board.cols() - state.num_empty() >= tablebase->first_layer()) {
+        known = tablebase->probe(board, to_move);
+    }
+    node.proof = known ? (*known ? 0 : kInfinity) : 1;
+    node.disproof = known ? (*known ? kInfinity : 0) : 1;
+}
+
+bool is_solved(const PnNode& node) {
+    return node.proof == 0 || node.disproof == 0;
+}
+
+} // namespace
+
+PnArena::PnArena(size_t capacity)
+    : capacity_(std::min<size_t>(capacity, kNone))
+    , in_use_(0) {
+    // Reserve address space only; pages are touched as the tree grows
+    nodes_.reserve(capacity_);
+}
+
+uint32_t PnArena::allocate(uint16_t count) {
+    if (count < free_blocks_.size() && !free_blocks_[count].empty()) {
+        uint32_t first = free_blocks_[count].back();
+        free_blocks_[count].pop_back();
+        in_use_ += count;
+        return first;
+    }
+    if (nodes_.size() + count <= capacity_) {
+        auto first = static_cast<uint32_t>(nodes_.size());
+        nodes_.resize(nodes_.size() + count);
+        in_use_ += count;
+        return first;
+    }
+    // Split the smallest larger free block
+    for (size_t size = size_t{count} + 1; size < free_blocks_.size(); ++size) {
+        if (free_blocks_[size].empty()) continue;
+        uint32_t first = free_blocks_[size].back();
+        free_blocks_[size].pop_back();
+        free_blocks_[size - count].push_back(first + count);
+        in_use_ += count;
+        return first;
+    }
+    return kNone;
+}
+
+void PnArena::release(uint32_t first, uint16_t count) {
+    if (count >= free_blocks_.size()) {
+        free_blocks_.resize(size_t{count} + 1);
+    }
+    free_blocks_[count].push_back(first);
+    in_use_ -= count;
+}
+
+std::vector<uint32_t> PnArena::compact(const std::vector<std::pair<uint32_t, uint16_t>>& blocks) {
+    // Blocks only move down, so copying in address order never overwrites a live node
+    std::vector<uint32_t> moved;
+    moved.reserve(blocks.size());
+    uint32_t top = 0;
+    for (const auto& [first, count] : blocks) {
+        if (first != top) {
+            std::copy(nodes_.begin() + first, nodes_.begin() + first + count, nodes_.begin() + top);
+        }
+        moved.push_back(top);
+        top += count;
+    }
+    nodes_.resize(top);
+    free_blocks_.clear();
+    in_use_ = top;
+    return moved;
+}
+
+void PnArena::save(CheckpointBuffer& out) const {
+    out.put(static_cast<uint64_t>(nodes_.size()));
+    out.put_bytes(nodes_.data(), nodes_.size() * sizeof(PnNode));
+    out.put(static_cast<uint64_t>(in_use_));
+    out.put(static_cast<uint64_t>(free_blocks_.size()));
+    for (const auto& blocks : free_blocks_) {
+        out.put(static_cast<uint64_t>(blocks.size()));
+        out.put_bytes(blocks.data(), blocks.size() * sizeof(uint32_t));
+    }
+}
+
+void PnArena::load(CheckpointReader& in) {
+    auto size = in.get<uint64_t>();
+    if (size > capacity_) {
+        throw std::runtime_error("Checkpointed node arena exceeds the memory limit");
+    }
+    nodes_.resize(static_cast<size_t>(size));
+    in.get_bytes(nodes_.data(), nodes_.size() * sizeof(PnNode));
+    in_use_ = static_cast<size_t>(in.get<uint64_t>());
+    free_blocks_.resize(static_cast<size_t>(in.get<uint64_t>()));
+    for (auto& blocks : free_blocks_) {
+        blocks.resize(static_cast<size_t>(in.get<uint64_t>()));
+        in.get_bytes(blocks.data(), blocks.size() * sizeof(uint32_t));
+    }
+}
+
+ProofNumberSearch::ProofNumberSearch(const Board& board, const std::vector<Hyperedge>& edges,
+                                     Player to_move, PnOptions options)
+    : ProofNumberSearch(board, std::make_shared<const EdgeIndex>(board.cols(), edges, board.rows()), to_move,
+                        std::move(options)) {}
+
+ProofNumberSearch::ProofNumberSearch(const Board& board, std::shared_ptr<const EdgeIndex> index,
+                                     Player to_move, PnOptions options)
+    : state_(board, std::move(index))
+    , to_move_(to_move)
+    , options_(options)
+    , arena_(options.memory_limit_bytes / sizeof(PnNode)) {
+    if (state_.index().num_cells() > 0xFFFF) {
+        throw std::invalid_argument("Board too large for 16-bit cell ids");
+    }
+    if (arena_.capacity() < 2) {
+        throw std::invalid_argument("Memory limit too small for the node arena");
+    }
+}
+
+PnResult ProofNumberSearch::solve() {
+    GAME_SCOPE("ProofNumberSearch::solve");
+    auto start = std::chrono::steady_clock::now();
+    stats_ = PnResult{};
+    stats_.bytes_per_node = sizeof(PnNode);
+
+    // Identifies the search a checkpoint belongs to; the budget may differ
+    const CheckpointOptions& checkpoint = options_.checkpoint;
+    CheckpointBuffer identity;
+    std::string position = PositionCodec::format(state_.board(), to_move_);
+    identity.put(static_cast<uint64_t>(position.size()));
+    identity.put_bytes(position.data(), position.size());
+    identity.put(static_cast<uint64_t>(state_.index().num_edges()));
+    identity.put(static_cast<uint64_t>(arena_.capacity()));
+    std::optional<std::string> payload;
+    if (checkpoint.resume && !checkpoint.path.empty()) {
+        payload = Checkpoint::read(checkpoint.path, CheckpointKind::ProofNumber);
+    }
+
+    // The root stays at id 0: it is allocated first and compaction keeps it there
+    uint32_t root = 0;
+    if (payload) {
+        CheckpointReader in(*payload);
+        std::string saved(identity.data().size(), '\0');
+        in.get_bytes(saved.data(), saved.size());
+        if (saved != identity.data()) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " is for another position or memory limit");
+        }
+        stats_.expansions = in.get<int64_t>();
+        stats_.gc_runs = in.get<int64_t>();
+        stats_.nodes_collected = in.get<int64_t>();
+        stats_.peak_nodes = in.get<int64_t>();
+        arena_.load(in);
+        if (arena_.in_use() == 0) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " has no root node");
+        }
+    } else {
+        root = arena_.allocate(1);
+        arena_[root] = {1, 1, PnArena::kNone, 0, 0};
+        set_leaf(arena_[root], state_, to_move_, options_.tablebase);
+    }
+
+    // Taken between expansions, when only the arena and counters hold state
+    auto snapshot = [&] {
+        CheckpointBuffer out;
+        out.put_bytes(identity.data().data(), identity.data().size());
+        out.put(stats_.expansions);
+        out.put(stats_.gc_runs);
+        out.put(stats_.nodes_collected);
+        out.put(stats_.peak_nodes);
+        arena_.save(out);
+        return std::move(out.data());
+    };
+    std::optional<CheckpointWriter> writer;
+    if (!checkpoint.path.empty()) {
+        writer.emplace(checkpoint.path, CheckpointKind::ProofNumber);
+    }
+    CheckpointTimer timer(checkpoint.interval_seconds);
+
+    while (!is_solved(arena_[root])) {
+        if (options_.max_expansions > 0 && stats_.expansions >= options_.max_expansions) {
+            break;
+        }
+
+        // Descend to the most-proving node
+        path_.assign(1, root);
+        Player player = to_move_;
+        while (arena_[path_.back()].first_child != PnArena::kNone) {
+            const PnNode& node = arena_[path_.back()];
+            uint32_t best = node.first_child;
+            for (uint32_t c = node.first_child; c < node.first_child + node.num_children; ++c) {
+                bool better = (player == Player::Maker) ? arena_[c].proof < arena_[best].proof
+                                                        : arena_[c].disproof < arena_[best].disproof;
+                if (better) best = c;
+            }
+            state_.place(arena_[best].cell, mark_of(player));
+            player = opponent(player);
+            path_.push_back(best);
+        }
+
+        bool expanded = expand(path_.back(), player);
+        if (!expanded) {
+            collect_garbage();
+            expanded = expand(path_.back(), player);
+        }
+        if (expanded) {
+            ++stats_.expansions;
+            stats_.peak_nodes = std::max(stats_.peak_nodes, static_cast<int64_t>(arena_.in_use()));
+            for (size_t i = path_.size(); i-- > 0;) {
+                update(path_[i], (i % 2 == 0) ? to_move_ : opponent(to_move_));
+            }
+        }
+
+        for (size_t i = 1; i < path_.size(); ++i) {
+            state_.undo();
+        }
+        if (!expanded) {
+            break;
+        }
+        if (checkpoint.on_unit) checkpoint.on_unit();
+        if (writer && checkpoint.stop && checkpoint.stop->load(std::memory_order_relaxed)) {
+            writer->submit(snapshot());
+            writer->flush();
+            throw CheckpointInterrupted(checkpoint.path);
+        }
+        if (writer && timer.claim()) {
+            writer->submit(snapshot());
+        }
+    }
+
+    const PnNode& result = arena_[root];
+    if (result.proof == 0) {
+        stats_.value = PnValue::Proved;
+    } else if (result.disproof == 0) {
+        stats_.value = PnValue::Disproved;
+    }
+    if (writer) {
+        // An unsolved search keeps its checkpoint to continue with a larger budget
+        if (stats_.value == PnValue::Unknown) {
+            writer->submit(snapshot());
+        }
+        writer->flush();
+        writer.reset();
+        if (stats_.value != PnValue::Unknown) {
+            Checkpoint::remove(checkpoint.path);
+        }
+    }
+    stats_.peak_rss_bytes = peak_rss_bytes();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats_;
+}
+
+bool ProofNumberSearch::expand(uint32_t id, Player to_move) {
+    GAME_SCOPE("ProofNumberSearch::expand");
+    generator_.generate(state_, moves_);
+    if (moves_.empty()) {
+        // No live cell left: Maker cannot complete any edge
+        arena_[id].proof = kInfinity;
+        arena_[id].disproof = 0;
+        return true;
+    }
+
+    auto count = static_cast<uint16_t>(moves_.size());
+    uint32_t first = arena_.allocate(count);
+    if (first == PnArena::kNone) {
+        return false;
+    }
+    for (uint16_t i = 0; i < count; ++i) {
+        PnNode& child = arena_[first + i];
+        child = {1, 1, PnArena::kNone, 0, static_cast<uint16_t>(moves_[i])};
+        state_.place(moves_[i], mark_of(to_move));
+        set_leaf(child, state_, opponent(to_move), options_.tablebase);
+        state_.undo();
+    }
+    arena_[id].first_child = first;
+    arena_[id].num_children = count;
+    return true;
+}
+
+void ProofNumberSearch::update(uint32_t id, Player to_move) {
+    PnNode& node = arena_[id];
+    if (node.first_child == PnArena::kNone) {
+        return;
+    }
+    // OR node for Maker, AND node for Breaker
+    uint32_t min_value = kInfinity;
+    uint32_t sum = 0;
+    for (uint32_t c = node.first_child; c < node.first_child + node.num_children; ++c) {
+        const PnNode& child = arena_[c];
+        uint32_t minimized = (to_move == Player::Maker) ? child.proof : child.disproof;
+        uint32_t summed = (to_move == Player::Maker) ? child.disproof : child.proof;
+        min_value = std::min(min_value, minimized);
+        sum = saturating_add(sum, summed);
+    }
+    if (to_move == Player::Maker) {
+        node.proof = min_value;
+        node.disproof = sum;
+    } else {
+        node.proof = sum;
+        node.disproof = min_value;
+    }
+}
+
+void ProofNumberSearch::collect_garbage() {
+    ++stats_.gc_runs;
+    size_t target = arena_.capacity() - arena_.capacity() / 4;
+
+    // Pass 1: subtrees below solved nodes are never visited again
+    std::vector<uint32_t> stack(1, path_.front());
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        const PnNode& node = arena_[id];
+        if (node.first_child == PnArena::kNone) continue;
+        if (is_solved(node)) {
+            free_subtree(id);
+            continue;
+        }
+        for (uint32_t c = node.first_child; c < node.first_child + node.num_children; ++c) {
+            stack.push_back(c);
+        }
+    }
+    if (arena_.in_use() <= target) {
+        compact();
+        return;
+    }
+
+    // Pass 2: cut unsolved subtrees off the current path, deepest first. Deep
+    // subtrees are the cheapest to rebuild; among equals the largest
+    // min(proof, disproof) is the least likely to be selected again soon.
+    std::vector<uint32_t> on_path(path_.begin(), path_.end());
+    std::sort(on_path.begin(), on_path.end());
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> candidates;  // (depth, min pn/dn, id)
+    std::vector<std::pair<uint32_t, uint32_t>> walk(1, {path_.front(), 0});
+    while (!walk.empty()) {
+        auto [id, depth] = walk.back();
+        walk.pop_back();
+        const PnNode& node = arena_[id];
+        if (node.first_child == PnArena::kNone) continue;
+        if (!std::binary_search(on_path.begin(), on_path.end(), id)) {
+            candidates.push_back({depth, std::min(node.proof, node.disproof), id});
+        }
+        for (uint32_t c = node.first_child; c < node.first_child + node.num_children; ++c) {
+            walk.push_back({c, depth + 1});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) > std::get<0>(b);
+        if (std::get<1>(a) != std::get<1>(b)) return std::get<1>(a) > std::get<1>(b);
+        return std::get<2>(a) < std::get<2>(b);
+    });
+    for (const auto& candidate : candidates) {
+        if (arena_.in_use() <= target) break;
+        free_subtree(std::get<2>(candidate));
+    }
+    compact();
+}
+
+void ProofNumberSearch::compact() {
+    // Live blocks: the root plus every expanded node's children
+    std::vector<std::pair<uint32_t, uint16_t>> blocks(1, {path_.front(), 1});
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        for (uint32_t id = blocks[b].first; id < blocks[b].first + blocks[b].second; ++id) {
+            const PnNode& node = arena_[id];
+            if (node.first_child != PnArena::kNone) {
+                blocks.push_back({node.first_child, node.num_children});
+            }
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+    std::vector<uint32_t> moved = arena_.compact(blocks);
+    
+    auto relocate = [&](uint32_t id) {
+        auto it = std::upper_bound(blocks.begin(), blocks.end(), std::pair<uint32_t, uint16_t>{id, 0xFFFF}) - 1;
+        return moved[static_cast<size_t>(it - blocks.begin())] + (id - it->first);
+    };
+    for (uint32_t id = 0; id < arena_.in_use(); ++id) {
+        PnNode& node = arena_[id];
+        if (node.first_child != PnArena::kNone) {
+            node.first_child = relocate(node.first_child);
+        }
+    }
+    for (auto& id : path_) {
+        id = relocate(id);
+    }
+}
+
+void ProofNumberSearch::free_subtree(uint32_t id) {
+    // Keeps the node itself with its proof and disproof numbers
+    PnNode& node = arena_[id];
+    if (node.first_child == PnArena::kNone) {
+        return;
+    }
+    uint32_t first = node.first_child;
+    uint16_t count = node.num_children;
+    node.first_child = PnArena::kNone;
+    node.num_children = 0;
+    for (uint32_t c = first; c < first + count; ++c) {
+        free_subtree(c);
+    }
+    arena_.release(first, count);
+    stats_.nodes_collected += count;
+}
+
+} // namespace game
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/IncrementalPotential.h"
+#include "search/MoveGenerator.h"
+#include "search/Tablebase.h"
+#include "util/Checkpoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+enum class PnValue : uint8_t {
+    Unknown = 0,
+    Proved = 1,    // Maker wins
+    Disproved = 2  // Breaker wins
+};
+
+struct PnOptions {
+    int64_t max_expansions = 0;                 // 0 means until solved
+    size_t memory_limit_bytes = size_t{256} << 20;  // Node arena cap
+    CheckpointOptions checkpoint;               // Units are expansions
+    const Tablebase* tablebase = nullptr;       // Exact leaf values where it covers the board
+};
+
+struct PnResult {
+    PnValue value = PnValue::Unknown;
+    int64_t expansions = 0;
+    int64_t gc_runs = 0;
+    int64_t nodes_collected = 0;
+    int64_t peak_nodes = 0;
+    size_t bytes_per_node = 0;
+    size_t peak_rss_bytes = 0;
+    double seconds = 0.0;
+};
+
+// A proof-number search tree node. Children of a node occupy one
+// contiguous block of the arena, addressed by a 32-bit index.
+struct PnNode {
+    uint32_t proof;
+    uint32_t disproof;
+    uint32_t first_child;
+    uint16_t num_children;
+    uint16_t cell;
+};
+
+// Contiguous node store with per-size free lists for child blocks.
+// Garbage collection compacts it so free space is never fragmented.
+class PnArena {
+public:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    explicit PnArena(size_t capacity);
+
+    PnNode& operator[](uint32_t id) { return nodes_[id]; }
+    const PnNode& operator[](uint32_t id) const { return nodes_[id]; }
+
+    // First id of a block of `count` nodes, or kNone when the arena is full
+    uint32_t allocate(uint16_t count);
+    void release(uint32_t first, uint16_t count);
+
+    // Slide the given live blocks, sorted by address, down to the start of
+    // the arena and drop the free lists. Returns each block's new first id;
+    // the caller rewrites child indices.
+    std::vector<uint32_t> compact(const std::vector<std::pair<uint32_t, uint16_t>>& blocks);
+
+    size_t capacity() const { return capacity_; }
+    size_t in_use() const { return in_use_; }
+
+    // Nodes and free lists, for checkpoints; load() throws if the saved
+    // arena does not fit this one
+    void save(CheckpointBuffer& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    std::vector<PnNode> nodes_;
+    size_t capacity_;
+    size_t in_use_;
+    std::vector<std::vector<uint32_t>> free_blocks_;
+};
+
+// Best-first proof-number search: does Maker win from the given position?
+//
+// OR nodes are Maker to move, AND nodes Breaker to move. Leaves are proved
+// when Maker completes an edge and disproved on a full board, when no live
+// cell is left, or when pot(b) < 1 on Breaker's turn. Children come from
+// MoveGenerator. When the arena is full, the subtrees below solved nodes are
+// freed first; if that is not enough, unsolved subtrees off the current path
+// are cut back to leaves, deepest and largest min(proof, disproof) first.
+// Cut nodes keep their numbers and are re-expanded on demand, as in PN^2.
+// The surviving nodes are then slid together so free space stays contiguous.
+//
+// With a checkpoint path, the arena and counters are saved between
+// expansions. A run that ends on its expansion budget keeps its checkpoint,
+// so a resumed run with a larger budget carries on the same search.
+class ProofNumberSearch {
+public:
+    ProofNumberSearch(const Board& board, const std::vector<Hyperedge>& edges, Player to_move,
+                      PnOptions options);
+    ProofNumberSearch(const Board& board, std::shared_ptr<const EdgeIndex> index, Player to_move,
+                      PnOptions options);
+
+    PnResult solve();
+
+private:
+    IncrementalPotential state_;
+    Player to_move_;
+    PnOptions options_;
+    PnArena arena_;
+    PnResult stats_;
+    std::vector<uint32_t> path_;
+    std::vector<int32_t> moves_;
+    MoveGenerator generator_;
+
+    bool expand(uint32_t id, Player to_move);
+    void update(uint32_t id, Player to_move);
+    void collect_garbage();
+    void free_subtree(uint32_t id);
+    void compact();
+};
+
+} // namespace game
@@ -0,0 +1,493 @@
+#include "search/Tablebase.h"
+#include "util/Checkpoint.h"
+#include "util/Instrument.h"
+#include "util/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace game {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "Tablebase words are stored in host byte order");
+
+constexpr uint64_t kBlockPositions = uint64_t{1} << 14;  // Multiple of 64: blocks never share a word
+
+uint32_t permute(const std::vector<int32_t>& perm, uint32_t mask) {
+    uint32_t out = 0;
+    for (uint32_t bits = mask; bits != 0; bits &= bits - 1) {
+        out |= uint32_t{1} << perm[static_cast<size_t>(std::countr_zero(bits))];
+    }
+    return out;
+}
+
+uint32_t edge_mask(const Hyperedge& edge, int32_t num_cols) {
+    uint32_t mask = 0;
+    for (const auto& cell : edge) {
+        mask |= uint32_t{1} << (cell.row * num_cols + cell.col);
+    }
+    return mask;
+}
+
+// Non-identity cell permutations (row flip, column mirror, both) that map the edge set onto itself
+std::vector<std::vector<int32_t>> edge_symmetries(int32_t num_cols, const std::vector<uint32_t>& edges) {
+    std::vector<uint32_t> sorted(edges);
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<std::vector<int32_t>> result;
+    for (int32_t s = 1; s < 4; ++s) {
+        std::vector<int32_t> perm(static_cast<size_t>(4 * num_cols));
+        for (int32_t r = 0; r < 4; ++r) {
+            for (int32_t c = 0; c < num_cols; ++c) {
+                int32_t row = (s & 1) ? 3 - r : r;
+                int32_t col = (s & 2) ? num_cols - 1 - c : c;
+                perm[static_cast<size_t>(r * num_cols + c)] = row * num_cols + col;
+            }
+        }
+        std::vector<uint32_t> mapped;
+        for (uint32_t mask : edges) {
+            mapped.push_back(permute(perm, mask));
+        }
+        std::sort(mapped.begin(), mapped.end());
+        if (mapped == sorted) {
+            result.push_back(std::move(perm));
+        }
+    }
+    return result;
+}
+
+bool get_bit(const std::vector<uint64_t>& words, uint64_t index) {
+    return (words[index / 64] >> (index % 64)) & 1;
+}
+
+void write_at(int fd, const void* data, size_t size, size_t offset) {
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Tablebase write failed: ") + std::strerror(errno));
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<size_t>(n);
+    }
+}
+
+void read_at(int fd, void* data, size_t size, size_t offset) {
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            throw std::runtime_error(std::string("Tablebase read failed: ") +
+                                     (n == 0 ? "unexpected end of file" : std::strerror(errno)));
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<size_t>(n);
+    }
+}
+
+int32_t marks_in_layer(int32_t layer, bool maker) {
+    return maker ? (layer + 1) / 2 : layer / 2;
+}
+
+std::vector<size_t> layer_offsets(const PositionRanker& ranker, int32_t first_layer) {
+    std::vector<size_t> offsets(static_cast<size_t>(ranker.num_cells()) + 2, 0);
+    size_t offset = Tablebase::kHeaderBytes;
+    for (int32_t k = first_layer; k <= ranker.num_cells(); ++k) {
+        offsets[static_cast<size_t>(k)] = offset;
+        offset += static_cast<size_t>((ranker.layer_size(k) + 63) / 64) * 8;
+    }
+    offsets.back() = offset;
+    return offsets;
+}
+
+uint16_t header_u16(const MappedFile& file, size_t at) {
+    std::string_view data = file.data();
+    if (data.size() < Tablebase::kHeaderBytes || data.substr(0, 4) != std::string_view(Tablebase::kMagic, 4)) {
+        throw std::invalid_argument("Not a tablebase file");
+    }
+    return static_cast<uint16_t>(static_cast<uint8_t>(data[at]) | static_cast<uint8_t>(data[at + 1]) << 8);
+}
+
+int32_t checked_cols(const MappedFile& file) {
+    if (header_u16(file, 4) != Tablebase::kVersion) {
+        throw std::invalid_argument("Unsupported tablebase version");
+    }
+    int32_t cols = header_u16(file, 6);
+    if (cols < 1 || cols > Tablebase::kMaxCols) {
+        throw std::invalid_argument("Tablebase width out of range");
+    }
+    return cols;
+}
+
+} // namespace
+
+PositionRanker::PositionRanker(int32_t num_cells)
+    : num_cells_(num_cells)
+    , binomial_{} {
+    if (num_cells < 1 || num_cells > kMaxCells) {
+        throw std::invalid_argument("Ranker supports 1 to " + std::to_string(kMaxCells) + " cells");
+    }
+    for (size_t n = 0; n <= static_cast<size_t>(kMaxCells); ++n) {
+        binomial_[n][0] = 1;
+        for (size_t k = 1; k <= n; ++k) {
+            binomial_[n][k] = binomial_[n - 1][k - 1] + (k < n ? binomial_[n - 1][k] : 0);
+        }
+    }
+}
+
+uint64_t PositionRanker::layer_size(int32_t marks) const {
+    auto m = static_cast<size_t>(marks_in_layer(marks, true));
+    auto b = static_cast<size_t>(marks_in_layer(marks, false));
+    auto n = static_cast<size_t>(num_cells_);
+    if (m + b > n) return 0;
+    return binomial_[n][m] * binomial_[n - m][b];
+}
+
+uint64_t PositionRanker::rank(uint32_t maker, uint32_t breaker) const {
+    uint64_t maker_rank = 0;
+    size_t i = 0;
+    for (uint32_t bits = maker; bits != 0; bits &= bits - 1) {
+        maker_rank += binomial_[static_cast<size_t>(std::countr_zero(bits))][++i];
+    }
+    uint64_t breaker_rank = 0;
+    size_t j = 0;
+    for (uint32_t bits = breaker; bits != 0; bits &= bits - 1) {
+        int c = std::countr_zero(bits);
+        auto reduced = static_cast<size_t>(c - std::popcount(maker & ((uint32_t{1} << c) - 1)));
+        breaker_rank += binomial_[reduced][++j];
+    }
+    auto free_cells = static_cast<size_t>(num_cells_) - i;
+    return maker_rank * binomial_[free_cells][j] + breaker_rank;
+}
+
+void PositionRanker::unrank(int32_t marks, uint64_t rank, uint32_t& maker, uint32_t& breaker) const {
+    auto m = static_cast<size_t>(marks_in_layer(marks, true));
+    auto b = static_cast<size_t>(marks_in_layer(marks, false));
+    auto n = static_cast<size_t>(num_cells_);
+    uint64_t span = binomial_[n - m][b];
+
+    auto decode = [&](uint64_t r, size_t k, size_t universe) {
+        uint32_t set = 0;
+        size_t c = universe;
+        for (size_t i = k; i >= 1; --i) {
+            do { --c; } while (binomial_[c][i] > r);
+            set |= uint32_t{1} << c;
+            r -= binomial_[c][i];
+        }
+        return set;
+    };
+    maker = decode(rank / span, m, n);
+    uint32_t reduced = decode(rank % span, b, n - m);
+
+    // The j-th set bit of `reduced` selects the j-th cell Maker does not hold
+    breaker = 0;
+    for (size_t c = 0; c < n && reduced != 0; ++c) {
+        if (maker & (uint32_t{1} << c)) continue;
+        if (reduced & 1) breaker |= uint32_t{1} << c;
+        reduced >>= 1;
+    }
+}
+
+TablebaseStats Tablebase::build(int32_t num_cols, const std::vector<Hyperedge>& edges,
+                                const std::string& path, TablebaseOptions options) {
+    if (num_cols < 1 || num_cols > kMaxCols) {
+        throw std::invalid_argument("Tablebase width must be between 1 and " + std::to_string(kMaxCols));
+    }
+    auto start = std::chrono::steady_clock::now();
+    const int32_t num_cells = 4 * num_cols;
+    PositionRanker ranker(num_cells);
+    int32_t max_empty = options.max_empty < 0 ? num_cells : std::min(options.max_empty, num_cells);
+    int32_t first_layer = num_cells - max_empty;
+    const uint32_t full = (num_cells == 32) ? ~uint32_t{0} : (uint32_t{1} << num_cells) - 1;
+
+    std::vector<uint32_t> masks;
+    for (const auto& edge : edges) {
+        masks.push_back(edge_mask(edge, num_cols));
+    }
+    auto symmetries = edge_symmetries(num_cols, masks);
+
+    TablebaseStats stats;
+    stats.symmetries = static_cast<int32_t>(symmetries.size()) + 1;
+    auto offsets = layer_offsets(ranker, first_layer);
+    stats.bytes = offsets.back();
+
+    // Identifies the table a checkpoint belongs to
+    const CheckpointOptions& checkpoint = options.checkpoint;
+    CheckpointBuffer identity;
+    identity.put(num_cols);
+    identity.put(first_layer);
+    identity.put(static_cast<uint64_t>(masks.size()));
+    identity.put_bytes(masks.data(), masks.size() * sizeof(uint32_t));
+
+    // Resume point: the layer in progress, its finished blocks and its bits
+    // so far. Layers above it are already in the file.
+    int32_t start_layer = num_cells;
+    std::vector<uint8_t> resume_done;
+    std::vector<int64_t> resume_solved;
+    std::vector<uint64_t> resume_words;
+    std::optional<std::string> payload;
+    if (checkpoint.resume && !checkpoint.path.empty()) {
+        payload = Checkpoint::read(checkpoint.path, CheckpointKind::Tablebase);
+    }
+    if (payload) {
+        CheckpointReader in(*payload);
+        std::string saved(identity.data().size(), '\0');
+        in.get_bytes(saved.data(), saved.size());
+        if (saved != identity.data()) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " is for another width, edge set or depth");
+        }
+        start_layer = in.get<int32_t>();
+        stats.positions = in.get<int64_t>();
+        stats.evaluated = in.get<int64_t>();
+        stats.maker_wins = in.get<int64_t>();
+        auto num_blocks = static_cast<size_t>(in.get<uint64_t>());
+        resume_done.resize(num_blocks);
+        resume_solved.resize(num_blocks);
+        in.get_bytes(resume_done.data(), num_blocks);
+        in.get_bytes(resume_solved.data(), num_blocks * sizeof(int64_t));
+        resume_words.resize(static_cast<size_t>(in.get<uint64_t>()));
+        in.get_bytes(resume_words.data(), resume_words.size() * sizeof(uint64_t));
+        if (start_layer < first_layer || start_layer > num_cells) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " has a layer out of range");
+        }
+    }
+
+    int fd = payload ? ::open(path.c_str(), O_RDWR) : ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot " + std::string(payload ? "open " : "create ") + path + ": " +
+                                 std::strerror(errno));
+    }
+    try {
+        if (::ftruncate(fd, static_cast<off_t>(stats.bytes)) < 0) {
+            throw std::runtime_error("Cannot size " + path + ": " + std::strerror(errno));
+        }
+        char header[kHeaderBytes] = {kMagic[0], kMagic[1], kMagic[2], kMagic[3]};
+        header[4] = static_cast<char>(kVersion & 0xFF);
+        header[5] = static_cast<char>(kVersion >> 8);
+        header[6] = static_cast<char>(num_cols);
+        header[8] = static_cast<char>(first_layer);
+        write_at(fd, header, sizeof(header), 0);
+
+        // The table file is synced before a checkpoint that relies on its layers
+        std::optional<CheckpointWriter> writer;
+        if (!checkpoint.path.empty()) {
+            writer.emplace(checkpoint.path, CheckpointKind::Tablebase, [fd] { ::fdatasync(fd); });
+        }
+        CheckpointTimer timer(checkpoint.interval_seconds);
+        auto stopped = [&] { return writer && checkpoint.stop && checkpoint.stop->load(std::memory_order_relaxed); };
+
+        ThreadPool pool(options.threads);
+        std::vector<uint64_t> next;  // Values of layer k + 1
+        if (start_layer < num_cells) {
+            next.resize(static_cast<size_t>((ranker.layer_size(start_layer + 1) + 63) / 64));
+            read_at(fd, next.data(), next.size() * 8, offsets[static_cast<size_t>(start_layer) + 1]);
+        }
+        for (int32_t k = start_layer; k >= first_layer; --k) {
+            GAME_SCOPE("Tablebase::build_layer");
+            uint64_t size = ranker.layer_size(k);
+            auto num_words = static_cast<size_t>((size + 63) / 64);
+            auto words = std::make_unique<std::atomic<uint64_t>[]>(num_words);
+            bool maker_turn = k % 2 == 0;
+            auto num_blocks = static_cast<int64_t>((size + kBlockPositions - 1) / kBlockPositions);
+            auto done = std::make_unique<std::atomic<bool>[]>(static_cast<size_t>(num_blocks));
+            std::vector<int64_t> block_solved(static_cast<size_t>(num_blocks), 0);
+            if (k == start_layer && payload) {
+                if (resume_words.size() != num_words || resume_done.size() != static_cast<size_t>(num_blocks)) {
+                    throw std::runtime_error("Checkpoint " + checkpoint.path + " does not match its layer");
+                }
+                for (size_t w = 0; w < num_words; ++w) {
+                    words[w].store(resume_words[w], std::memory_order_relaxed);
+                }
+                for (size_t b = 0; b < resume_done.size(); ++b) {
+                    done[b].store(resume_done[b] != 0, std::memory_order_relaxed);
+                    block_solved[b] = resume_solved[b];
+                }
+            }
+
+            // Bits only ever get set, and a block's images are set before it
+            // is flagged done, so a snapshot may run next to the workers
+            auto snapshot = [&] {
+                CheckpointBuffer out;
+                out.put_bytes(identity.data().data(), identity.data().size());
+                out.put(k);
+                out.put(stats.positions);
+                out.put(stats.evaluated);
+                out.put(stats.maker_wins);
+                out.put(static_cast<uint64_t>(num_blocks));
+                std::vector<uint8_t> flags(static_cast<size_t>(num_blocks));
+                std::vector<int64_t> solved(static_cast<size_t>(num_blocks), 0);
+                for (size_t b = 0; b < flags.size(); ++b) {
+                    flags[b] = done[b].load(std::memory_order_acquire) ? 1 : 0;
+                    if (flags[b]) solved[b] = block_solved[b];
+                }
+                out.put_bytes(flags.data(), flags.size());
+                out.put_bytes(solved.data(), solved.size() * sizeof(int64_t));
+                out.put(static_cast<uint64_t>(num_words));
+                for (size_t w = 0; w < num_words; ++w) {
+                    out.put(words[w].load(std::memory_order_relaxed));
+                }
+                return std::move(out.data());
+            };
+
+            auto solve = [&](uint32_t maker, uint32_t breaker) {
+                for (uint32_t mask : masks) {
+                    if ((maker & mask) == mask) return true;
+                }
+                uint32_t empty = full & ~(maker | breaker);
+                for (uint32_t bits = empty; bits != 0; bits &= bits - 1) {
+                    uint32_t cell = bits & (~bits + 1);
+                    bool child = maker_turn ? get_bit(next, ranker.rank(maker | cell, breaker))
+                                            : get_bit(next, ranker.rank(maker, breaker | cell));
+                    if (child == maker_turn) return maker_turn;
+                }
+                // Full board, or no move changes the outcome
+                return empty != 0 && !maker_turn;
+            };
+
+            pool.parallel_for(num_blocks, [&](int64_t block) {
+                if (done[static_cast<size_t>(block)].load(std::memory_order_relaxed) || stopped()) return;
+                uint64_t begin = static_cast<uint64_t>(block) * kBlockPositions;
+                uint64_t end = std::min(size, begin + kBlockPositions);
+                std::vector<uint64_t> images(symmetries.size());
+                int64_t solved = 0;
+                for (uint64_t r = begin; r < end; ++r) {
+                    uint32_t maker = 0;
+                    uint32_t breaker = 0;
+                    ranker.unrank(k, r, maker, breaker);
+                    bool canonical = true;
+                    for (size_t s = 0; s < symmetries.size() && canonical; ++s) {
+                        images[s] = ranker.rank(permute(symmetries[s], maker), permute(symmetries[s], breaker));
+                        canonical = images[s] >= r;
+                    }
+                    if (!canonical) continue;
+                    ++solved;
+                    if (!solve(maker, breaker)) continue;
+                    // Images may fall in another thread's block
+                    words[r / 64].fetch_or(uint64_t{1} << (r % 64), std::memory_order_relaxed);
+                    for (uint64_t image : images) {
+                        words[image / 64].fetch_or(uint64_t{1} << (image % 64), std::memory_order_relaxed);
+                    }
+                }
+                block_solved[static_cast<size_t>(block)] = solved;
+                done[static_cast<size_t>(block)].store(true, std::memory_order_release);
+                if (checkpoint.on_unit) checkpoint.on_unit();
+                if (writer && timer.claim()) {
+                    writer->submit(snapshot());
+                }
+            });
+
+            if (stopped()) {
+                writer->submit(snapshot());
+                writer->flush();
+                throw CheckpointInterrupted(checkpoint.path);
+            }
+            next.resize(num_words);
+            for (size_t w = 0; w < num_words; ++w) {
+                next[w] = words[w].load(std::memory_order_relaxed);
+                stats.maker_wins += std::popcount(next[w]);
+            }
+            write_at(fd, next.data(), num_words * 8, offsets[static_cast<size_t>(k)]);
+            stats.positions += static_cast<int64_t>(size);
+            for (int64_t solved : block_solved) {
+                stats.evaluated += solved;
+            }
+        }
+        if (writer) {
+            writer->flush();
+            writer.reset();
+            Checkpoint::remove(checkpoint.path);
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+Tablebase::Tablebase(const std::string& path)
+    : file_(path)
+    , num_cols_(checked_cols(file_))
+    , first_layer_(header_u16(file_, 8))
+    , ranker_(4 * num_cols_) {
+    if (first_layer_ > ranker_.num_cells()) {
+        throw std::invalid_argument("Tablebase first layer out of range");
+    }
+    layer_offsets_ = layer_offsets(ranker_, first_layer_);
+    if (file_.size() != layer_offsets_.back()) {
+        throw std::invalid_argument("Tablebase file size does not match its header");
+    }
+}
+
+std::optional<bool> Tablebase::maker_wins(const Board& board) const {
+    if (board.cols() != num_cols_ || board.rows() != 4) {
+        throw std::invalid_argument("Tablebase covers n=" + std::to_string(num_cols_) + ", not n=" +
+                                    std::to_string(board.cols()));
+    }
+    uint32_t maker = 0;
+    uint32_t breaker = 0;
+    masks(board, maker, breaker);
+    int32_t m = std::popcount(maker);
+    int32_t b = std::popcount(breaker);
+    if (m != b && m != b + 1) {
+        throw std::invalid_argument("Position counts cannot arise in play");
+    }
+    if (m + b < first_layer_) {
+        return std::nullopt;
+    }
+    return lookup(maker, breaker);
+}
+
+std::optional<bool> Tablebase::probe(const Board& board, Player to_move) const {
+    if (board.cols() != num_cols_ || board.rows() != 4) {
+        return std::nullopt;
+    }
+    uint32_t maker = 0;
+    uint32_t breaker = 0;
+    masks(board, maker, breaker);
+    int32_t m = std::popcount(maker);
+    int32_t b = std::popcount(breaker);
+    if (m - b != (to_move == Player::Maker ? 0 : 1) || m + b < first_layer_) {
+        return std::nullopt;
+    }
+    return lookup(maker, breaker);
+}
+
+void Tablebase::masks(const Board& board, uint32_t& maker, uint32_t& breaker) const {
+    maker = 0;
+    breaker = 0;
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < board.cols(); ++c) {
+            uint32_t bit = uint32_t{1} << (r * num_cols_ + c);
+            CellState state = board.get(r, c);
+            if (state == CellState::Maker) maker |= bit;
+            if (state == CellState::Breaker) breaker |= bit;
+        }
+    }
+}
+
+bool Tablebase::lookup(uint32_t maker, uint32_t breaker) const {
+    auto marks = static_cast<size_t>(std::popcount(maker) + std::popcount(breaker));
+    uint64_t rank = ranker_.rank(maker, breaker);
+    uint64_t word = 0;
+    std::memcpy(&word, file_.data().data() + layer_offsets_[marks] + (rank / 64) * 8, 8);
+    return ((word >> (rank % 64)) & 1) != 0;
+}
+
+} // namespace game
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "util/Checkpoint.h"
+#include "util/MappedFile.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace game {
+
+// Perfect rank of the positions with a given number of marks.
+//
+// A layer of k marks holds ceil(k/2) Maker and floor(k/2) Breaker cells, the
+// only counts that arise in play. Positions are pairs of cell masks; the rank
+// is the colex rank of the Maker set times C(cells - m, b), plus the colex
+// rank of the Breaker set among the cells Maker does not hold.
+class PositionRanker {
+public:
+    static constexpr int32_t kMaxCells = 32;
+
+    explicit PositionRanker(int32_t num_cells);
+
+    int32_t num_cells() const { return num_cells_; }
+    uint64_t layer_size(int32_t marks) const;
+    uint64_t rank(uint32_t maker, uint32_t breaker) const;
+    void unrank(int32_t marks, uint64_t rank, uint32_t& maker, uint32_t& breaker) const;
+
+private:
+    int32_t num_cells_;
+    std::array<std::array<uint64_t, kMaxCells + 1>, kMaxCells + 1> binomial_;
+};
+
+struct TablebaseOptions {
+    int32_t max_empty = -1;  // Deepest layer solved, in empty cells; -1 for the whole game
+    int32_t threads = 1;
+    CheckpointOptions checkpoint;
+};
+
+struct TablebaseStats {
+    int64_t positions = 0;   // Positions stored
+    int64_t evaluated = 0;   // Symmetry representatives actually solved
+    int64_t maker_wins = 0;
+    int32_t symmetries = 1;  // Size of the symmetry group used
+    size_t bytes = 0;
+    double seconds = 0.0;
+};
+
+// Memory-mapped retrograde tablebase: one bit per position, set when Maker
+// wins with perfect play from it (side to move from the counts).
+//
+// File layout: "7RTB", u16 version, u16 columns, u16 first layer, u16 zero,
+// then for each layer from the first to the full board its bits as
+// little-endian u64 words, indexed by PositionRanker.
+class Tablebase {
+public:
+    static constexpr char kMagic[4] = {'7', 'R', 'T', 'B'};
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 12;
+    static constexpr int32_t kMaxCols = PositionRanker::kMaxCells / 4;
+
+    explicit Tablebase(const std::string& path);
+
+    // Solve every layer with at most max_empty empty cells, from the full
+    // board down, and write the table to `path`. Within a layer, positions
+    // are split across threads in blocks. Only the lowest-rank image of each
+    // position under the symmetries that map the edge set onto itself
+    // (row flip, column mirror) is solved; its value is stored for all images.
+    //
+    // With a checkpoint path, the layer in progress (its bits and finished
+    // blocks) and the counters are saved periodically; finished layers are
+    // already in `path`. Resuming continues from there and writes the same
+    // file as an uninterrupted build.
+    static TablebaseStats build(int32_t num_cols, const std::vector<Hyperedge>& edges,
+                                const std::string& path, TablebaseOptions options);
+
+    int32_t cols() const { return num_cols_; }
+    int32_t first_layer() const { return first_layer_; }
+
+    // Perfect-play value, or nullopt when the position has fewer marks than
+    // the first stored layer. Throws for counts that cannot arise in play.
+    std::optional<bool> maker_wins(const Board& board) const;
+
+    // Leaf oracle for searches: the value when the table covers the board
+    // (same width, at least first_layer() marks, counts matching `to_move`),
+    // else nullopt. Never throws. The table must be of the searched edge set.
+    std::optional<bool> probe(const Board& board, Player to_move) const;
+
+private:
+    MappedFile file_;
+    int32_t num_cols_;
+    int32_t first_layer_;
+    PositionRanker ranker_;
+    std::vector<size_t> layer_offsets_;  // Byte offset of each layer's words
+
+    void masks(const Board& board, uint32_t& maker, uint32_t& breaker) const;
+    bool lookup(uint32_t maker, uint32_t breaker) const;
+};
+
+} // namespace game
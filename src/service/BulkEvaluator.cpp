@@ -0,0 +1,217 @@
+#include "service/BulkEvaluator.h"
+#include "search/Certifier.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace game {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "Columnar output is written in host byte order");
+
+template <typename T>
+void append_raw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void append_number(std::string& out, T value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+void append_potential(std::string& out, double value) {
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 6);
+    out.append(buf, result.ptr);
+}
+
+} // namespace
+
+BulkEvaluator::BulkEvaluator(BulkOptions options)
+    : options_(options)
+    , pool_(options.threads) {
+    if (options.depth < 0) {
+        throw std::invalid_argument("Certificate depth must be non-negative");
+    }
+    if (options.chunk_bytes == 0) {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
+}
+
+PositionReport BulkEvaluator::evaluate(const Position& position) {
+    auto tables = tables_.get(position.board.cols());
+    const WidthTables& t = *tables;
+    PositionReport report;
+    report.to_move = position.to_move;
+
+    // One scan for the histogram; pot(b) follows from it exactly
+    PotentialCalculator calc(position.board, t.edges);
+    report.histogram = calc.compute_histogram();
+    for (size_t l = 0; l < report.histogram.size(); ++l) {
+        report.potential += std::ldexp(static_cast<double>(report.histogram[l]), -static_cast<int>(l));
+    }
+    report.maker_won = t.index->maker_completed_edge(position.board);
+    if (report.maker_won) {
+        return report;
+    }
+    if (options_.depth == 0) {
+        // As Certifier at depth 0: pot < 1 certifies only with Breaker to
+        // move, or on a full board (where pot is 0)
+        report.certified = report.potential < 1.0 &&
+                           (position.to_move == Player::Breaker || position.board.get_empty_cells().empty());
+    } else {
+        Certifier certifier(position.board, t.index, {options_.depth, BreakerReplies::Greedy});
+        report.certified = certifier.certify(position.to_move).certified;
+    }
+    return report;
+}
+
+BulkStats BulkEvaluator::run(std::string_view input, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+    BulkStats stats;
+
+    // Cut the input into chunks on record or line boundaries
+    int32_t packed_cols = PositionCodec::parse_packed_header(input);
+    std::vector<std::string_view> chunks;
+    if (packed_cols > 0) {
+        std::string_view body = input.substr(PositionCodec::kPackedHeaderBytes);
+        size_t record = PositionCodec::packed_size(packed_cols);
+        if (body.size() % record != 0) {
+            throw std::invalid_argument("Packed file is not a whole number of " + std::to_string(record) +
+                                        "-byte records");
+        }
+        size_t step = std::max<size_t>(1, options_.chunk_bytes / record) * record;
+        for (size_t offset = 0; offset < body.size(); offset += step) {
+            chunks.push_back(body.substr(offset, step));
+        }
+    } else {
+        for (size_t offset = 0; offset < input.size();) {
+            size_t end = std::min(input.size(), offset + options_.chunk_bytes);
+            size_t newline = input.find('\n', end > 0 ? end - 1 : 0);
+            end = (newline == std::string_view::npos) ? input.size() : newline + 1;
+            chunks.push_back(input.substr(offset, end - offset));
+            offset = end;
+        }
+    }
+
+    if (options_.format == BulkFormat::Csv) {
+        out << "index,to_move,x1,x2,x3,x4,x5,x6,x7,pot,maker_won,certified\n";
+    } else {
+        std::string header(kColumnarMagic, sizeof(kColumnarMagic));
+        append_raw(header, kColumnarVersion);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    size_t window = static_cast<size_t>(pool_.size()) * 4;
+    std::vector<std::vector<PositionReport>> reports(window);
+    std::vector<std::string> outputs(window);
+    std::vector<int64_t> first_index(window);
+    for (size_t base = 0; base < chunks.size(); base += window) {
+        size_t count = std::min(window, chunks.size() - base);
+        pool_.parallel_for(static_cast<int64_t>(count), [&](int64_t i) {
+            auto k = static_cast<size_t>(i);
+            evaluate_chunk(input, chunks[base + k], packed_cols, reports[k]);
+        });
+        for (size_t k = 0; k < count; ++k) {
+            first_index[k] = stats.positions;
+            stats.positions += static_cast<int64_t>(reports[k].size());
+        }
+        pool_.parallel_for(static_cast<int64_t>(count), [&](int64_t i) {
+            auto k = static_cast<size_t>(i);
+            format_chunk(reports[k], first_index[k], outputs[k]);
+        });
+        for (size_t k = 0; k < count; ++k) {
+            out.write(outputs[k].data(), static_cast<std::streamsize>(outputs[k].size()));
+        }
+    }
+    out.flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+void BulkEvaluator::evaluate_chunk(std::string_view input, std::string_view chunk, int32_t packed_cols,
+                                   std::vector<PositionReport>& reports) {
+    reports.clear();
+    if (packed_cols > 0) {
+        size_t record = PositionCodec::packed_size(packed_cols);
+        for (size_t offset = 0; offset < chunk.size(); offset += record) {
+            auto data = reinterpret_cast<const uint8_t*>(chunk.data() + offset);
+            reports.push_back(evaluate(PositionCodec::unpack(data, packed_cols)));
+        }
+        return;
+    }
+
+    for (size_t offset = 0; offset < chunk.size();) {
+        size_t newline = chunk.find('\n', offset);
+        size_t end = (newline == std::string_view::npos) ? chunk.size() : newline;
+        std::string_view line = chunk.substr(offset, end - offset);
+        offset = end + 1;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos || line[first] == '#') {
+            continue;
+        }
+        try {
+            reports.push_back(evaluate(PositionCodec::parse(line.substr(first))));
+        } catch (const std::exception& e) {
+            // Only the failing line pays for the line count
+            auto line_start = static_cast<size_t>(line.data() - input.data());
+            auto line_number = std::count(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(line_start), '\n') + 1;
+            throw std::invalid_argument("Line " + std::to_string(line_number) + ": " + e.what());
+        }
+    }
+}
+
+void BulkEvaluator::format_chunk(const std::vector<PositionReport>& reports, int64_t first_index,
+                                 std::string& out) const {
+    out.clear();
+    if (reports.empty()) {
+        return;
+    }
+    if (options_.format == BulkFormat::Csv) {
+        for (size_t i = 0; i < reports.size(); ++i) {
+            const PositionReport& r = reports[i];
+            append_number(out, first_index + static_cast<int64_t>(i));
+            out += (r.to_move == Player::Maker) ? ",m" : ",b";
+            for (int32_t count : r.histogram) {
+                out += ',';
+                append_number(out, count);
+            }
+            out += ',';
+            append_potential(out, r.potential);
+            out += r.maker_won ? ",1" : ",0";
+            out += r.certified ? ",1\n" : ",0\n";
+        }
+        return;
+    }
+
+    append_raw(out, static_cast<uint32_t>(reports.size()));
+    append_raw(out, static_cast<uint64_t>(first_index));
+    for (const auto& r : reports) {
+        append_raw(out, r.potential);
+    }
+    for (size_t l = 0; l < static_cast<size_t>(kDefaultLineLength); ++l) {
+        for (const auto& r : reports) {
+            append_raw(out, static_cast<uint32_t>(r.histogram[l]));
+        }
+    }
+    for (const auto& r : reports) {
+        append_raw(out, static_cast<uint8_t>(r.to_move));
+    }
+    for (const auto& r : reports) {
+        append_raw(out, static_cast<uint8_t>(r.maker_won ? 1 : 0));
+    }
+    for (const auto& r : reports) {
+        append_raw(out, static_cast<uint8_t>(r.certified ? 1 : 0));
+    }
+}
+
+} // namespace game
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/Board.h"
+#include "metrics/Potential.h"
+#include "service/WidthCache.h"
+#include "util/Position.h"
+#include "util/ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game {
+
+enum class BulkFormat : uint8_t {
+    Csv = 0,
+    Columnar = 1
+};
+
+struct BulkOptions {
+    int32_t threads = 1;
+    int32_t depth = 4;                      // Certificate lookahead in plies
+    BulkFormat format = BulkFormat::Csv;
+    size_t chunk_bytes = size_t{256} << 10; // Input evaluated per task
+};
+
+struct PositionReport {
+    Player to_move = Player::Maker;
+    LLineHistogram histogram{};
+    double potential = 0.0;
+    bool maker_won = false;
+    bool certified = false;                 // Certifier at the configured depth
+};
+
+struct BulkStats {
+    int64_t positions = 0;
+    double seconds = 0.0;
+};
+
+// Evaluates every position of an input file: one text notation per line
+// (blank lines and lines starting with '#' are skipped), or a packed file.
+//
+// The input is cut into chunks on line or record boundaries. A window of
+// chunks is evaluated across the thread pool, formatted in parallel and
+// written in input order, so output memory stays bounded by the window.
+//
+// CSV output has a header and one row per position:
+//
+//     index,to_move,x1,x2,x3,x4,x5,x6,x7,pot,maker_won,certified
+//
+// Columnar output starts with "7REV" and a u32 version, then one row group
+// per chunk: u32 rows, u64 first index, then the columns pot (f64), x1..x7
+// (u32 each), to_move (u8, 0 Maker), maker_won (u8) and certified (u8), each
+// `rows` values long. All integers and doubles are little-endian.
+class BulkEvaluator {
+public:
+    static constexpr char kColumnarMagic[4] = {'7', 'R', 'E', 'V'};
+    static constexpr uint32_t kColumnarVersion = 1;
+
+    explicit BulkEvaluator(BulkOptions options);
+
+    BulkStats run(std::string_view input, std::ostream& out);
+
+    PositionReport evaluate(const Position& position);
+
+private:
+    BulkOptions options_;
+    ThreadPool pool_;
+    WidthCache tables_;
+
+    void evaluate_chunk(std::string_view input, std::string_view chunk, int32_t packed_cols,
+                        std::vector<PositionReport>& reports);
+    void format_chunk(const std::vector<PositionReport>& reports, int64_t first_index,
+                      std::string& out) const;
+};
+
+} // namespace game
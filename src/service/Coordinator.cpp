@@ -0,0 +1,612 @@
+#include "service/Coordinator.h"
+#include "search/MoveGenerator.h"
+#include "util/Instrument.h"
+#include "util/Position.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace game {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kReadChunk = size_t{4} << 10;
+constexpr int kPollMs = 50;
+
+Player opponent(Player p) {
+    return p == Player::Maker ? Player::Breaker : Player::Maker;
+}
+
+CellState mark_of(Player p) {
+    return p == Player::Maker ? CellState::Maker : CellState::Breaker;
+}
+
+// The terminal rules of ProofNumberSearch; Unknown when play goes on
+PnValue leaf_value(const IncrementalPotential& state, Player to_move) {
+    if (state.maker_won()) return PnValue::Proved;
+    if (state.num_empty() == 0 || (to_move == Player::Breaker && state.has_breaker_certificate())) {
+        return PnValue::Disproved;
+    }
+    return PnValue::Unknown;
+}
+
+const char* value_name(PnValue value) {
+    if (value == PnValue::Proved) return "proved";
+    if (value == PnValue::Disproved) return "disproved";
+    return "unknown";
+}
+
+sockaddr_un socket_address(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+bool send_line(int fd, const std::string& line) {
+    const char* data = line.data();
+    size_t size = line.size();
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Append what is available on `fd` to `buffer`; false at end of stream
+bool receive(int fd, std::string& buffer) {
+    char chunk[kReadChunk];
+    while (true) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+}
+
+// Remove and return the first complete line of `buffer`
+bool next_line(std::string& buffer, std::string& line) {
+    size_t end = buffer.find('\n');
+    if (end == std::string::npos) return false;
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+struct Peer {
+    int fd = -1;
+    std::string input;
+    int32_t unit = -1;             // Unit in flight, -1 when idle
+    Clock::time_point started;
+    size_t worker = 0;             // Index into CoordinatorStats::workers
+};
+
+} // namespace
+
+Coordinator::Coordinator(const Board& board, Player to_move, CoordinatorOptions options, int32_t line_length)
+    : start_(board)
+    , to_move_(to_move)
+    , options_(std::move(options))
+    , line_length_(line_length)
+    , edges_(EdgeGenerator::generate_edges(board.cols(), board.rows(), line_length))
+    , state_(board, edges_, line_length) {
+    if (options_.workers < 0 || options_.split_depth < 0 || options_.unit_expansions <= 0) {
+        throw std::invalid_argument("Coordinator needs workers >= 0, split depth >= 0 and a positive unit budget");
+    }
+    if (options_.socket_path.empty()) {
+        options_.socket_path = "/tmp/game-coordinator-" + std::to_string(::getpid()) + ".sock";
+    }
+}
+
+void Coordinator::play(const Unit& unit) {
+    Player player = to_move_;
+    for (int32_t cell : unit.moves) {
+        state_.place(cell, mark_of(player));
+        player = opponent(player);
+    }
+}
+
+void Coordinator::unplay(const Unit& unit) {
+    for (size_t i = 0; i < unit.moves.size(); ++i) {
+        state_.undo();
+    }
+}
+
+std::vector<int32_t> Coordinator::split(int32_t id) {
+    GAME_SCOPE("Coordinator::split");
+    Unit parent = units_[static_cast<size_t>(id)];
+    play(parent);
+    std::vector<int32_t> moves = MoveGenerator::generate(state_);
+    std::vector<std::pair<int32_t, PnValue>> children;
+    for (int32_t move : moves) {
+        Unit child;
+        child.parent = id;
+        child.moves = parent.moves;
+        child.moves.push_back(move);
+        child.to_move = opponent(parent.to_move);
+        state_.place(move, mark_of(parent.to_move));
+        PnValue value = leaf_value(state_, child.to_move);
+        state_.undo();
+        children.push_back({static_cast<int32_t>(units_.size()), value});
+        units_.push_back(std::move(child));
+    }
+    unplay(parent);
+
+    Unit& unit = units_[static_cast<size_t>(id)];
+    unit.split = true;
+    unit.open_children = static_cast<int32_t>(children.size());
+    if (children.empty()) {
+        // No live cell left: Maker cannot complete any edge
+        resolve(id, PnValue::Disproved);
+        return {};
+    }
+    std::vector<int32_t> open;
+    for (const auto& [child, value] : children) {
+        if (value != PnValue::Unknown) {
+            resolve(child, value);
+        } else {
+            open.push_back(child);
+        }
+    }
+    return open;
+}
+
+void Coordinator::resolve(int32_t id, PnValue value) {
+    while (id >= 0) {
+        Unit& unit = units_[static_cast<size_t>(id)];
+        if (unit.value != PnValue::Unknown) return;
+        unit.value = value;
+        if (unit.parent < 0) return;
+        Unit& parent = units_[static_cast<size_t>(unit.parent)];
+        if (parent.value != PnValue::Unknown) return;
+        // A Maker node is proved by one child, a Breaker node disproved by one
+        PnValue decisive = (parent.to_move == Player::Maker) ? PnValue::Proved : PnValue::Disproved;
+        if (value != decisive && --parent.open_children > 0) return;
+        id = unit.parent;
+    }
+}
+
+bool Coordinator::moot(int32_t id) const {
+    for (; id >= 0; id = units_[static_cast<size_t>(id)].parent) {
+        if (units_[static_cast<size_t>(id)].value != PnValue::Unknown) return true;
+    }
+    return false;
+}
+
+std::string Coordinator::unit_message(int32_t id) {
+    const Unit& unit = units_[static_cast<size_t>(id)];
+    play(unit);
+    std::string position = PositionCodec::format(state_.board(), unit.to_move);
+    unplay(unit);
+    return "unit " + std::to_string(id) + " " + std::to_string(options_.unit_expansions) + " " + position + "\n";
+}
+
+void Coordinator::save(CheckpointBuffer& out, const std::vector<int32_t>& in_flight) const {
+    out.put(stats_.units);
+    out.put(stats_.solved);
+    out.put(stats_.budget_splits);
+    out.put(stats_.straggler_splits);
+    out.put(stats_.requeued);
+    out.put(stats_.expansions);
+    out.put(static_cast<uint64_t>(units_.size()));
+    for (const Unit& unit : units_) {
+        out.put(unit.parent);
+        out.put(unit.to_move);
+        out.put(unit.value);
+        out.put(unit.open_children);
+        out.put(static_cast<uint8_t>(unit.split ? 1 : 0));
+        out.put(static_cast<uint64_t>(unit.moves.size()));
+        out.put_bytes(unit.moves.data(), unit.moves.size() * sizeof(int32_t));
+    }
+    // Results of the units in flight are lost, so they are the first to
+    // resend. A straggler already split has its children queued instead.
+    std::vector<int32_t> queued;
+    for (int32_t id : in_flight) {
+        if (!units_[static_cast<size_t>(id)].split && !moot(id)) queued.push_back(id);
+    }
+    queued.insert(queued.end(), queue_.begin(), queue_.end());
+    out.put(static_cast<uint64_t>(queued.size()));
+    out.put_bytes(queued.data(), queued.size() * sizeof(int32_t));
+}
+
+void Coordinator::load(CheckpointReader& in) {
+    stats_.units = in.get<int64_t>();
+    stats_.solved = in.get<int64_t>();
+    stats_.budget_splits = in.get<int64_t>();
+    stats_.straggler_splits = in.get<int64_t>();
+    stats_.requeued = in.get<int64_t>();
+    stats_.expansions = in.get<int64_t>();
+    units_.resize(static_cast<size_t>(in.get<uint64_t>()));
+    auto in_range = [&](int32_t id) { return id >= 0 && static_cast<size_t>(id) < units_.size(); };
+    for (size_t id = 0; id < units_.size(); ++id) {
+        Unit& unit = units_[id];
+        unit.parent = in.get<int32_t>();
+        unit.to_move = in.get<Player>();
+        unit.value = in.get<PnValue>();
+        unit.open_children = in.get<int32_t>();
+        unit.split = in.get<uint8_t>() != 0;
+        unit.moves.resize(static_cast<size_t>(in.get<uint64_t>()));
+        in.get_bytes(unit.moves.data(), unit.moves.size() * sizeof(int32_t));
+        if ((id == 0) != (unit.parent < 0) || (id > 0 && !in_range(unit.parent))) {
+            throw std::runtime_error("Checkpoint has a malformed split tree");
+        }
+    }
+    queue_.resize(static_cast<size_t>(in.get<uint64_t>()));
+    for (auto& id : queue_) {
+        id = in.get<int32_t>();
+        if (!in_range(id)) {
+            throw std::runtime_error("Checkpoint queues a unit out of range");
+        }
+    }
+}
+
+CoordinatorStats Coordinator::run() {
+    auto start = Clock::now();
+    stats_ = CoordinatorStats{};
+    queue_.clear();
+    units_.assign(1, Unit{});
+    units_[0].to_move = to_move_;
+
+    // Identifies the search a checkpoint belongs to
+    const CheckpointOptions& checkpoint = options_.checkpoint;
+    CheckpointBuffer identity;
+    std::string position = PositionCodec::format(start_, to_move_);
+    identity.put(static_cast<uint64_t>(position.size()));
+    identity.put_bytes(position.data(), position.size());
+    identity.put(line_length_);
+    identity.put(options_.split_depth);
+    identity.put(options_.unit_expansions);
+    std::optional<std::string> payload;
+    if (checkpoint.resume && !checkpoint.path.empty()) {
+        payload = Checkpoint::read(checkpoint.path, CheckpointKind::SolveDist);
+    }
+
+    if (payload) {
+        CheckpointReader in(*payload);
+        std::string saved(identity.data().size(), '\0');
+        in.get_bytes(saved.data(), saved.size());
+        if (saved != identity.data()) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path +
+                                     " is for another position, split depth or unit budget");
+        }
+        load(in);
+    } else {
+        // Opening frontier, solved locally where it is already terminal
+        std::vector<int32_t> frontier;
+        PnValue root_value = leaf_value(state_, to_move_);
+        if (root_value != PnValue::Unknown) {
+            resolve(0, root_value);
+        } else {
+            frontier.push_back(0);
+        }
+        for (int32_t depth = 0; depth < options_.split_depth; ++depth) {
+            std::vector<int32_t> next;
+            for (int32_t id : frontier) {
+                if (moot(id)) continue;
+                for (int32_t child : split(id)) {
+                    next.push_back(child);
+                }
+            }
+            frontier = std::move(next);
+        }
+        queue_.assign(frontier.begin(), frontier.end());
+    }
+    if (units_[0].value != PnValue::Unknown) {
+        stats_.value = units_[0].value;
+        stats_.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return stats_;
+    }
+
+    const std::string& path = options_.socket_path;
+    sockaddr_un addr = socket_address(path);
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listener, 64) < 0) {
+        int error = errno;
+        ::close(listener);
+        throw std::runtime_error("Cannot listen on " + path + ": " + std::strerror(error));
+    }
+
+    // Fork before anything else so the children start from a single thread
+    std::vector<pid_t> children;
+    for (int32_t w = 0; w < options_.workers; ++w) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(listener);
+            int code = 0;
+            try {
+                DistWorker::run(path);
+            } catch (const std::exception& e) {
+                std::cerr << "Worker error: " << e.what() << "\n";
+                code = 1;
+            }
+            ::_exit(code);
+        }
+        if (pid < 0) {
+            int error = errno;
+            for (pid_t child : children) ::kill(child, SIGKILL);
+            for (pid_t child : children) ::waitpid(child, nullptr, 0);
+            ::close(listener);
+            ::unlink(path.c_str());
+            throw std::runtime_error(std::string("fork failed: ") + std::strerror(error));
+        }
+        children.push_back(pid);
+    }
+
+    // The writer's thread starts after the fork
+    std::vector<Peer> peers;
+    std::optional<CheckpointWriter> writer;
+    if (!checkpoint.path.empty()) {
+        writer.emplace(checkpoint.path, CheckpointKind::SolveDist);
+    }
+    CheckpointTimer timer(checkpoint.interval_seconds);
+    auto snapshot = [&] {
+        CheckpointBuffer out;
+        out.put_bytes(identity.data().data(), identity.data().size());
+        std::vector<int32_t> in_flight;
+        for (const auto& peer : peers) {
+            if (peer.unit >= 0) in_flight.push_back(peer.unit);
+        }
+        save(out, in_flight);
+        return std::move(out.data());
+    };
+
+    std::string hello = "game " + std::to_string(start_.cols()) + " " + std::to_string(start_.rows()) + " " +
+                        std::to_string(line_length_) + " " + std::to_string(options_.memory_limit_bytes) + "\n";
+
+    auto next_unit = [&]() {
+        while (!queue_.empty()) {
+            int32_t id = queue_.front();
+            queue_.pop_front();
+            if (!moot(id)) return id;
+        }
+        return -1;
+    };
+    auto queue_front = [&](const std::vector<int32_t>& ids) {
+        queue_.insert(queue_.begin(), ids.begin(), ids.end());
+    };
+    auto disconnect = [&](size_t p) {
+        int32_t id = peers[p].unit;
+        if (id >= 0 && !moot(id)) {
+            queue_.push_front(id);
+            ++stats_.requeued;
+        }
+        ::close(peers[p].fd);
+        peers.erase(peers.begin() + static_cast<std::ptrdiff_t>(p));
+    };
+    auto handle = [&](Peer& peer, const std::string& line) {
+        std::istringstream in(line);
+        std::string tag;
+        std::string value;
+        int64_t id = -1;
+        int64_t expansions = 0;
+        int64_t micros = 0;
+        if (!(in >> tag >> id >> value >> expansions >> micros) || tag != "result" || id != peer.unit) {
+            throw std::runtime_error("Malformed worker message: " + line);
+        }
+        peer.unit = -1;
+        WorkerStats& worker = stats_.workers[peer.worker];
+        ++worker.units;
+        worker.expansions += expansions;
+        worker.busy_seconds += static_cast<double>(micros) * 1e-6;
+        stats_.expansions += expansions;
+
+        auto unit = static_cast<int32_t>(id);
+        if (value == "proved" || value == "disproved") {
+            ++stats_.solved;
+            resolve(unit, value == "proved" ? PnValue::Proved : PnValue::Disproved);
+        } else if (!units_[static_cast<size_t>(unit)].split && !moot(unit)) {
+            ++stats_.budget_splits;
+            queue_front(split(unit));
+        }
+        if (checkpoint.on_unit) checkpoint.on_unit();
+    };
+    auto split_straggler = [&]() {
+        Peer* slowest = nullptr;
+        for (auto& peer : peers) {
+            if (peer.unit < 0 || units_[static_cast<size_t>(peer.unit)].split || moot(peer.unit)) continue;
+            if (!slowest || peer.started < slowest->started) slowest = &peer;
+        }
+        if (!slowest) return;
+        double running = std::chrono::duration<double>(Clock::now() - slowest->started).count();
+        if (running < options_.straggler_seconds) return;
+        ++stats_.straggler_splits;
+        queue_front(split(slowest->unit));
+    };
+
+    try {
+        while (units_[0].value == PnValue::Unknown) {
+            if (writer && checkpoint.stop && checkpoint.stop->load(std::memory_order_relaxed)) {
+                writer->submit(snapshot());
+                writer->flush();
+                throw CheckpointInterrupted(checkpoint.path);
+            }
+            if (writer && timer.claim()) {
+                writer->submit(snapshot());
+            }
+
+            // Hand out work to idle workers
+            for (size_t p = 0; p < peers.size();) {
+                if (peers[p].unit >= 0) {
+                    ++p;
+                    continue;
+                }
+                int32_t id = next_unit();
+                if (id < 0) {
+                    split_straggler();
+                    id = next_unit();
+                }
+                if (id < 0 || units_[0].value != PnValue::Unknown) break;
+                peers[p].unit = id;
+                peers[p].started = Clock::now();
+                ++stats_.units;
+                if (!send_line(peers[p].fd, unit_message(id))) {
+                    disconnect(p);
+                    continue;
+                }
+                ++p;
+            }
+            if (units_[0].value != PnValue::Unknown) break;
+
+            // Forked workers that exited before connecting or after losing their connection
+            for (size_t c = 0; c < children.size();) {
+                if (::waitpid(children[c], nullptr, WNOHANG) == children[c]) {
+                    children.erase(children.begin() + static_cast<std::ptrdiff_t>(c));
+                } else {
+                    ++c;
+                }
+            }
+            if (options_.workers > 0 && children.empty() && peers.empty()) {
+                throw std::runtime_error("Every worker exited before the position was solved");
+            }
+
+            std::vector<pollfd> fds(1, pollfd{listener, POLLIN, 0});
+            for (const auto& peer : peers) {
+                fds.push_back(pollfd{peer.fd, POLLIN, 0});
+            }
+            if (::poll(fds.data(), fds.size(), kPollMs) < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+            }
+            // Peers first: accepting changes the indices
+            for (size_t p = peers.size(); p-- > 0;) {
+                if (!(fds[p + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+                if (!receive(peers[p].fd, peers[p].input)) {
+                    disconnect(p);
+                    continue;
+                }
+                std::string line;
+                while (next_line(peers[p].input, line)) {
+                    handle(peers[p], line);
+                }
+            }
+            if (fds[0].revents & POLLIN) {
+                int fd = ::accept(listener, nullptr, nullptr);
+                if (fd >= 0 && send_line(fd, hello)) {
+                    Peer peer;
+                    peer.fd = fd;
+                    peer.worker = stats_.workers.size();
+                    stats_.workers.emplace_back();
+                    peers.push_back(std::move(peer));
+                } else if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+        }
+    } catch (...) {
+        for (auto& peer : peers) ::close(peer.fd);
+        for (pid_t child : children) ::kill(child, SIGKILL);
+        for (pid_t child : children) ::waitpid(child, nullptr, 0);
+        ::close(listener);
+        ::unlink(path.c_str());
+        throw;
+    }
+
+    // Idle workers exit when their connection closes; busy ones hold only
+    // search state that is no longer needed
+    for (auto& peer : peers) {
+        if (peer.unit >= 0) {
+            ::shutdown(peer.fd, SHUT_RDWR);
+        }
+        ::close(peer.fd);
+    }
+    for (pid_t child : children) ::kill(child, SIGKILL);
+    for (pid_t child : children) ::waitpid(child, nullptr, 0);
+    ::close(listener);
+    ::unlink(path.c_str());
+    if (writer) {
+        writer->flush();
+        writer.reset();
+        Checkpoint::remove(checkpoint.path);
+    }
+
+    stats_.value = units_[0].value;
+    stats_.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return stats_;
+}
+
+int64_t DistWorker::run(const std::string& socket_path) {
+    sockaddr_un addr = socket_address(socket_path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to " + socket_path + ": " + std::strerror(error));
+    }
+
+    std::vector<Hyperedge> edges;
+    int32_t num_rows = kDefaultRows;
+    PnOptions options;
+    int64_t solved = 0;
+    std::string input;
+    std::string line;
+    try {
+        while (receive(fd, input)) {
+            while (next_line(input, line)) {
+                std::istringstream in(line);
+                std::string tag;
+                in >> tag;
+                if (tag == "game") {
+                    int32_t num_cols = 0;
+                    int32_t line_length = 0;
+                    if (!(in >> num_cols >> num_rows >> line_length >> options.memory_limit_bytes)) {
+                        throw std::runtime_error("Malformed coordinator message: " + line);
+                    }
+                    edges = EdgeGenerator::generate_edges(num_cols, num_rows, line_length);
+                    continue;
+                }
+                int64_t id = -1;
+                std::string position;
+                if (tag != "unit" || edges.empty() || !(in >> id >> options.max_expansions) ||
+                    !std::getline(in >> std::ws, position)) {
+                    throw std::runtime_error("Malformed coordinator message: " + line);
+                }
+                Position start = PositionCodec::parse(position, num_rows);
+                ProofNumberSearch search(start.board, edges, start.to_move, options);
+                PnResult result = search.solve();
+                ++solved;
+                auto micros = static_cast<int64_t>(result.seconds * 1e6);
+                std::string reply = "result " + std::to_string(id) + " " + value_name(result.value) + " " +
+                                    std::to_string(result.expansions) + " " + std::to_string(micros) + "\n";
+                if (!send_line(fd, reply)) {
+                    break;
+                }
+            }
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    return solved;
+}
+
+} // namespace game
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/IncrementalPotential.h"
+#include "search/ProofNumber.h"
+#include "util/Checkpoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace game {
+
+struct CoordinatorOptions {
+    int32_t workers = 2;                 // Worker processes forked on this machine; 0 waits for `game worker`
+    std::string socket_path;             // Empty: a fresh path under /tmp
+    int32_t split_depth = 2;             // Plies of the opening frontier handed out first
+    int64_t unit_expansions = 100000;    // Proof-number budget of one unit before it is split
+    size_t memory_limit_bytes = size_t{256} << 20;  // Node arena of each worker
+    double straggler_seconds = 1.0;      // Split a unit running this long once a worker is idle
+    CheckpointOptions checkpoint;        // Units are results received
+};
+
+struct WorkerStats {
+    int64_t units = 0;
+    int64_t expansions = 0;
+    double busy_seconds = 0.0;           // Time spent searching, as reported by the worker
+};
+
+struct CoordinatorStats {
+    PnValue value = PnValue::Unknown;
+    int64_t units = 0;                   // Units sent to workers
+    int64_t solved = 0;                  // Units that came back proved or disproved
+    int64_t budget_splits = 0;           // Units split after exhausting their budget
+    int64_t straggler_splits = 0;        // Running units split to feed idle workers
+    int64_t requeued = 0;                // Units resent after their worker disconnected
+    int64_t expansions = 0;              // Sum over all workers
+    std::vector<WorkerStats> workers;    // In order of connection
+    double seconds = 0.0;
+
+    double nodes_per_second() const {
+        return seconds > 0.0 ? static_cast<double>(expansions) / seconds : 0.0;
+    }
+};
+
+// Multi-process proof-number search on one machine. Workers reach the
+// coordinator over a Unix domain socket only; workers elsewhere need that
+// socket forwarded to them (e.g. ssh -R with a socket path).
+//
+// The position is split into a frontier of openings `split_depth` plies
+// deep, with MoveGenerator's moves, and each opening becomes a work unit.
+// Workers connect to a Unix domain socket and solve one unit at a time with
+// ProofNumberSearch under an expansion budget. Results are combined up the
+// split tree (Maker nodes OR, Breaker nodes AND); units whose result can no
+// longer matter are dropped. A unit that exhausts its budget is split one
+// ply further and its children are queued first. When the queue runs dry
+// while a unit has been running for `straggler_seconds`, that unit is split
+// too, and whichever answer arrives first is used. A unit whose worker
+// disconnects is queued again.
+//
+// A checkpoint holds the split tree with its known values, the queue with
+// the units in flight put back at its front, and the counters. Workers keep
+// no state between units, so a resumed run may use a different set of them.
+//
+// Text protocol, one message per line:
+//
+//     coordinator: game <cols> <rows> <k> <memory bytes>
+//                  unit <id> <max expansions> <position notation with side>
+//     worker:      result <id> <proved|disproved|unknown> <expansions> <microseconds>
+class Coordinator {
+public:
+    // Edges are those of EdgeGenerator for the board's shape and
+    // `line_length`, which the workers regenerate on their side
+    Coordinator(const Board& board, Player to_move, CoordinatorOptions options,
+                int32_t line_length = kDefaultLineLength);
+
+    // Fork the workers, serve units until the position is solved, then stop
+    // the workers. Must be called before the process starts any threads.
+    CoordinatorStats run();
+
+    // The socket workers connect to, with an empty option resolved
+    const std::string& socket_path() const { return options_.socket_path; }
+
+private:
+    struct Unit {
+        int32_t parent = -1;
+        std::vector<int32_t> moves;      // Cell ids played from the start position
+        Player to_move = Player::Maker;
+        PnValue value = PnValue::Unknown;
+        int32_t open_children = 0;       // Children still unknown, once split
+        bool split = false;
+    };
+
+    Board start_;
+    Player to_move_;
+    CoordinatorOptions options_;
+    int32_t line_length_;
+    std::vector<Hyperedge> edges_;
+    IncrementalPotential state_;
+    std::vector<Unit> units_;
+    std::deque<int32_t> queue_;
+    CoordinatorStats stats_;
+
+    void play(const Unit& unit);
+    void unplay(const Unit& unit);
+    std::vector<int32_t> split(int32_t id);
+    void resolve(int32_t id, PnValue value);
+    bool moot(int32_t id) const;
+    std::string unit_message(int32_t id);
+    void save(CheckpointBuffer& out, const std::vector<int32_t>& in_flight) const;
+    void load(CheckpointReader& in);
+};
+
+// Connects to a coordinator's socket and solves units until it closes the
+// connection. Returns the number of units solved.
+class DistWorker {
+public:
+    static int64_t run(const std::string& socket_path);
+};
+
+} // namespace game
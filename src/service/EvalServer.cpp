@@ -0,0 +1,476 @@
+#include "service/EvalServer.h"
+#include "search/Certifier.h"
+#include "util/Cli.h"
+#include "util/Format.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace game {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kReadChunk = size_t{64} << 10;
+
+uint32_t get_u16(std::string_view in, size_t at) {
+    return uint32_t{static_cast<uint8_t>(in[at])} | uint32_t{static_cast<uint8_t>(in[at + 1])} << 8;
+}
+
+uint32_t get_u32(std::string_view in, size_t at) {
+    return get_u16(in, at) | get_u16(in, at + 2) << 16;
+}
+
+void put_u8(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+void put_u16(std::string& out, uint32_t value) {
+    put_u8(out, value);
+    put_u8(out, value >> 8);
+}
+
+void put_u32(std::string& out, uint32_t value) {
+    put_u16(out, value & 0xFFFF);
+    put_u16(out, value >> 16);
+}
+
+void put_u64(std::string& out, uint64_t value) {
+    put_u32(out, static_cast<uint32_t>(value));
+    put_u32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void put_f64(std::string& out, double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_u64(out, bits);
+}
+
+void parse_text_line(const std::string& line, EvalRequest& request) {
+    std::istringstream iss(line);
+    std::string id, op, cols;
+    iss >> id >> op >> cols;
+    try {
+        size_t end = 0;
+        unsigned long value = std::stoul(id, &end);
+        if (end != id.size() || value > 0xFFFFFFFFul) throw std::out_of_range(id);
+        request.id = static_cast<uint32_t>(value);
+    } catch (const std::exception&) {
+        request.error = "Invalid request id '" + id + "'";
+        return;
+    }
+
+    if (op == "potential") {
+        request.op = EvalOp::Potential;
+    } else if (op == "histogram") {
+        request.op = EvalOp::Histogram;
+    } else if (op == "win") {
+        request.op = EvalOp::WinCheck;
+    } else if (op.rfind("certify", 0) == 0) {
+        request.op = EvalOp::Certificate;
+        if (op.size() > 7) {
+            if (op[7] != ':') {
+                request.error = "Unknown op '" + op + "'";
+                return;
+            }
+            try {
+                request.depth = std::stoi(op.substr(8));
+            } catch (const std::exception&) {
+                request.depth = -1;
+            }
+            if (request.depth < 0 || request.depth > EvalServer::kMaxDepth) {
+                request.error = "Invalid certificate depth in '" + op + "'";
+                return;
+            }
+        }
+    } else {
+        request.error = "Unknown op '" + op + "'";
+        return;
+    }
+
+    try {
+        request.num_cols = std::stoi(cols);
+    } catch (const std::exception&) {
+        request.error = "Invalid width '" + cols + "'";
+        return;
+    }
+    try {
+        std::string rest;
+        std::getline(iss, rest);
+        request.moves = CliParser::parse_moves(rest);
+    } catch (const std::exception& e) {
+        request.error = e.what();
+    }
+}
+
+void write_all(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Write failed: ") + std::strerror(errno));
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+bool input_ready(int fd) {
+    pollfd pfd{fd, POLLIN, 0};
+    return ::poll(&pfd, 1, 0) > 0;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    auto rank = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+} // namespace
+
+EvalServer::EvalServer(ServeOptions options)
+    : options_(options)
+    , pool_(options.threads) {
+    if (options.max_batch <= 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+}
+
+EvalResponse EvalServer::evaluate(const EvalRequest& request) {
+    EvalResponse response;
+    response.id = request.id;
+    response.op = request.op;
+    response.binary = request.binary;
+    if (!request.error.empty()) {
+        response.error = request.error;
+        return response;
+    }
+
+    try {
+        if (request.num_cols <= 0 || request.num_cols > kMaxCols) {
+            throw std::invalid_argument("Width must be between 1 and " + std::to_string(kMaxCols));
+        }
+        auto tables = tables_.get(request.num_cols);
+        const WidthTables& t = *tables;
+
+        Board board(request.num_cols);
+        for (size_t i = 0; i < request.moves.size(); ++i) {
+            const Cell& cell = request.moves[i];
+            if (!board.is_valid(cell)) {
+                throw std::out_of_range("Move " + Formatter::format_cell(cell) + " out of bounds");
+            }
+            if (!board.is_empty(cell)) {
+                throw std::invalid_argument("Cell " + Formatter::format_cell(cell) + " already taken");
+            }
+            board.set(cell, i % 2 == 0 ? CellState::Maker : CellState::Breaker);
+        }
+
+        switch (request.op) {
+            case EvalOp::Potential:
+            case EvalOp::Histogram: {
+                PotentialCalculator calc(board, t.edges);
+                response.potential = calc.compute_potential();
+                if (request.op == EvalOp::Histogram) {
+                    response.histogram = calc.compute_histogram();
+                }
+                break;
+            }
+            case EvalOp::WinCheck:
+                response.maker_won = t.index->maker_completed_edge(board);
+                break;
+            case EvalOp::Certificate: {
+                if (t.index->maker_completed_edge(board)) {
+                    break;
+                }
+                Player to_move = request.moves.size() % 2 == 0 ? Player::Maker : Player::Breaker;
+                Certifier certifier(board, t.index, {request.depth, BreakerReplies::Greedy});
+                auto result = certifier.certify(to_move);
+                response.certified = result.certified;
+                response.nodes = result.nodes;
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        response.error = e.what();
+    }
+    return response;
+}
+
+bool EvalServer::parse_request(std::string_view input, bool at_end, size_t& consumed,
+                               EvalRequest& request) {
+    request = EvalRequest{};
+    consumed = 0;
+    while (consumed < input.size()) {
+        std::string_view rest = input.substr(consumed);
+
+        if (static_cast<uint8_t>(rest[0]) == kFrameMagic) {
+            if (rest.size() < kFrameHeaderBytes) return false;
+            uint32_t count = get_u16(rest, 10);
+            size_t size = kFrameHeaderBytes + 2 * size_t{count};
+            if (rest.size() < size) return false;
+
+            request.binary = true;
+            request.op = static_cast<EvalOp>(static_cast<uint8_t>(rest[1]));
+            request.depth = static_cast<uint8_t>(rest[2]);
+            request.id = get_u32(rest, 4);
+            request.num_cols = static_cast<int32_t>(get_u16(rest, 8));
+            consumed += size;
+            if (static_cast<uint8_t>(rest[1]) > static_cast<uint8_t>(EvalOp::Certificate)) {
+                request.error = "Unknown op " + std::to_string(static_cast<uint8_t>(rest[1]));
+                return true;
+            }
+            if (request.depth > kMaxDepth) {
+                request.error = "Certificate depth " + std::to_string(request.depth) + " exceeds " +
+                                std::to_string(kMaxDepth);
+                return true;
+            }
+            if (request.num_cols <= 0) {
+                request.error = "Width must be positive";
+                return true;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                auto id = static_cast<int32_t>(get_u16(rest, kFrameHeaderBytes + 2 * size_t{i}));
+                request.moves.push_back({id / request.num_cols, id % request.num_cols});
+            }
+            return true;
+        }
+
+        size_t newline = rest.find('\n');
+        if (newline == std::string_view::npos && !at_end) return false;
+        std::string line(rest.substr(0, newline));
+        consumed += (newline == std::string_view::npos) ? rest.size() : newline + 1;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        parse_text_line(line, request);
+        return true;
+    }
+    return false;
+}
+
+std::string EvalServer::encode_request(const EvalRequest& request) {
+    std::string out;
+    put_u8(out, kFrameMagic);
+    put_u8(out, static_cast<uint32_t>(request.op));
+    put_u8(out, static_cast<uint32_t>(request.depth));
+    put_u8(out, 0);
+    put_u32(out, request.id);
+    put_u16(out, static_cast<uint32_t>(request.num_cols));
+    put_u16(out, static_cast<uint32_t>(request.moves.size()));
+    for (const auto& cell : request.moves) {
+        put_u16(out, static_cast<uint32_t>(cell.row * request.num_cols + cell.col));
+    }
+    return out;
+}
+
+void EvalServer::format_response(const EvalResponse& response, std::string& out) {
+    if (!response.binary) {
+        std::ostringstream oss;
+        oss << response.id;
+        if (!response.error.empty()) {
+            oss << " error " << response.error << "\n";
+            out += oss.str();
+            return;
+        }
+        oss << " ok";
+        switch (response.op) {
+            case EvalOp::Histogram:
+                oss << " hist=";
+                for (size_t l = 0; l < response.histogram.size(); ++l) {
+                    oss << (l > 0 ? "," : "") << response.histogram[l];
+                }
+                [[fallthrough]];
+            case EvalOp::Potential:
+                oss << " pot=" << Formatter::format_potential(response.potential);
+                break;
+            case EvalOp::WinCheck:
+                oss << " maker_won=" << (response.maker_won ? "true" : "false");
+                break;
+            case EvalOp::Certificate:
+                oss << " certified=" << (response.certified ? "true" : "false")
+                    << " nodes=" << response.nodes;
+                break;
+        }
+        oss << "\n";
+        out += oss.str();
+        return;
+    }
+
+    std::string payload;
+    if (!response.error.empty()) {
+        payload = response.error;
+    } else {
+        switch (response.op) {
+            case EvalOp::Histogram:
+                for (int32_t count : response.histogram) {
+                    put_u32(payload, static_cast<uint32_t>(count));
+                }
+                put_f64(payload, response.potential);
+                break;
+            case EvalOp::Potential:
+                put_f64(payload, response.potential);
+                break;
+            case EvalOp::WinCheck:
+                put_u8(payload, response.maker_won ? 1 : 0);
+                break;
+            case EvalOp::Certificate:
+                put_u8(payload, response.certified ? 1 : 0);
+                put_u64(payload, static_cast<uint64_t>(response.nodes));
+                break;
+        }
+    }
+    put_u8(out, kFrameMagic);
+    put_u8(out, static_cast<uint32_t>(response.op));
+    put_u8(out, response.error.empty() ? 0 : 1);
+    put_u8(out, 0);
+    put_u32(out, response.id);
+    put_u32(out, static_cast<uint32_t>(payload.size()));
+    out += payload;
+}
+
+ServeStats EvalServer::serve(int in_fd, int out_fd) {
+    auto start = Clock::now();
+    ServeStats stats;
+    std::vector<double> latencies;
+
+    std::string buffer;
+    size_t pos = 0;
+    bool at_end = false;
+    std::vector<EvalRequest> batch;
+    std::vector<Clock::time_point> arrived;
+    std::vector<EvalResponse> responses;
+    std::string out;
+
+    while (true) {
+        EvalRequest request;
+        size_t consumed = 0;
+        while (batch.size() < static_cast<size_t>(options_.max_batch)) {
+            bool parsed = parse_request(std::string_view(buffer).substr(pos), at_end, consumed, request);
+            pos += consumed;  // Includes blank lines skipped before an incomplete request
+            if (!parsed) break;
+            batch.push_back(std::move(request));
+            arrived.push_back(Clock::now());
+        }
+
+        // Respond once nothing more is waiting, so a lone client is never held back
+        if (!batch.empty() && (batch.size() >= static_cast<size_t>(options_.max_batch) || at_end ||
+                               !input_ready(in_fd))) {
+            responses.resize(batch.size());
+            pool_.parallel_for(static_cast<int64_t>(batch.size()), [&](int64_t i) {
+                responses[static_cast<size_t>(i)] = evaluate(batch[static_cast<size_t>(i)]);
+            });
+            out.clear();
+            for (const auto& response : responses) {
+                format_response(response, out);
+            }
+            write_all(out_fd, out);
+
+            auto done = Clock::now();
+            for (const auto& t : arrived) {
+                latencies.push_back(std::chrono::duration<double, std::micro>(done - t).count());
+            }
+            stats.requests += static_cast<int64_t>(batch.size());
+            ++stats.batches;
+            batch.clear();
+            arrived.clear();
+            continue;
+        }
+        if (at_end) {
+            break;
+        }
+
+        buffer.erase(0, pos);
+        pos = 0;
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + kReadChunk);
+        ssize_t n = ::read(in_fd, buffer.data() + old_size, kReadChunk);
+        if (n < 0 && errno == EINTR) {
+            buffer.resize(old_size);
+            continue;
+        }
+        if (n < 0) {
+            throw std::runtime_error(std::string("Read failed: ") + std::strerror(errno));
+        }
+        buffer.resize(old_size + static_cast<size_t>(n));
+        at_end = (n == 0);
+    }
+    if (pos < buffer.size()) {
+        std::cerr << "Discarding " << buffer.size() - pos << " bytes of incomplete frame\n";
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    stats.p50_us = percentile(latencies, 0.50);
+    stats.p90_us = percentile(latencies, 0.90);
+    stats.p99_us = percentile(latencies, 0.99);
+    stats.max_us = latencies.empty() ? 0.0 : latencies.back();
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return stats;
+}
+
+void EvalServer::serve_socket(const std::string& path, void (*report)(const ServeStats&)) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // A client that disconnects early must end its session, not the daemon
+    ::signal(SIGPIPE, SIG_IGN);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listener, 64) < 0) {
+        int error = errno;
+        ::close(listener);
+        throw std::runtime_error("Cannot listen on " + path + ": " + std::strerror(error));
+    }
+
+    std::mutex sessions_mutex;
+    std::condition_variable sessions_done;
+    int32_t sessions = 0;
+    while (true) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex);
+            ++sessions;
+        }
+        std::thread([&, client] {
+            try {
+                ServeStats stats = serve(client, client);
+                if (report) report(stats);
+            } catch (const std::exception& e) {
+                std::cerr << "Session error: " << e.what() << "\n";
+            }
+            ::close(client);
+            std::lock_guard<std::mutex> lock(sessions_mutex);
+            if (--sessions == 0) sessions_done.notify_all();
+        }).detach();
+    }
+    ::close(listener);
+
+    std::unique_lock<std::mutex> lock(sessions_mutex);
+    sessions_done.wait(lock, [&] { return sessions == 0; });
+}
+
+} // namespace game
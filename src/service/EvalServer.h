@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/Board.h"
+#include "metrics/Potential.h"
+#include "service/WidthCache.h"
+#include "util/ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game {
+
+enum class EvalOp : uint8_t {
+    Potential = 0,
+    Histogram = 1,
+    WinCheck = 2,
+    Certificate = 3
+};
+
+// One position query. Text requests are single lines
+//
+//     <id> <op> <n> [r,c ...]
+//
+// with op one of potential, histogram, win, certify or certify:<depth>, and
+// the moves played from the empty board, Maker first. Depths above
+// EvalServer::kMaxDepth are refused. Binary frames carry the same fields in
+// a 12-byte little-endian header
+//
+//     0xB7 | op u8 | depth u8 | 0 | id u32 | n u16 | count u16
+//
+// followed by `count` u16 cell ids (row * n + col). Responses use the framing
+// of their request.
+struct EvalRequest {
+    uint32_t id = 0;
+    EvalOp op = EvalOp::Potential;
+    int32_t num_cols = 0;
+    int32_t depth = 0;          // Certificate lookahead in plies
+    std::vector<Cell> moves;
+    bool binary = false;
+    std::string error;          // Set when the request could not be parsed
+};
+
+// Text: "<id> ok <fields>" or "<id> error <message>". Binary:
+//
+//     0xB7 | op u8 | status u8 (0 ok, 1 error) | 0 | id u32 | length u32
+//
+// then the payload: potential f64; histogram 7 x u32 then f64; win u8;
+// certificate u8 then nodes u64; or the error message bytes.
+struct EvalResponse {
+    uint32_t id = 0;
+    EvalOp op = EvalOp::Potential;
+    bool binary = false;
+    std::string error;
+    double potential = 0.0;
+    LLineHistogram histogram{};
+    bool maker_won = false;
+    bool certified = false;
+    int64_t nodes = 0;
+};
+
+struct ServeOptions {
+    int32_t threads = 1;
+    int32_t max_batch = 256;  // Requests evaluated together before responding
+};
+
+struct ServeStats {
+    int64_t requests = 0;
+    int64_t batches = 0;
+    double seconds = 0.0;
+    double p50_us = 0.0;      // Latency from request arrival to response write
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+// Evaluation daemon. Edges and the cell/edge incidence index of each width
+// are generated on first use and shared by every later request. Input is
+// read in chunks; whatever requests are already buffered (up to max_batch)
+// form a batch that is evaluated across the thread pool, and the batch's
+// responses are written back in request order before more input is read.
+class EvalServer {
+public:
+    static constexpr uint8_t kFrameMagic = 0xB7;
+    static constexpr size_t kFrameHeaderBytes = 12;
+    static constexpr int32_t kMaxCols = 4096;
+    static constexpr int32_t kMaxDepth = 64;   // Certificate lookahead, in text and binary requests
+
+    explicit EvalServer(ServeOptions options);
+
+    // Serve one stream until end of input
+    ServeStats serve(int in_fd, int out_fd);
+
+    // Accept connections on a Unix domain socket, one session per client.
+    // Runs until accept fails; `report` is called as each session ends.
+    void serve_socket(const std::string& path, void (*report)(const ServeStats&));
+
+    EvalResponse evaluate(const EvalRequest& request);
+
+    // Parse the first request in `input`. Returns false when it is not yet
+    // complete; with `at_end` a final text line needs no newline. Malformed
+    // requests are returned with `error` set.
+    static bool parse_request(std::string_view input, bool at_end, size_t& consumed,
+                              EvalRequest& request);
+    static std::string encode_request(const EvalRequest& request);
+    static void format_response(const EvalResponse& response, std::string& out);
+
+private:
+    ServeOptions options_;
+    ThreadPool pool_;
+    WidthCache tables_;
+};
+
+} // namespace game
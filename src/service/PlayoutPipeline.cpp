@@ -0,0 +1,549 @@
+#include "service/PlayoutPipeline.h"
+#include "metrics/IncrementalPotential.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace game {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint8_t kMakerWin = 1;
+constexpr uint8_t kBreakerCert = 2;
+
+// Moves drawn for games first_game, first_game + 1, ...; game i played
+// cells[ends[i - 1]] up to cells[ends[i]]
+struct MoveBlock {
+    int64_t sequence = 0;
+    int64_t first_game = 0;
+    std::vector<int32_t> cells;
+    std::vector<size_t> ends;
+};
+
+// One entry per ply played, in the same layout; a game stops at Maker's win
+struct ResultBlock {
+    int64_t sequence = 0;
+    int64_t first_game = 0;
+    std::vector<int32_t> cells;
+    std::vector<size_t> ends;
+    std::vector<int64_t> scaled_pots;  // pot(b) * IncrementalPotential::kScale
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> lines;      // x_1..x_k of each ply, k entries apiece
+};
+
+// Per-game generator. Seeding an mt19937 through seed_seq costs tens of
+// microseconds, more than the rest of a game's generation; splitmix64 seeds
+// from (seed, g) in one step and is uniform enough for move picks.
+class SplitMix64 {
+public:
+    using result_type = uint64_t;
+
+    SplitMix64(uint32_t seed, int64_t game)
+        : state_((static_cast<uint64_t>(seed) << 32) ^ static_cast<uint64_t>(game)) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type{0}; }
+
+    result_type operator()() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state_;
+};
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename T>
+bool timed_pop(BoundedQueue<T>& queue, T& value, double& wait) {
+    auto start = Clock::now();
+    bool popped = queue.pop(value);
+    wait += seconds_since(start);
+    return popped;
+}
+
+template <typename T>
+void timed_push(BoundedQueue<T>& queue, T value, double& wait) {
+    auto start = Clock::now();
+    queue.push(std::move(value));
+    wait += seconds_since(start);
+}
+
+// Queue figures over several segments, each with its own rings
+void add_queue_stats(QueueStats& total, const QueueStats& part) {
+    int64_t pushes = total.pushes + part.pushes;
+    if (pushes > 0) {
+        total.mean_occupancy = (total.mean_occupancy * static_cast<double>(total.pushes) +
+                                part.mean_occupancy * static_cast<double>(part.pushes)) /
+                               static_cast<double>(pushes);
+    }
+    total.capacity = part.capacity;
+    total.pushes = pushes;
+    total.max_occupancy = std::max(total.max_occupancy, part.max_occupancy);
+    total.full_waits += part.full_waits;
+    total.empty_waits += part.empty_waits;
+}
+
+template <typename T>
+void append_number(std::string& out, T value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+void append_potential(std::string& out, double value) {
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 6);
+    out.append(buf, result.ptr);
+}
+
+void format_block(const ResultBlock& block, int32_t num_cols, int32_t line_length, std::string& out) {
+    out.clear();
+    size_t begin = 0;
+    for (size_t g = 0; g < block.ends.size(); ++g) {
+        int64_t game = block.first_game + static_cast<int64_t>(g);
+        for (size_t i = begin; i < block.ends[g]; ++i) {
+            auto move = static_cast<int64_t>(i - begin) + 1;
+            append_number(out, game);
+            out += ',';
+            append_number(out, move);
+            out += (move % 2 == 1) ? ",m," : ",b,";
+            append_number(out, block.cells[i] / num_cols);
+            out += ',';
+            append_number(out, block.cells[i] % num_cols);
+            for (int32_t l = 0; l < line_length; ++l) {
+                out += ',';
+                append_number(out, block.lines[i * static_cast<size_t>(line_length) + static_cast<size_t>(l)]);
+            }
+            out += ',';
+            append_potential(out, static_cast<double>(block.scaled_pots[i]) /
+                                      static_cast<double>(IncrementalPotential::kScale));
+            out += (block.flags[i] & kMakerWin) ? ",1" : ",0";
+            out += (block.flags[i] & kBreakerCert) ? ",1\n" : ",0\n";
+        }
+        begin = block.ends[g];
+    }
+}
+
+} // namespace
+
+PlayoutPipeline::PlayoutPipeline(PipelineOptions options)
+    : options_(options) {
+    if (options_.games < 1) {
+        throw std::invalid_argument("The pipeline needs at least one game");
+    }
+    if (options_.generate_threads < 1 || options_.evaluate_threads < 1 || options_.write_threads < 1) {
+        throw std::invalid_argument("Every pipeline stage needs at least one thread");
+    }
+    if (options_.games_per_block < 1 || options_.queue_blocks < 1) {
+        throw std::invalid_argument("Pipeline blocks and queues must hold at least one entry");
+    }
+    if (options_.max_moves < 0) {
+        throw std::invalid_argument("Maximum moves must not be negative");
+    }
+    edges_ = EdgeGenerator::generate_edges(options_.num_cols, options_.num_rows, options_.line_length);
+}
+
+int32_t PlayoutPipeline::max_plies() const {
+    return std::min(options_.max_moves, options_.num_cols * options_.num_rows);
+}
+
+PipelineStats PlayoutPipeline::run(std::ostream& out) {
+    return execute(&out, nullptr);
+}
+
+PipelineStats PlayoutPipeline::run(TrajectoryStats& trajectories) {
+    if (trajectories.max_plies() != max_plies() || trajectories.line_length() != options_.line_length) {
+        throw std::invalid_argument("Trajectory statistics do not match the pipeline's games");
+    }
+    return execute(nullptr, &trajectories);
+}
+
+PipelineStats PlayoutPipeline::execute(std::ostream* out, TrajectoryStats* trajectories) {
+    const PipelineOptions& o = options_;
+    const int64_t per_block = o.games_per_block;
+    const int64_t num_blocks = (o.games + per_block - 1) / per_block;
+    const auto num_cells = static_cast<size_t>(o.num_cols) * static_cast<size_t>(o.num_rows);
+    const auto moves_per_game = std::min(static_cast<size_t>(o.max_moves), num_cells);
+    const auto stride = static_cast<size_t>(o.line_length);
+    auto start = Clock::now();
+
+    std::atomic<bool> failed{false};
+    std::mutex stats_mutex;
+    std::exception_ptr error;
+    PipelineStats stats;
+    stats.generate.threads = o.generate_threads;
+    stats.evaluate.threads = o.evaluate_threads;
+    stats.write.threads = o.write_threads;
+
+    // Identifies the run a checkpoint belongs to; thread counts may differ
+    const CheckpointOptions& checkpoint = o.checkpoint;
+    CheckpointBuffer identity;
+    identity.put(o.num_cols);
+    identity.put(o.num_rows);
+    identity.put(o.line_length);
+    identity.put(o.games);
+    identity.put(o.max_moves);
+    identity.put(o.seed);
+    identity.put(o.games_per_block);
+    identity.put(static_cast<uint8_t>(trajectories ? 1 : 0));
+
+    // Blocks below done_blocks are finished: written, or folded into
+    // `trajectories`. Game g's moves depend only on (seed, g), so that and
+    // the output offset are the whole RNG and output state.
+    int64_t done_blocks = 0;
+    int64_t bytes_written = 0;
+    int64_t done_positions = 0;
+    std::optional<std::string> payload;
+    if (checkpoint.resume && !checkpoint.path.empty()) {
+        payload = Checkpoint::read(checkpoint.path, CheckpointKind::Simulate);
+    }
+    if (payload) {
+        CheckpointReader in(*payload);
+        std::string saved(identity.data().size(), '\0');
+        in.get_bytes(saved.data(), saved.size());
+        if (saved != identity.data()) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " is for another board, seed or game count");
+        }
+        done_blocks = in.get<int64_t>();
+        bytes_written = in.get<int64_t>();
+        done_positions = in.get<int64_t>();
+        stats.maker_wins = in.get<int64_t>();
+        if (done_blocks < 0 || done_blocks > num_blocks) {
+            throw std::runtime_error("Checkpoint " + checkpoint.path + " has a block count out of range");
+        }
+        if (trajectories) {
+            trajectories->load(in);
+        }
+        if (out && !out->seekp(bytes_written)) {
+            throw std::runtime_error("Cannot resume: the output is not seekable");
+        }
+    } else if (out) {
+        std::string header = "game,move,player,row,col";
+        for (int32_t l = 1; l <= o.line_length; ++l) {
+            header += ",x" + std::to_string(l);
+        }
+        header += ",pot,maker_win,breaker_cert\n";
+        out->write(header.data(), static_cast<std::streamsize>(header.size()));
+        bytes_written = static_cast<int64_t>(header.size());
+    }
+
+    // Taken between segments, when every block below done_blocks is out
+    auto snapshot = [&] {
+        CheckpointBuffer buffer;
+        buffer.put_bytes(identity.data().data(), identity.data().size());
+        buffer.put(done_blocks);
+        buffer.put(bytes_written);
+        buffer.put(done_positions + stats.evaluate.items);
+        buffer.put(stats.maker_wins);
+        if (trajectories) {
+            trajectories->save(buffer);
+        }
+        return std::move(buffer.data());
+    };
+    std::optional<CheckpointWriter> writer;
+    if (!checkpoint.path.empty()) {
+        writer.emplace(checkpoint.path, CheckpointKind::Simulate);
+    }
+    CheckpointTimer timer(checkpoint.interval_seconds);
+    auto stopped = [&] { return writer && checkpoint.stop && checkpoint.stop->load(std::memory_order_relaxed); };
+
+    // Every block in flight fits in a ring or a stage, so the window only
+    // holds back generators while one block lags far behind the others
+    const int64_t window = 2 * static_cast<int64_t>(o.queue_blocks) + o.generate_threads + o.evaluate_threads +
+                           o.write_threads;
+
+    // With checkpoints the run goes in segments: when one is due, the
+    // generators stop taking blocks and the stages drain, which leaves a
+    // prefix of the blocks finished. Without them there is a single segment.
+    while (done_blocks < num_blocks) {
+        BoundedQueue<MoveBlock> moves(o.queue_blocks);
+        BoundedQueue<ResultBlock> results(o.queue_blocks);
+        std::atomic<int64_t> next_block{done_blocks};
+        std::atomic<int32_t> generators_left{o.generate_threads};
+        std::atomic<int32_t> evaluators_left{o.evaluate_threads};
+        std::atomic<bool> draining{false};
+
+        // Writers park finished text here until every earlier block is out.
+        // Generators take no block past the window, which bounds the map.
+        std::mutex order_mutex;
+        std::condition_variable window_open;
+        std::map<int64_t, std::string> pending;
+        int64_t next_write = done_blocks;
+
+        // Closing both rings wakes every blocked stage so the threads can exit
+        auto fail = [&] {
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                if (!error) error = std::current_exception();
+                failed.store(true);
+                moves.close();
+                results.close();
+            }
+            std::lock_guard<std::mutex> lock(order_mutex);
+            window_open.notify_all();
+        };
+
+        auto merge = [&](StageStats& total, const StageStats& local, Clock::time_point since) {
+            double waits = local.input_wait_seconds + local.output_wait_seconds;
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            total.blocks += local.blocks;
+            total.items += local.items;
+            total.busy_seconds += std::max(seconds_since(since) - waits, 0.0);
+            total.input_wait_seconds += local.input_wait_seconds;
+            total.output_wait_seconds += local.output_wait_seconds;
+        };
+
+        // True once this segment should end. Checked after each block, so
+        // every segment makes progress.
+        auto drain = [&] {
+            if (writer && !draining.load(std::memory_order_relaxed) && (stopped() || timer.claim())) {
+                draining.store(true, std::memory_order_relaxed);
+            }
+            return draining.load(std::memory_order_relaxed);
+        };
+
+        auto generate = [&] {
+            StageStats local;
+            auto since = Clock::now();
+            try {
+                std::vector<int32_t> empty(num_cells);
+                while (!failed.load()) {
+                    int64_t b = next_block.fetch_add(1);
+                    if (b >= num_blocks) break;
+                    if (!trajectories) {
+                        auto waiting = Clock::now();
+                        std::unique_lock<std::mutex> lock(order_mutex);
+                        window_open.wait(lock, [&] { return failed.load() || b < next_write + window; });
+                        local.output_wait_seconds += seconds_since(waiting);
+                        if (failed.load()) break;
+                    }
+                    MoveBlock block;
+                    block.sequence = b;
+                    block.first_game = b * per_block;
+                    int64_t last = std::min(o.games, block.first_game + per_block);
+                    block.cells.reserve(static_cast<size_t>(last - block.first_game) * moves_per_game);
+                    for (int64_t g = block.first_game; g < last; ++g) {
+                        // The move rule of simulate: a uniform pick from the empty cells
+                        SplitMix64 rng(o.seed, g);
+                        for (size_t i = 0; i < empty.size(); ++i) {
+                            empty[i] = static_cast<int32_t>(i);
+                        }
+                        size_t remaining = empty.size();
+                        for (size_t m = 0; m < moves_per_game; ++m, --remaining) {
+                            std::uniform_int_distribution<size_t> dist(0, remaining - 1);
+                            std::swap(empty[dist(rng)], empty[remaining - 1]);
+                            block.cells.push_back(empty[remaining - 1]);
+                        }
+                        block.ends.push_back(block.cells.size());
+                    }
+                    local.items += last - block.first_game;
+                    ++local.blocks;
+                    timed_push(moves, std::move(block), local.output_wait_seconds);
+                    if (drain()) break;
+                }
+            } catch (...) {
+                fail();
+            }
+            merge(stats.generate, local, since);
+            if (generators_left.fetch_sub(1) == 1) {
+                moves.close();
+            }
+        };
+
+        auto evaluate = [&] {
+            StageStats local;
+            int64_t maker_wins = 0;
+            auto since = Clock::now();
+            try {
+                IncrementalPotential tracker(Board(o.num_cols, o.num_rows), edges_, o.line_length);
+                MoveBlock block;
+                while (!failed.load() && timed_pop(moves, block, local.input_wait_seconds)) {
+                    ResultBlock result;
+                    result.sequence = block.sequence;
+                    result.first_game = block.first_game;
+                    result.cells.reserve(block.cells.size());
+                    result.scaled_pots.reserve(block.cells.size());
+                    result.flags.reserve(block.cells.size());
+                    result.lines.reserve(block.cells.size() * stride);
+                    size_t begin = 0;
+                    for (size_t end : block.ends) {
+                        bool maker_turn = true;
+                        for (size_t i = begin; i < end && !tracker.maker_won(); ++i) {
+                            // Certificate checked BEFORE Breaker's move, as in simulate
+                            bool cert = !maker_turn && tracker.has_breaker_certificate();
+                            tracker.place(block.cells[i], maker_turn ? CellState::Maker : CellState::Breaker);
+                            result.cells.push_back(block.cells[i]);
+                            result.scaled_pots.push_back(tracker.scaled_potential());
+                            result.flags.push_back(static_cast<uint8_t>((tracker.maker_won() ? kMakerWin : 0) |
+                                                                        (cert ? kBreakerCert : 0)));
+                            const LLineHistogram& hist = tracker.histogram();
+                            for (size_t l = 0; l < stride; ++l) {
+                                result.lines.push_back(hist[l]);
+                            }
+                            maker_turn = !maker_turn;
+                        }
+                        maker_wins += tracker.maker_won() ? 1 : 0;
+                        local.items += tracker.num_placed();
+                        while (tracker.num_placed() > 0) {
+                            tracker.undo();
+                        }
+                        result.ends.push_back(result.cells.size());
+                        begin = end;
+                    }
+                    ++local.blocks;
+                    timed_push(results, std::move(result), local.output_wait_seconds);
+                }
+            } catch (...) {
+                fail();
+            }
+            merge(stats.evaluate, local, since);
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                stats.maker_wins += maker_wins;
+            }
+            if (evaluators_left.fetch_sub(1) == 1) {
+                results.close();
+            }
+        };
+
+        // Each summarizing thread folds its games into its own statistics
+        auto summarize = [&] {
+            StageStats local;
+            auto since = Clock::now();
+            try {
+                TrajectoryStats own(trajectories->max_plies(), o.line_length);
+                ResultBlock block;
+                while (!failed.load() && timed_pop(results, block, local.input_wait_seconds)) {
+                    size_t begin = 0;
+                    for (size_t end : block.ends) {
+                        auto plies = static_cast<int32_t>(end - begin);
+                        auto outcome = GameOutcome::Unfinished;
+                        if (plies > 0 && (block.flags[end - 1] & kMakerWin)) {
+                            outcome = GameOutcome::MakerWin;
+                        } else if (static_cast<size_t>(plies) == num_cells) {
+                            outcome = GameOutcome::BoardFull;
+                        }
+                        int32_t cert_move = 0;
+                        for (size_t i = begin; i < end && cert_move == 0; ++i) {
+                            if (block.flags[i] & kBreakerCert) {
+                                cert_move = static_cast<int32_t>(i - begin) + 1;
+                            }
+                        }
+                        own.add_game(outcome, std::span<const int64_t>(block.scaled_pots).subspan(begin, end - begin),
+                                     std::span<const int32_t>(block.lines).subspan(begin * stride,
+                                                                                  (end - begin) * stride),
+                                     cert_move);
+                        begin = end;
+                    }
+                    local.items += static_cast<int64_t>(block.cells.size());
+                    ++local.blocks;
+                    if (checkpoint.on_unit) checkpoint.on_unit();
+                }
+                auto waiting = Clock::now();
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                local.output_wait_seconds += seconds_since(waiting);
+                trajectories->merge(own);
+            } catch (...) {
+                fail();
+            }
+            merge(stats.write, local, since);
+        };
+
+        auto write = [&] {
+            StageStats local;
+            auto since = Clock::now();
+            try {
+                ResultBlock block;
+                std::string text;
+                while (!failed.load() && timed_pop(results, block, local.input_wait_seconds)) {
+                    format_block(block, o.num_cols, o.line_length, text);
+                    local.items += static_cast<int64_t>(block.cells.size());
+                    ++local.blocks;
+
+                    auto waiting = Clock::now();
+                    std::lock_guard<std::mutex> lock(order_mutex);
+                    local.output_wait_seconds += seconds_since(waiting);
+                    pending.emplace(block.sequence, std::move(text));
+                    for (auto it = pending.begin(); it != pending.end() && it->first == next_write;
+                         it = pending.erase(it), ++next_write) {
+                        out->write(it->second.data(), static_cast<std::streamsize>(it->second.size()));
+                        bytes_written += static_cast<int64_t>(it->second.size());
+                    }
+                    window_open.notify_all();
+                    if (!*out) {
+                        throw std::runtime_error("Failed to write playout rows");
+                    }
+                    text = std::string();
+                    if (checkpoint.on_unit) checkpoint.on_unit();
+                }
+            } catch (...) {
+                fail();
+            }
+            merge(stats.write, local, since);
+        };
+
+        std::vector<std::thread> threads;
+        for (int32_t t = 0; t < o.generate_threads; ++t) threads.emplace_back(generate);
+        for (int32_t t = 0; t < o.evaluate_threads; ++t) threads.emplace_back(evaluate);
+        for (int32_t t = 0; t < o.write_threads; ++t) {
+            if (trajectories) {
+                threads.emplace_back(summarize);
+            } else {
+                threads.emplace_back(write);
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        add_queue_stats(stats.moves_queue, moves.stats());
+        add_queue_stats(stats.results_queue, results.stats());
+
+        // Every block taken was finished, so the finished ones are a prefix
+        done_blocks = std::min(next_block.load(), num_blocks);
+        if (writer && done_blocks < num_blocks) {
+            // The checkpoint points into the output, so the rows go first
+            if (out && !out->flush()) {
+                throw std::runtime_error("Failed to write playout rows");
+            }
+            writer->submit(snapshot());
+            if (stopped()) {
+                writer->flush();
+                throw CheckpointInterrupted(checkpoint.path);
+            }
+        }
+    }
+    if (writer) {
+        writer->flush();
+        writer.reset();
+        Checkpoint::remove(checkpoint.path);
+    }
+
+    stats.games = o.games;
+    stats.positions = done_positions + stats.evaluate.items;
+    stats.seconds = seconds_since(start);
+    return stats;
+}
+
+} // namespace game
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/Potential.h"
+#include "metrics/Trajectory.h"
+#include "util/BoundedQueue.h"
+#include "util/Checkpoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace game {
+
+struct PipelineOptions {
+    int32_t num_cols = 10;
+    int32_t num_rows = kDefaultRows;
+    int32_t line_length = kDefaultLineLength;
+    int64_t games = 1;
+    int32_t max_moves = 100;
+    uint32_t seed = 42;
+    int32_t generate_threads = 1;
+    int32_t evaluate_threads = 1;
+    int32_t write_threads = 1;
+    int32_t games_per_block = 64;        // Games handed between stages at once
+    size_t queue_blocks = 16;            // Capacity of each ring, in blocks
+    CheckpointOptions checkpoint;        // Units are blocks written or summarized
+};
+
+struct StageStats {
+    int32_t threads = 0;
+    int64_t blocks = 0;
+    int64_t items = 0;                   // Games generated, positions evaluated or written
+    double busy_seconds = 0.0;           // Summed over the stage's threads
+    double input_wait_seconds = 0.0;     // Waiting for the stage upstream
+    double output_wait_seconds = 0.0;    // Blocked on a full queue downstream
+
+    double items_per_second() const {
+        return busy_seconds > 0.0 ? static_cast<double>(items) / busy_seconds * threads : 0.0;
+    }
+};
+
+struct PipelineStats {
+    StageStats generate;
+    StageStats evaluate;
+    StageStats write;
+    QueueStats moves_queue;              // generate -> evaluate
+    QueueStats results_queue;            // evaluate -> write
+    int64_t games = 0;
+    int64_t positions = 0;
+    int64_t maker_wins = 0;
+    double seconds = 0.0;
+};
+
+// Random playouts as a three-stage pipeline.
+//
+//   generate  Draws each game's moves: a uniformly random empty cell per
+//             ply, Maker first, up to max_moves. Game g is seeded from
+//             (seed, g), so the output does not depend on thread counts.
+//   evaluate  Replays the moves on an IncrementalPotential and records,
+//             after every move, the l-line histogram, pot(b), whether Maker
+//             has won (the game ends there) and whether Breaker held a
+//             certificate (pot < 1 on Breaker's turn) before moving.
+//   write     Formats blocks as CSV rows and writes them in game order,
+//             or, for run(TrajectoryStats&), folds them into statistics.
+//
+// Stages hand over blocks of games_per_block games through two bounded
+// lock-free rings. A full ring blocks the stage feeding it. Formatting runs
+// in parallel and writers park blocks that finish early until the earlier
+// ones are out; generators take no block more than 2 * queue_blocks plus
+// the thread count past the oldest unwritten one, so memory stays bounded
+// by the ring sizes. Only the ordered write is serialized, so a slow output
+// stalls the writers before it stalls evaluation. Output:
+//
+//     game,move,player,row,col,x1,...,xk,pot,maker_win,breaker_cert
+//
+// with player m or b and pot to six decimals, as in eval-file.
+//
+// A checkpoint holds the number of finished blocks, the output offset they
+// end at, the counters and, for run(TrajectoryStats&), the statistics. To
+// take one, the generators stop taking blocks until the stages drain. A
+// resumed run seeks the output to that offset, so it must be seekable.
+class PlayoutPipeline {
+public:
+    explicit PlayoutPipeline(PipelineOptions options);
+
+    // Plies recorded per game: max_moves, or the board size if smaller
+    int32_t max_plies() const;
+
+    PipelineStats run(std::ostream& out);
+
+    // Fold the games into per-ply statistics instead of writing rows; the
+    // last stage's threads each fill their own and merge them at the end.
+    // The statistics must have max_plies() plies and the game's line length.
+    PipelineStats run(TrajectoryStats& trajectories);
+
+private:
+    PipelineOptions options_;
+    std::vector<Hyperedge> edges_;
+
+    // Rows to `out`, or statistics into `trajectories`
+    PipelineStats execute(std::ostream* out, TrajectoryStats* trajectories);
+};
+
+} // namespace game
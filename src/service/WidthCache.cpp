@@ -0,0 +1,66 @@
+#include "service/WidthCache.h"
+#include <stdexcept>
+
+namespace game {
+
+WidthCache::WidthCache(int64_t max_cols)
+    : max_cols_(max_cols) {
+    if (max_cols <= 0) {
+        throw std::invalid_argument("Width cache budget must be positive");
+    }
+}
+
+std::shared_ptr<const WidthTables> WidthCache::get(int32_t num_cols) {
+    std::promise<std::shared_ptr<const WidthTables>> promise;
+    std::shared_future<std::shared_ptr<const WidthTables>> tables;
+    uint64_t created = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = entries_.try_emplace(num_cols);
+        it->second.last_use = ++clock_;
+        if (!inserted) {
+            tables = it->second.tables;
+        } else {
+            it->second.tables = promise.get_future().share();
+            it->second.created = created = it->second.last_use;
+            cached_cols_ += num_cols;
+            evict(num_cols);
+        }
+    }
+    if (tables.valid()) {
+        return tables.get();  // Waits if another thread is still building it
+    }
+
+    try {
+        auto edges = EdgeGenerator::generate_edges(num_cols);
+        auto index = std::make_shared<const EdgeIndex>(num_cols, edges);
+        auto built = std::make_shared<const WidthTables>(WidthTables{std::move(edges), std::move(index)});
+        promise.set_value(built);
+        return built;
+    } catch (...) {
+        // Waiters see the error; later calls try again
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(num_cols);
+        if (it != entries_.end() && it->second.created == created) {
+            cached_cols_ -= num_cols;
+            entries_.erase(it);
+        }
+        throw;
+    }
+}
+
+void WidthCache::evict(int32_t keep) {
+    while (cached_cols_ > max_cols_ && entries_.size() > 1) {
+        auto oldest = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first != keep && (oldest == entries_.end() || it->second.last_use < oldest->second.last_use)) {
+                oldest = it;
+            }
+        }
+        cached_cols_ -= oldest->first;
+        entries_.erase(oldest);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/EdgeIndex.h"
+#include "core/Edges.h"
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace game {
+
+struct WidthTables {
+    std::vector<Hyperedge> edges;
+    std::shared_ptr<const EdgeIndex> index;   // Shared with the trackers built on it
+};
+
+// Edges and incidence index per board width, generated on first use. Safe
+// to share between threads: a width is built once, outside the lock, while
+// other widths are served. Least recently used widths are dropped once the
+// cached widths sum to more than `max_cols` columns (memory grows with the
+// width); callers keep the tables they hold alive.
+class WidthCache {
+public:
+    static constexpr int64_t kDefaultMaxCols = int64_t{1} << 16;
+
+    explicit WidthCache(int64_t max_cols = kDefaultMaxCols);
+
+    std::shared_ptr<const WidthTables> get(int32_t num_cols);
+
+private:
+    struct Entry {
+        std::shared_future<std::shared_ptr<const WidthTables>> tables;
+        uint64_t created = 0;  // Tells a rebuilt entry from an evicted one
+        uint64_t last_use = 0;
+    };
+
+    std::mutex mutex_;
+    int64_t max_cols_;
+    int64_t cached_cols_ = 0;
+    uint64_t clock_ = 0;
+    std::map<int32_t, Entry> entries_;
+
+    void evict(int32_t keep);
+};
+
+} // namespace game
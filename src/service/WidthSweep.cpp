@@ -0,0 +1,232 @@
+#include "service/WidthSweep.h"
+#include "core/EdgeIndex.h"
+#include "core/Edges.h"
+#include "metrics/IncrementalPotential.h"
+#include "util/Format.h"
+#include "util/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace game {
+
+namespace {
+
+constexpr const char* kSolveNames[] = {"unknown", "maker", "breaker"};
+
+void play_games(IncrementalPotential& tracker, int32_t num_cols, const SweepOptions& options, SweepRow& row) {
+    std::vector<int32_t> empty;
+    for (int32_t g = 0; g < options.games; ++g) {
+        std::seed_seq seq{options.seed, static_cast<uint32_t>(num_cols), static_cast<uint32_t>(g)};
+        std::mt19937 rng(seq);
+        empty.resize(static_cast<size_t>(4 * num_cols));
+        for (size_t i = 0; i < empty.size(); ++i) {
+            empty[i] = static_cast<int32_t>(i);
+        }
+
+        bool certified = false;
+        bool maker_turn = true;
+        while (!empty.empty() && !tracker.maker_won()) {
+            if (!maker_turn && !certified && tracker.has_breaker_certificate()) {
+                certified = true;
+            }
+            std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+            size_t pick = dist(rng);
+            std::swap(empty[pick], empty.back());
+            tracker.place(empty.back(), maker_turn ? CellState::Maker : CellState::Breaker);
+            empty.pop_back();
+            maker_turn = !maker_turn;
+        }
+
+        row.maker_wins += tracker.maker_won() ? 1 : 0;
+        row.certified += certified ? 1 : 0;
+        row.moves += tracker.num_placed();
+        while (tracker.num_placed() > 0) {
+            tracker.undo();
+        }
+    }
+}
+
+void put_row(CheckpointBuffer& out, int64_t index, const SweepRow& row) {
+    out.put(index);
+    out.put(row.num_cols);
+    out.put(row.edges);
+    out.put(row.potential);
+    out.put(row.maker_wins);
+    out.put(row.certified);
+    out.put(row.moves);
+    out.put(row.solve);
+    out.put(row.solve_expansions);
+}
+
+SweepRow get_row(CheckpointReader& in) {
+    SweepRow row;
+    row.num_cols = in.get<int32_t>();
+    row.edges = in.get<int64_t>();
+    row.potential = in.get<double>();
+    row.maker_wins = in.get<int32_t>();
+    row.certified = in.get<int32_t>();
+    row.moves = in.get<int64_t>();
+    row.solve = in.get<PnValue>();
+    row.solve_expansions = in.get<int64_t>();
+    return row;
+}
+
+// Identifies the sweep a checkpoint belongs to; the thread count may differ
+void put_identity(CheckpointBuffer& out, const SweepOptions& options) {
+    out.put(options.from);
+    out.put(options.to);
+    out.put(options.games);
+    out.put(options.seed);
+    out.put(options.solve_expansions);
+    out.put(static_cast<uint64_t>(options.solve_memory_bytes));
+}
+
+} // namespace
+
+WidthSweep::WidthSweep(SweepOptions options)
+    : options_(options) {
+    if (options.from < 1 || options.to < options.from) {
+        throw std::invalid_argument("Sweep range must satisfy 1 <= from <= to");
+    }
+    if (options.threads <= 0) {
+        throw std::invalid_argument("Thread count must be positive");
+    }
+    if (options.games < 0) {
+        throw std::invalid_argument("Game count must be non-negative");
+    }
+    if (options.solve_expansions < 0) {
+        throw std::invalid_argument("Solve budget must be non-negative");
+    }
+    if (options.solve_expansions > 0 && int64_t{kDefaultRows} * options.to > 0xFFFF) {
+        throw std::invalid_argument("Widths above " + std::to_string(0xFFFF / kDefaultRows) +
+                                    " are too large to solve");
+    }
+}
+
+std::vector<SweepRow> WidthSweep::run() const {
+    const int64_t count = int64_t{options_.to} - options_.from + 1;
+    std::vector<SweepRow> rows(static_cast<size_t>(count));
+    auto done = std::make_unique<std::atomic<bool>[]>(static_cast<size_t>(count));
+    const CheckpointOptions& checkpoint = options_.checkpoint;
+
+    CheckpointBuffer identity;
+    put_identity(identity, options_);
+    if (checkpoint.resume && !checkpoint.path.empty()) {
+        if (auto payload = Checkpoint::read(checkpoint.path, CheckpointKind::Sweep)) {
+            CheckpointReader in(*payload);
+            std::string saved(identity.data().size(), '\0');
+            in.get_bytes(saved.data(), saved.size());
+            if (saved != identity.data()) {
+                throw std::runtime_error("Checkpoint " + checkpoint.path +
+                                         " is for another sweep range, seed or game count");
+            }
+            auto saved_rows = in.get<uint64_t>();
+            for (uint64_t r = 0; r < saved_rows; ++r) {
+                auto i = in.get<int64_t>();
+                if (i < 0 || i >= count) {
+                    throw std::runtime_error("Checkpoint " + checkpoint.path + " has a row out of range");
+                }
+                rows[static_cast<size_t>(i)] = get_row(in);
+                done[static_cast<size_t>(i)].store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Rows flagged done are final, so a snapshot may run next to the workers
+    auto snapshot = [&] {
+        CheckpointBuffer out;
+        out.put_bytes(identity.data().data(), identity.data().size());
+        std::vector<int64_t> finished;
+        for (int64_t i = 0; i < count; ++i) {
+            if (done[static_cast<size_t>(i)].load(std::memory_order_acquire)) finished.push_back(i);
+        }
+        out.put(static_cast<uint64_t>(finished.size()));
+        for (int64_t i : finished) {
+            put_row(out, i, rows[static_cast<size_t>(i)]);
+        }
+        return std::move(out.data());
+    };
+    std::optional<CheckpointWriter> writer;
+    if (!checkpoint.path.empty()) {
+        writer.emplace(checkpoint.path, CheckpointKind::Sweep);
+    }
+    CheckpointTimer timer(checkpoint.interval_seconds);
+    auto stopped = [&] { return writer && checkpoint.stop && checkpoint.stop->load(std::memory_order_relaxed); };
+
+    // A few runs per thread balance the cost growing with n
+    int64_t run_length = std::clamp<int64_t>(count / (int64_t{options_.threads} * 4), 1, 64);
+    int64_t num_runs = (count + run_length - 1) / run_length;
+    ThreadPool pool(options_.threads);
+    pool.parallel_for(num_runs, [&](int64_t run) {
+        int64_t first = run * run_length;
+        int64_t last = std::min(count, first + run_length);
+        while (first < last && done[static_cast<size_t>(first)].load(std::memory_order_relaxed)) ++first;
+        if (first == last) return;
+        EdgeSweep sweep(options_.from + static_cast<int32_t>(first));
+        for (int64_t i = first; i < last && !stopped(); ++i) {
+            if (i > first) sweep.advance();
+            if (done[static_cast<size_t>(i)].load(std::memory_order_relaxed)) continue;
+            int32_t num_cols = sweep.num_cols();
+            auto index = std::make_shared<const EdgeIndex>(num_cols, sweep.edges());
+            IncrementalPotential tracker(Board(num_cols), index);
+
+            SweepRow& row = rows[static_cast<size_t>(i)];
+            row.num_cols = num_cols;
+            row.edges = static_cast<int64_t>(sweep.edges().size());
+            row.potential = tracker.potential();
+            play_games(tracker, num_cols, options_, row);
+            if (options_.solve_expansions > 0) {
+                PnOptions solve;
+                solve.max_expansions = options_.solve_expansions;
+                solve.memory_limit_bytes = options_.solve_memory_bytes;
+                auto result = ProofNumberSearch(Board(num_cols), index, Player::Maker, solve).solve();
+                row.solve = result.value;
+                row.solve_expansions = result.expansions;
+            }
+            done[static_cast<size_t>(i)].store(true, std::memory_order_release);
+            if (checkpoint.on_unit) checkpoint.on_unit();
+            if (writer && timer.claim()) {
+                writer->submit(snapshot());
+            }
+        }
+    });
+
+    if (writer) {
+        if (stopped()) {
+            writer->submit(snapshot());
+            writer->flush();
+            throw CheckpointInterrupted(checkpoint.path);
+        }
+        writer->flush();
+        writer.reset();
+        Checkpoint::remove(checkpoint.path);
+    }
+    return rows;
+}
+
+void WidthSweep::write_csv(const std::vector<SweepRow>& rows, std::ostream& out) const {
+    out << "n,edges,pot_empty,games,maker_wins,certified,mean_moves,solve,solve_expansions\n";
+    for (const auto& row : rows) {
+        double mean = options_.games > 0 ? static_cast<double>(row.moves) / options_.games : 0.0;
+        char buf[32];
+        auto end = std::to_chars(buf, buf + sizeof(buf), mean, std::chars_format::fixed, 2).ptr;
+        out << row.num_cols << "," << row.edges << "," << Formatter::format_potential(row.potential) << ","
+            << options_.games << "," << row.maker_wins << "," << row.certified << ","
+            << std::string_view(buf, static_cast<size_t>(end - buf)) << ",";
+        if (options_.solve_expansions > 0) {
+            out << kSolveNames[static_cast<size_t>(row.solve)] << "," << row.solve_expansions;
+        } else {
+            out << ",";
+        }
+        out << "\n";
+    }
+}
+
+} // namespace game
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "search/ProofNumber.h"
+#include "util/Checkpoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace game {
+
+struct SweepOptions {
+    int32_t from = 7;
+    int32_t to = 7;
+    int32_t threads = 1;
+    int32_t games = 0;   // Random games per width
+    uint32_t seed = 42;
+    int64_t solve_expansions = 0;                   // Proof-number budget per width, 0 for no solve
+    size_t solve_memory_bytes = size_t{256} << 20;  // Node arena cap of each solve
+    CheckpointOptions checkpoint;
+};
+
+struct SweepRow {
+    int32_t num_cols = 0;
+    int64_t edges = 0;
+    double potential = 0.0;   // Empty board
+    int32_t maker_wins = 0;
+    int32_t certified = 0;    // Games that reached pot(b) < 1 on Breaker's turn
+    int64_t moves = 0;        // Total over the games
+    PnValue solve = PnValue::Unknown;   // Empty board, Maker to move
+    int64_t solve_expansions = 0;
+};
+
+// Runs the per-width analyses for every width in [from, to].
+//
+// Widths are cut into runs of consecutive values that threads claim
+// dynamically. Each run generates its first edge set once and then derives
+// the next ones with EdgeSweep, and reuses one IncrementalPotential per
+// width across its games, undoing the moves after each. Game g at width n
+// draws from a generator seeded by (seed, n, g), so rows do not depend on
+// the thread count. With a solve budget, a proof-number search on the
+// empty board shares the width's edge index with the games.
+//
+// With a checkpoint path, the finished rows are saved periodically. A
+// resumed sweep only computes the missing widths, which gives the same rows
+// as an uninterrupted one. The checkpoint is removed once the sweep is done.
+class WidthSweep {
+public:
+    explicit WidthSweep(SweepOptions options);
+
+    std::vector<SweepRow> run() const;
+
+    // Header and one row per width:
+    //
+    //     n,edges,pot_empty,games,maker_wins,certified,mean_moves,solve,solve_expansions
+    //
+    // with solve maker, breaker or unknown, both left empty without a budget.
+    void write_csv(const std::vector<SweepRow>& rows, std::ostream& out) const;
+
+private:
+    SweepOptions options_;
+};
+
+} // namespace game
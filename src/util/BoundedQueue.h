@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+struct QueueStats {
+    size_t capacity = 0;
+    int64_t pushes = 0;
+    double mean_occupancy = 0.0;    // Items already queued, averaged over pushes
+    int64_t max_occupancy = 0;
+    int64_t full_waits = 0;         // Pushes that found the queue full
+    int64_t empty_waits = 0;        // Pops that found it empty
+};
+
+// Bounded multi-producer multi-consumer ring buffer (Vyukov's scheme).
+//
+// Each slot carries a sequence number that says whether it is ready for the
+// producer or the consumer of a given lap, so push and pop claim a slot with
+// one compare-and-swap and no lock. push() blocks while the ring is full,
+// which is the backpressure on the stage upstream; pop() blocks while it is
+// empty and returns false once close() was called and the ring drained.
+// Waiting spins briefly, then yields, then sleeps.
+template <typename T>
+class BoundedQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit BoundedQueue(size_t capacity)
+        : slots_(std::bit_ceil(std::max<size_t>(capacity, 2)))
+        , mask_(slots_.size() - 1) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool try_push(T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    record_push(pos);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(T value) {
+        if (try_push(value)) return;
+        full_waits_.fetch_add(1, std::memory_order_relaxed);
+        for (int32_t round = 0; !try_push(value); ++round) {
+            if (closed_.load(std::memory_order_acquire)) {
+                throw std::logic_error("push on a closed queue");
+            }
+            backoff(round);
+        }
+    }
+
+    bool pop(T& value) {
+        if (try_pop(value)) return true;
+        empty_waits_.fetch_add(1, std::memory_order_relaxed);
+        for (int32_t round = 0;; ++round) {
+            // Check closed before the last attempt, so an item pushed just
+            // before close() is never missed
+            bool closed = closed_.load(std::memory_order_acquire);
+            if (try_pop(value)) return true;
+            if (closed) return false;
+            backoff(round);
+        }
+    }
+
+    // No more pushes; consumers drain what is left
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    size_t capacity() const { return slots_.size(); }
+
+    QueueStats stats() const {
+        QueueStats stats;
+        stats.capacity = slots_.size();
+        stats.pushes = pushes_.load(std::memory_order_relaxed);
+        stats.mean_occupancy = stats.pushes > 0
+            ? static_cast<double>(occupancy_sum_.load(std::memory_order_relaxed)) / static_cast<double>(stats.pushes)
+            : 0.0;
+        stats.max_occupancy = max_occupancy_.load(std::memory_order_relaxed);
+        stats.full_waits = full_waits_.load(std::memory_order_relaxed);
+        stats.empty_waits = empty_waits_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    // Producers and consumers touch different cache lines
+    std::vector<Slot> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+    std::atomic<int64_t> pushes_{0};
+    std::atomic<int64_t> occupancy_sum_{0};
+    std::atomic<int64_t> max_occupancy_{0};
+    std::atomic<int64_t> full_waits_{0};
+    std::atomic<int64_t> empty_waits_{0};
+
+    void record_push(size_t pos) {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto occupancy = pos > head ? static_cast<int64_t>(pos - head) : int64_t{0};
+        pushes_.fetch_add(1, std::memory_order_relaxed);
+        occupancy_sum_.fetch_add(occupancy, std::memory_order_relaxed);
+        int64_t max = max_occupancy_.load(std::memory_order_relaxed);
+        while (occupancy > max && !max_occupancy_.compare_exchange_weak(max, occupancy, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void backoff(int32_t round) {
+        if (round < 64) return;
+        if (round < 128) {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+};
+
+} // namespace game
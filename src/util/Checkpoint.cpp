@@ -0,0 +1,174 @@
+#include "util/Checkpoint.h"
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace game {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "Checkpoints are written in host byte order");
+
+uint64_t fnv1a(std::string_view data) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (char c : data) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void write_all(int fd, const char* data, size_t size, const std::string& path) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Cannot write " + path + ": " + std::strerror(errno));
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+void Checkpoint::write(const std::string& path, CheckpointKind kind, std::string_view payload) {
+    CheckpointBuffer header;
+    header.put_bytes(kMagic, sizeof(kMagic));
+    header.put(kVersion);
+    header.put(static_cast<uint16_t>(kind));
+    header.put(static_cast<uint64_t>(payload.size()));
+    CheckpointBuffer trailer;
+    trailer.put(fnv1a(payload));
+
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create " + tmp + ": " + std::strerror(errno));
+    }
+    try {
+        write_all(fd, header.data().data(), header.data().size(), tmp);
+        write_all(fd, payload.data(), payload.size(), tmp);
+        write_all(fd, trailer.data().data(), trailer.data().size(), tmp);
+        if (::fsync(fd) < 0) {
+            throw std::runtime_error("Cannot sync " + tmp + ": " + std::strerror(errno));
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace " + path + ": " + std::strerror(errno));
+    }
+}
+
+std::optional<std::string> Checkpoint::read(const std::string& path, CheckpointKind kind) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < kHeaderBytes + 8 || data.compare(0, 4, kMagic, 4) != 0) {
+        throw std::runtime_error(path + " is not a checkpoint file");
+    }
+    CheckpointReader header(std::string_view(data).substr(4, kHeaderBytes - 4));
+    auto version = header.get<uint16_t>();
+    auto file_kind = header.get<uint16_t>();
+    auto bytes = header.get<uint64_t>();
+    if (version != kVersion) {
+        throw std::runtime_error(path + " has checkpoint version " + std::to_string(version) + ", expected " +
+                                 std::to_string(kVersion));
+    }
+    if (file_kind != static_cast<uint16_t>(kind)) {
+        throw std::runtime_error(path + " is a checkpoint of another command");
+    }
+    if (data.size() != kHeaderBytes + bytes + 8) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    std::string payload = data.substr(kHeaderBytes, static_cast<size_t>(bytes));
+    CheckpointReader trailer(std::string_view(data).substr(kHeaderBytes + payload.size()));
+    if (trailer.get<uint64_t>() != fnv1a(payload)) {
+        throw std::runtime_error(path + " fails its checksum");
+    }
+    return payload;
+}
+
+void Checkpoint::remove(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+}
+
+CheckpointWriter::CheckpointWriter(std::string path, CheckpointKind kind, std::function<void()> before_write)
+    : path_(std::move(path))
+    , kind_(kind)
+    , before_write_(std::move(before_write))
+    , thread_([this] { run(); }) {
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    thread_.join();
+}
+
+void CheckpointWriter::submit(std::string payload) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(payload);
+    }
+    changed_.notify_all();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return !pending_ && !writing_; });
+    if (!error_.empty()) {
+        throw std::runtime_error(error_);
+    }
+}
+
+int64_t CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        changed_.wait(lock, [this] { return pending_ || stopping_; });
+        if (!pending_) {
+            return;
+        }
+        std::string payload = std::move(*pending_);
+        pending_.reset();
+        writing_ = true;
+        lock.unlock();
+
+        std::string error;
+        try {
+            if (before_write_) before_write_();
+            Checkpoint::write(path_, kind_, payload);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        lock.lock();
+        writing_ = false;
+        if (error.empty()) {
+            ++written_;
+        } else if (error_.empty()) {
+            error_ = error;
+        }
+        changed_.notify_all();
+    }
+}
+
+} // namespace game
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace game {
+
+enum class CheckpointKind : uint16_t {
+    Sweep = 1,
+    Tablebase = 2,
+    ProofNumber = 3,
+    SolveDist = 4,
+    Simulate = 5
+};
+
+struct CheckpointOptions {
+    std::string path;                          // Empty: no checkpoints
+    double interval_seconds = 60.0;            // Minimum time between two checkpoints
+    bool resume = false;                       // Continue from `path` if it exists
+    const std::atomic<bool>* stop = nullptr;   // Set to stop early after a final checkpoint
+    std::function<void()> on_unit;             // Called after each unit of work, e.g. to set `stop`
+};
+
+// Thrown by a checkpointed run that stopped on request; its checkpoint is on disk
+class CheckpointInterrupted : public std::runtime_error {
+public:
+    explicit CheckpointInterrupted(const std::string& path)
+        : std::runtime_error("Interrupted; resume from checkpoint " + path + " with --resume") {}
+};
+
+// When a worker should take the next snapshot: at most once per interval,
+// claimed by a single caller
+class CheckpointTimer {
+public:
+    explicit CheckpointTimer(double interval_seconds)
+        : interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(interval_seconds)))
+        , due_((std::chrono::steady_clock::now() + interval_).time_since_epoch().count()) {}
+
+    bool claim() {
+        auto now = std::chrono::steady_clock::now();
+        auto due = due_.load(std::memory_order_relaxed);
+        if (now.time_since_epoch().count() < due) return false;
+        return due_.compare_exchange_strong(due, (now + interval_).time_since_epoch().count());
+    }
+
+private:
+    std::chrono::steady_clock::duration interval_;
+    std::atomic<std::chrono::steady_clock::rep> due_;
+};
+
+// Versioned checkpoint files.
+//
+// Layout: "7RCK", u16 version, u16 kind, u64 payload bytes, the payload,
+// then a u64 FNV-1a hash of the payload, all little-endian. Files are
+// written to "<path>.tmp", synced and renamed over `path`, so a crash leaves
+// either the previous checkpoint or the new one.
+class Checkpoint {
+public:
+    static constexpr char kMagic[4] = {'7', 'R', 'C', 'K'};
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 16;
+
+    static void write(const std::string& path, CheckpointKind kind, std::string_view payload);
+
+    // Payload of the checkpoint at `path`, or nullopt if there is none.
+    // Throws if the file is truncated, corrupt, or of another kind or version.
+    static std::optional<std::string> read(const std::string& path, CheckpointKind kind);
+
+    static void remove(const std::string& path);
+};
+
+// Payload encoding helpers, in host (little-endian) byte order
+class CheckpointBuffer {
+public:
+    template <typename T>
+    void put(const T& value) {
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void put_bytes(const void* data, size_t bytes) { data_.append(static_cast<const char*>(data), bytes); }
+
+    std::string& data() { return data_; }
+
+private:
+    std::string data_;
+};
+
+class CheckpointReader {
+public:
+    explicit CheckpointReader(std::string_view data)
+        : data_(data) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        get_bytes(&value, sizeof(T));
+        return value;
+    }
+    void get_bytes(void* out, size_t bytes) {
+        if (data_.size() - offset_ < bytes) {
+            throw std::runtime_error("Checkpoint payload is truncated");
+        }
+        std::memcpy(out, data_.data() + offset_, bytes);
+        offset_ += bytes;
+    }
+    bool at_end() const { return offset_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t offset_ = 0;
+};
+
+// Writes checkpoints on a background thread so workers only pay for the
+// snapshot. A snapshot submitted while another is waiting replaces it; the
+// one being written is always completed. `before_write` runs on the writer
+// thread ahead of each file, e.g. to sync data the snapshot refers to.
+class CheckpointWriter {
+public:
+    CheckpointWriter(std::string path, CheckpointKind kind, std::function<void()> before_write = {});
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    void submit(std::string payload);
+
+    // Wait until every submitted snapshot is written; rethrows a write error
+    void flush();
+
+    int64_t written() const;
+
+private:
+    std::string path_;
+    CheckpointKind kind_;
+    std::function<void()> before_write_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::optional<std::string> pending_;
+    bool writing_ = false;
+    bool stopping_ = false;
+    int64_t written_ = 0;
+    std::string error_;
+    std::thread thread_;
+
+    void run();
+};
+
+} // namespace game
@@ -1,5 +1,6 @@
 #include "util/Cli.h"
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 namespace game {
@@ -20,31 +21,192 @@ CliArgs CliParser::parse(int argc, char* argv[]) {
         std::string arg(argv[i]);
         if (arg == "-n" || arg == "--cols") {
             if (i + 1 < argc) {
-                try {
-                    args.num_cols = std::stoi(argv[++i]);
-                } catch (const std::exception&) {
-                    throw std::invalid_argument("Invalid value for " + arg + ": expected integer");
-                }
+                args.num_cols = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--rows") {
+            if (i + 1 < argc) {
+                args.num_rows = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--k") {
+            if (i + 1 < argc) {
+                args.line_length = parse_int(arg, argv[++i]);
             }
         } else if (arg == "-s" || arg == "--seed") {
             if (i + 1 < argc) {
-                try {
-                    args.seed = std::stoi(argv[++i]);
-                } catch (const std::exception&) {
-                    throw std::invalid_argument("Invalid value for " + arg + ": expected integer");
-                }
+                args.seed = parse_int(arg, argv[++i]);
             }
         } else if (arg == "-m" || arg == "--max-moves") {
             if (i + 1 < argc) {
-                try {
-                    args.max_moves = std::stoi(argv[++i]);
-                } catch (const std::exception&) {
-                    throw std::invalid_argument("Invalid value for " + arg + ": expected integer");
+                args.max_moves = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "-d" || arg == "--depth") {
+            if (i + 1 < argc) {
+                args.depth = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--exhaustive") {
+            args.exhaustive = true;
+        } else if (arg == "--moves") {
+            if (i + 1 < argc) {
+                args.moves = parse_moves(argv[++i]);
+            }
+        } else if (arg == "-i" || arg == "--iterations") {
+            if (i + 1 < argc) {
+                args.iterations = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--time-ms") {
+            if (i + 1 < argc) {
+                args.time_ms = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "-t" || arg == "--threads") {
+            if (i + 1 < argc) {
+                args.threads = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--mem-mb") {
+            if (i + 1 < argc) {
+                args.mem_mb = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--max-expansions") {
+            if (i + 1 < argc) {
+                args.max_expansions = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--socket") {
+            if (i + 1 < argc) {
+                args.socket_path = argv[++i];
+            }
+        } else if (arg == "--batch") {
+            if (i + 1 < argc) {
+                args.batch = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--stop-at-cert") {
+            args.stop_at_certificate = true;
+        } else if (arg == "--no-distinct") {
+            args.count_distinct = false;
+        } else if (arg == "--max-empty") {
+            if (i + 1 < argc) {
+                args.max_empty = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--from") {
+            if (i + 1 < argc) {
+                args.from = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--to") {
+            if (i + 1 < argc) {
+                args.to = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--games") {
+            if (i + 1 < argc) {
+                args.games = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--profile") {
+            args.profile = true;
+        } else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                args.trace = argv[++i];
+            }
+        } else if (arg == "--hw-counters") {
+            args.hw_counters = true;
+        } else if (arg == "--checkpoint") {
+            if (i + 1 < argc) {
+                args.checkpoint = argv[++i];
+            }
+        } else if (arg == "--edges") {
+            if (i + 1 < argc) {
+                args.edges_file = argv[++i];
+            }
+        } else if (arg == "--workers") {
+            if (i + 1 < argc) {
+                args.workers = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--split-depth") {
+            if (i + 1 < argc) {
+                args.split_depth = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--unit-expansions") {
+            if (i + 1 < argc) {
+                args.unit_expansions = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--stage-threads") {
+            if (i + 1 < argc) {
+                std::string text(argv[++i]);
+                std::istringstream iss(text);
+                std::vector<int32_t> counts;
+                std::string token;
+                while (std::getline(iss, token, ',')) {
+                    counts.push_back(parse_int(arg, token.c_str()));
+                }
+                if (counts.size() != 3) {
+                    throw std::invalid_argument("Invalid value for " + arg + ": expected three counts, e.g. 1,2,1");
+                }
+                args.stage_threads = counts;
+            }
+        } else if (arg == "--trajectories") {
+            args.trajectories = true;
+        } else if (arg == "--checkpoint-every") {
+            if (i + 1 < argc) {
+                args.checkpoint_every = parse_int(arg, argv[++i]);
+                if (args.checkpoint_every < 1) {
+                    throw std::invalid_argument("Invalid value for " + arg + ": expected at least 1 second");
+                }
+            }
+        } else if (arg == "--resume") {
+            args.resume = true;
+        } else if (arg == "--periodic") {
+            args.periodic = true;
+        } else if (arg == "--span") {
+            if (i + 1 < argc) {
+                args.span = parse_int(arg, argv[++i]);
+            }
+        } else if (arg == "--tablebase") {
+            if (i + 1 < argc) {
+                args.tablebase = argv[++i];
+            }
+        } else if (arg == "--position") {
+            if (i + 1 < argc) {
+                args.position = argv[++i];
+            }
+        } else if (arg == "--input") {
+            if (i + 1 < argc) {
+                args.input = argv[++i];
+            }
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc) {
+                args.output = argv[++i];
+            }
+        } else if (arg == "--format") {
+            if (i + 1 < argc) {
+                args.format = argv[++i];
+                if (args.format != "csv" && args.format != "text" && args.format != "bin" && args.format != "json") {
+                    throw std::invalid_argument("Invalid value for " + arg + ": expected csv, text, bin or json");
+                }
+            }
+        } else if (arg == "--mode") {
+            if (i + 1 < argc) {
+                args.mode = argv[++i];
+                if (args.mode != "root" && args.mode != "tree") {
+                    throw std::invalid_argument("Invalid value for " + arg + ": expected root or tree");
                 }
             }
         }
     }
     
+    if (args.command == CliCommand::Worker && args.socket_path.empty()) {
+        throw std::invalid_argument("worker needs the coordinator's socket (--socket PATH)");
+    }
+    
+    if (args.resume && args.checkpoint.empty()) {
+        throw std::invalid_argument("--resume needs the checkpoint file (--checkpoint PATH)");
+    }
+    
+    // These work on the (4, n, 7^tr) game only: their tables, file formats
+    // and edge sweeps assume four rows and lines of seven
+    bool default_game = args.num_rows == kDefaultRows && args.line_length == kDefaultLineLength;
+    if (!default_game && (args.command == CliCommand::Serve || args.command == CliCommand::EvalFile ||
+                          args.command == CliCommand::Tablebase || args.command == CliCommand::FindPairing ||
+                          args.command == CliCommand::Sweep || !args.tablebase.empty())) {
+        std::string what = args.tablebase.empty() ? cmd : "--tablebase";
+        throw std::invalid_argument(what + " supports only the 4-row game with k = 7");
+    }
+    
     return args;
 }
 
@@ -52,23 +214,120 @@ CliCommand CliParser::parse_command(const std::string& cmd) {
     if (cmd == "print-edges") return CliCommand::PrintEdges;
     if (cmd == "simulate") return CliCommand::SimulateRandom;
     if (cmd == "potential") return CliCommand::ComputePotential;
+    if (cmd == "certify") return CliCommand::Certify;
+    if (cmd == "decompose") return CliCommand::Decompose;
+    if (cmd == "mcts") return CliCommand::Mcts;
+    if (cmd == "pns") return CliCommand::ProofNumber;
+    if (cmd == "serve") return CliCommand::Serve;
+    if (cmd == "eval-file") return CliCommand::EvalFile;
+    if (cmd == "perft") return CliCommand::Perft;
+    if (cmd == "tablebase") return CliCommand::Tablebase;
+    if (cmd == "find-pairing") return CliCommand::FindPairing;
+    if (cmd == "sweep") return CliCommand::Sweep;
+    if (cmd == "solve-dist") return CliCommand::Distribute;
+    if (cmd == "worker") return CliCommand::Worker;
+    if (cmd == "expected-potential") return CliCommand::ExpectedPotential;
     if (cmd == "help") return CliCommand::Help;
     
     throw std::invalid_argument("Unknown command: " + cmd);
 }
 
+int32_t CliParser::parse_int(const std::string& arg, const char* value) {
+    try {
+        return std::stoi(value);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid value for " + arg + ": expected integer");
+    }
+}
+
+std::vector<Cell> CliParser::parse_moves(const std::string& text) {
+    std::vector<Cell> moves;
+    std::istringstream iss(text);
+    std::string token;
+    while (iss >> token) {
+        size_t comma = token.find(',');
+        if (comma == std::string::npos) {
+            throw std::invalid_argument("Invalid move '" + token + "': expected row,col");
+        }
+        try {
+            moves.push_back({std::stoi(token.substr(0, comma)), std::stoi(token.substr(comma + 1))});
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Invalid move '" + token + "': expected row,col");
+        }
+    }
+    return moves;
+}
+
 void CliParser::print_help() {
     std::cout << "7-in-a-Row Maker-Breaker Game Harness\n\n";
     std::cout << "Usage: game <command> [options]\n\n";
     std::cout << "Commands:\n";
-    std::cout << "  print-edges   Print all hyperedges for the given board size\n";
-    std::cout << "  simulate      Simulate a random game\n";
-    std::cout << "  potential     Compute potential for an empty board\n";
+    std::cout << "  print-edges   Print all hyperedges for the given board size (held in memory)\n";
+    std::cout << "  simulate      Simulate a random game, or --games random games as CSV rows\n";
+    std::cout << "  potential     Compute potential for a position (default: empty board)\n";
+    std::cout << "  certify       Search for a k-ply Breaker potential certificate\n";
+    std::cout << "  decompose     Split a position into independent components\n";
+    std::cout << "  mcts          Search a position with Monte-Carlo tree search\n";
+    std::cout << "  pns           Solve a position with proof-number search\n";
+    std::cout << "  serve         Answer position queries from stdin or a Unix socket\n";
+    std::cout << "  eval-file     Evaluate every position in a file in parallel\n";
+    std::cout << "  perft         Count move sequences and positions to a given depth\n";
+    std::cout << "  tablebase     Solve low-empty positions retrogradely into a bit table\n";
+    std::cout << "  find-pairing  Search for a Breaker pairing strategy, or verify one (--input)\n";
+    std::cout << "  sweep         Analyse every width in a range into one CSV table\n";
+    std::cout << "  solve-dist    Solve a position with proof-number search across worker processes\n";
+    std::cout << "  worker        Join a solve-dist coordinator on --socket\n";
+    std::cout << "  expected-potential  Exact E[x_l] and E[pot] after every ply of random play (CSV)\n";
     std::cout << "  help          Show this help message\n\n";
     std::cout << "Options:\n";
     std::cout << "  -n, --cols <N>        Number of columns (default: 10)\n";
+    std::cout << "  --rows <R>            Number of rows of an (r, n, k^tr) game (default: 4)\n";
+    std::cout << "  --k <K>               Line length k of an (r, n, k^tr) game (default: 7)\n";
     std::cout << "  -s, --seed <S>        Random seed (default: 42)\n";
     std::cout << "  -m, --max-moves <M>   Maximum moves (default: 100)\n";
+    std::cout << "  -d, --depth <K>       Certificate search depth in plies (default: 4)\n";
+    std::cout << "  --exhaustive          Try every Breaker reply instead of the greedy one\n";
+    std::cout << "  --position <P>        Start position, e.g. \"M9/10/10/B9\" (rows split by /)\n";
+    std::cout << "  --moves \"r,c ...\"     Moves played from the start position, alternating\n";
+    std::cout << "  -i, --iterations <I>  MCTS playouts, 0 for time only with --time-ms (default: 10000)\n";
+    std::cout << "  --time-ms <T>         MCTS time budget in milliseconds (default: none)\n";
+    std::cout << "  -t, --threads <P>     Worker threads (default: 1)\n";
+    std::cout << "  --mode <root|tree>    MCTS parallel mode (default: tree)\n";
+    std::cout << "  --mem-mb <M>          Proof-number node arena cap in MiB (default: 256)\n";
+    std::cout << "  --max-expansions <E>  Proof-number expansion budget, 0 for none (default: 0)\n";
+    std::cout << "                        sweep: solve each empty board within E expansions\n";
+    std::cout << "  --socket <PATH>       Serve on a Unix domain socket instead of stdin\n";
+    std::cout << "  --batch <B>           Maximum requests evaluated per batch (default: 256)\n";
+    std::cout << "                        simulate: games handed between pipeline stages at once\n";
+    std::cout << "  --input <PATH>        Position file: notation lines or packed records\n";
+    std::cout << "  -o, --output <PATH>   Output file (default: stdout)\n";
+    std::cout << "  --format <F>          eval-file output: CSV or columnar binary (default: csv)\n";
+    std::cout << "                        simulate --trajectories: csv or json\n";
+    std::cout << "                        print-edges output: text or bin edge list (default: text)\n";
+    std::cout << "  --edges <PATH>        Load the edges from a binary edge list instead of generating them\n";
+    std::cout << "  --stop-at-cert        perft: stop sequences at pot(b) < 1 on Breaker's turn\n";
+    std::cout << "  --no-distinct         perft: skip distinct-position counting\n";
+    std::cout << "  --max-empty <E>       tablebase: deepest layer in empty cells (default: all)\n";
+    std::cout << "  --tablebase <PATH>    potential: also look the position up in a tablebase\n";
+    std::cout << "                        certify, pns: take exact values from it at covered nodes\n";
+    std::cout << "  --periodic            find-pairing: periodic pairing of the infinite strip\n";
+    std::cout << "  --from <A>, --to <B>  sweep: width range (default: 7 to 7)\n";
+    std::cout << "  --games <G>           sweep: random games per width (default: 0)\n";
+    std::cout << "                        expected-potential: Monte-Carlo games to compare against\n";
+    std::cout << "                        simulate: games to play through the pipeline\n";
+    std::cout << "  --stage-threads <G,E,W> simulate: generate, evaluate and write threads (default: 1,1,1)\n";
+    std::cout << "  --trajectories        simulate --games: per-ply pot and x_l distributions by outcome\n";
+    std::cout << "  --span <S>            find-pairing: max column distance in a pair (default: 6)\n";
+    std::cout << "  --workers <W>         solve-dist: worker processes to fork, 0 for external only (default: 2)\n";
+    std::cout << "  --split-depth <D>     solve-dist: plies of the opening frontier (default: 2)\n";
+    std::cout << "  --unit-expansions <E> solve-dist: expansions per unit before it is split (default: 100000)\n";
+    std::cout << "  --checkpoint <PATH>   tablebase, sweep, pns, solve-dist, simulate --games: save progress\n";
+    std::cout << "                        to PATH periodically\n";
+    std::cout << "  --checkpoint-every <S> Seconds between checkpoints (default: 60)\n";
+    std::cout << "  --resume              Continue from --checkpoint; the result is unchanged\n";
+    std::cout << "  --profile             Print scope times and counters to stderr (GAME_INSTRUMENT builds)\n";
+    std::cout << "  --trace <PATH>        Write a Chrome trace of scopes over 1 us (GAME_INSTRUMENT builds)\n";
+    std::cout << "  --hw-counters         Add cycles, instructions and cache misses to --profile\n";
 }
 
 } // namespace game
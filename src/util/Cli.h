@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/Board.h"
+#include "core/Edges.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -9,14 +12,65 @@ enum class CliCommand {
     PrintEdges,
     SimulateRandom,
     ComputePotential,
+    Certify,
+    Decompose,
+    Mcts,
+    ProofNumber,
+    Serve,
+    EvalFile,
+    Perft,
+    Tablebase,
+    FindPairing,
+    Sweep,
+    Distribute,
+    Worker,
+    ExpectedPotential,
     Help
 };
 
 struct CliArgs {
     CliCommand command;
     int32_t num_cols = 10;
+    int32_t num_rows = kDefaultRows;
+    int32_t line_length = kDefaultLineLength;
     int32_t seed = 42;
     int32_t max_moves = 100;
+    int32_t depth = 4;
+    bool exhaustive = false;
+    std::vector<Cell> moves;
+    int32_t iterations = 10000;
+    int32_t time_ms = 0;
+    int32_t threads = 1;
+    std::string mode = "tree";
+    int32_t mem_mb = 256;
+    int32_t max_expansions = 0;
+    std::string socket_path;
+    int32_t batch = 256;
+    std::string position;
+    std::string input;
+    std::string output;
+    std::string format = "csv";
+    std::string edges_file;
+    bool stop_at_certificate = false;
+    bool count_distinct = true;
+    int32_t max_empty = -1;
+    std::string tablebase;
+    bool periodic = false;
+    int32_t span = 6;
+    int32_t from = 7;
+    int32_t to = 7;
+    int32_t games = 0;
+    std::string checkpoint;
+    int32_t checkpoint_every = 60;
+    bool resume = false;
+    int32_t workers = 2;
+    int32_t split_depth = 2;
+    int32_t unit_expansions = 100000;
+    std::vector<int32_t> stage_threads{1, 1, 1};
+    bool trajectories = false;
+    bool profile = false;
+    std::string trace;
+    bool hw_counters = false;
 };
 
 class CliParser {
@@ -24,8 +78,12 @@ public:
     static CliArgs parse(int argc, char* argv[]);
     static void print_help();
     
+    // Parse a move list such as "0,3 1,3 2,4" (row,col pairs, Maker first)
+    static std::vector<Cell> parse_moves(const std::string& text);
+    
 private:
     static CliCommand parse_command(const std::string& cmd);
+    static int32_t parse_int(const std::string& arg, const char* value);
 };
 
 } // namespace game
@@ -0,0 +1,230 @@
+#include "util/EdgeFile.h"
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <unistd.h>
+
+namespace game {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "Edge lists are written in host byte order");
+
+constexpr size_t kBufferBytes = size_t{64} << 10;
+
+// Output buffer flushed to `fd` whenever it fills
+class FdBuffer {
+public:
+    explicit FdBuffer(int fd)
+        : fd_(fd)
+        , buffer_(kBufferBytes) {}
+
+    void put(char c) {
+        if (used_ == buffer_.size()) flush();
+        buffer_[used_++] = c;
+    }
+
+    void put(std::string_view text) {
+        for (char c : text) put(c);
+    }
+
+    template <typename T>
+    void put_number(T value) {
+        // Room for any 64-bit integer
+        if (buffer_.size() - used_ < 24) flush();
+        auto result = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value);
+        used_ = static_cast<size_t>(result.ptr - buffer_.data());
+    }
+
+    template <typename T>
+    void put_raw(T value) {
+        if (buffer_.size() - used_ < sizeof(T)) flush();
+        std::memcpy(buffer_.data() + used_, &value, sizeof(T));
+        used_ += sizeof(T);
+    }
+
+    void flush() {
+        const char* data = buffer_.data();
+        size_t size = used_;
+        while (size > 0) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("Cannot write edges: ") + std::strerror(errno));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        used_ = 0;
+    }
+
+private:
+    int fd_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+};
+
+} // namespace
+
+void EdgeWriter::write_text(int fd, const std::vector<Hyperedge>& edges) {
+    FdBuffer out(fd);
+    out.put("Total edges: ");
+    out.put_number(edges.size());
+    out.put('\n');
+    for (size_t i = 0; i < edges.size(); ++i) {
+        out.put_number(i + 1);
+        out.put(". [");
+        for (size_t c = 0; c < edges[i].size(); ++c) {
+            if (c > 0) out.put(", ");
+            out.put('(');
+            out.put_number(edges[i][c].row);
+            out.put(',');
+            out.put_number(edges[i][c].col);
+            out.put(')');
+        }
+        out.put("]\n");
+    }
+    out.flush();
+}
+
+void EdgeWriter::write_binary(int fd, const std::vector<Hyperedge>& edges, int32_t num_rows, int32_t num_cols,
+                              int32_t line_length) {
+    if (num_rows <= 0 || num_cols <= 0) {
+        throw std::invalid_argument("Binary edge lists need a non-empty board");
+    }
+    bool wide = int64_t{num_rows} * num_cols > 0x10000;
+    FdBuffer out(fd);
+    out.put(std::string_view(EdgeList::kMagic, sizeof(EdgeList::kMagic)));
+    out.put_raw(EdgeList::kVersion);
+    out.put_raw(static_cast<uint16_t>(wide ? 4 : 2));
+    out.put_raw(static_cast<uint32_t>(num_rows));
+    out.put_raw(static_cast<uint32_t>(num_cols));
+    out.put_raw(static_cast<uint32_t>(line_length));
+    out.put_raw(uint32_t{0});
+    out.put_raw(static_cast<uint64_t>(edges.size()));
+
+    uint64_t offset = 0;
+    out.put_raw(offset);
+    for (const auto& edge : edges) {
+        offset += edge.size();
+        out.put_raw(offset);
+    }
+    for (const auto& edge : edges) {
+        for (const auto& cell : edge) {
+            if (cell.row < 0 || cell.row >= num_rows || cell.col < 0 || cell.col >= num_cols) {
+                throw std::invalid_argument("Edge cell outside the board");
+            }
+            auto id = static_cast<uint32_t>(cell.row * num_cols + cell.col);
+            if (wide) {
+                out.put_raw(id);
+            } else {
+                out.put_raw(static_cast<uint16_t>(id));
+            }
+        }
+    }
+    out.flush();
+}
+
+EdgeList::EdgeList(const std::string& path)
+    : file_(path) {
+    std::string_view data = file_.data();
+    if (data.size() < kHeaderBytes || data.compare(0, 4, std::string_view(kMagic, 4)) != 0) {
+        throw std::runtime_error(path + " is not a binary edge list");
+    }
+    auto field = [&](size_t at, auto value) {
+        std::memcpy(&value, data.data() + at, sizeof(value));
+        return value;
+    };
+    if (field(4, uint16_t{}) != kVersion) {
+        throw std::runtime_error(path + " has edge list version " + std::to_string(field(4, uint16_t{})) +
+                                 ", expected " + std::to_string(kVersion));
+    }
+    cell_bytes_ = field(6, uint16_t{});
+    if (cell_bytes_ != 2 && cell_bytes_ != 4) {
+        throw std::runtime_error(path + " has " + std::to_string(cell_bytes_) + "-byte cell ids");
+    }
+    num_rows_ = static_cast<int32_t>(field(8, uint32_t{}));
+    num_cols_ = static_cast<int32_t>(field(12, uint32_t{}));
+    line_length_ = static_cast<int32_t>(field(16, uint32_t{}));
+    if (num_rows_ <= 0 || num_cols_ <= 0 || int64_t{num_rows_} * num_cols_ > int64_t{0x7FFFFFFF}) {
+        throw std::runtime_error(path + " has an invalid board size");
+    }
+    // The E + 1 offsets must fit before any pointer into the file is formed
+    uint64_t count = field(24, uint64_t{});
+    if (count >= (data.size() - kHeaderBytes) / 8) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    num_edges_ = static_cast<size_t>(count);
+    offsets_ = data.data() + kHeaderBytes;
+    cells_ = offsets_ + (num_edges_ + 1) * 8;
+
+    // Offsets must rise from zero and cover exactly the rest of the file
+    if (offset(0) != 0) {
+        throw std::runtime_error(path + " has a nonzero first edge offset");
+    }
+    for (size_t i = 0; i < num_edges_; ++i) {
+        if (offset(i + 1) < offset(i)) {
+            throw std::runtime_error(path + " has decreasing edge offsets");
+        }
+    }
+    size_t cell_bytes = data.size() - static_cast<size_t>(cells_ - data.data());
+    if (cell_bytes % cell_bytes_ != 0 || offset(num_edges_) != cell_bytes / cell_bytes_) {
+        throw std::runtime_error(path + " does not match its edge offsets");
+    }
+}
+
+uint32_t EdgeList::cell_id(uint64_t c) const {
+    if (cell_bytes_ == 2) {
+        uint16_t narrow = 0;
+        std::memcpy(&narrow, cells_ + c * 2, 2);
+        return narrow;
+    }
+    uint32_t id = 0;
+    std::memcpy(&id, cells_ + c * 4, 4);
+    return id;
+}
+
+uint64_t EdgeList::offset(size_t i) const {
+    uint64_t value = 0;
+    std::memcpy(&value, offsets_ + i * 8, 8);
+    return value;
+}
+
+Hyperedge EdgeList::edge(size_t i) const {
+    uint64_t first = offset(i);
+    uint64_t last = offset(i + 1);
+    Hyperedge edge;
+    edge.reserve(static_cast<size_t>(last - first));
+    for (uint64_t c = first; c < last; ++c) {
+        uint32_t id = cell_id(c);
+        if (id >= static_cast<uint32_t>(num_rows_ * num_cols_)) {
+            throw std::runtime_error("Edge list cell id outside the board");
+        }
+        auto cell = static_cast<int32_t>(id);
+        edge.push_back({cell / num_cols_, cell % num_cols_});
+    }
+    return edge;
+}
+
+std::shared_ptr<const EdgeIndex> EdgeList::index() const {
+    uint64_t total = offset(num_edges_);
+    if (num_edges_ >= size_t{0x7FFFFFFF} || total > uint64_t{0x7FFFFFFF}) {
+        throw std::runtime_error("Edge list too large for an edge index");
+    }
+    std::vector<int32_t> offsets(num_edges_ + 1);
+    for (size_t i = 0; i <= num_edges_; ++i) {
+        offsets[i] = static_cast<int32_t>(offset(i));
+    }
+    std::vector<int32_t> cells(static_cast<size_t>(total));
+    // EdgeIndex rejects ids outside the board
+    for (uint64_t c = 0; c < total; ++c) {
+        cells[static_cast<size_t>(c)] = static_cast<int32_t>(cell_id(c));
+    }
+    return std::make_shared<const EdgeIndex>(num_cols_, num_rows_, std::move(offsets), std::move(cells));
+}
+
+} // namespace game
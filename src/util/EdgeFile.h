@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/EdgeIndex.h"
+#include "core/Edges.h"
+#include "util/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace game {
+
+// Streams an edge set to a file descriptor through a fixed 64 KiB buffer,
+// formatting numbers with std::to_chars, so no output is held in memory.
+class EdgeWriter {
+public:
+    // The text of Formatter::format_all_edges
+    static void write_text(int fd, const std::vector<Hyperedge>& edges);
+
+    // The binary edge list read by EdgeList
+    static void write_binary(int fd, const std::vector<Hyperedge>& edges, int32_t num_rows, int32_t num_cols,
+                             int32_t line_length);
+};
+
+// Memory-mapped binary edge list.
+//
+// Layout, little-endian: "7REL", u16 version, u16 cell id bytes, u32 rows,
+// u32 columns, u32 k, u32 zero, u64 edge count E, then E + 1 u64 offsets
+// into the cell array and the cell ids (row * columns + col) of every edge,
+// edge i holding cells [offset i, offset i+1). Cell ids are u16, or u32 on
+// boards of more than 65536 cells. The offsets start 8-byte aligned.
+class EdgeList {
+public:
+    static constexpr char kMagic[4] = {'7', 'R', 'E', 'L'};
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 32;
+
+    // Throws if the file is not a well-formed edge list
+    explicit EdgeList(const std::string& path);
+
+    int32_t rows() const { return num_rows_; }
+    int32_t cols() const { return num_cols_; }
+    int32_t line_length() const { return line_length_; }
+    size_t size() const { return num_edges_; }
+
+    Hyperedge edge(size_t i) const;
+
+    // Both incidence directions, built straight from the mapped arrays
+    std::shared_ptr<const EdgeIndex> index() const;
+
+private:
+    MappedFile file_;
+    int32_t num_rows_;
+    int32_t num_cols_;
+    int32_t line_length_;
+    uint32_t cell_bytes_;
+    size_t num_edges_;
+    const char* offsets_;
+    const char* cells_;
+
+    uint64_t offset(size_t i) const;
+    uint32_t cell_id(uint64_t c) const;
+};
+
+} // namespace game
@@ -33,8 +33,8 @@ std::string Formatter::format_all_edges(const std::vector<Hyperedge>& edges) {
 std::string Formatter::format_histogram(const LLineHistogram& hist) {
     std::ostringstream oss;
     oss << "L-line histogram:\n";
-    for (int32_t l = 1; l <= 7; ++l) {
-        oss << "  x_" << l << " = " << hist[static_cast<size_t>(l - 1)] << "\n";
+    for (size_t l = 1; l <= hist.size(); ++l) {
+        oss << "  x_" << l << " = " << hist[l - 1] << "\n";
     }
     return oss.str();
 }
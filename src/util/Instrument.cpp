@@ -0,0 +1,264 @@
+#include "util/Instrument.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace game {
+
+namespace {
+
+struct ScopeStats {
+    int64_t calls = 0;
+    int64_t total_ns = 0;
+};
+
+struct TraceEvent {
+    int32_t scope;
+    int64_t start_ns;
+    int64_t duration_ns;
+};
+
+struct ThreadData {
+    int32_t tid = 0;
+    std::vector<int64_t> counters;
+    std::vector<ScopeStats> scopes;
+    std::vector<TraceEvent> events;
+    int64_t dropped = 0;
+};
+
+struct HardwareCounter {
+    const char* name;
+    int fd = -1;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> counter_names;
+    std::vector<std::string> scope_names;
+    std::vector<std::shared_ptr<ThreadData>> threads;  // Outlive their threads for the report
+    std::atomic<bool> tracing{false};
+    int64_t trace_min_ns = 1000;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::vector<HardwareCounter> hardware;
+    std::string hardware_error;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadData& local() {
+    thread_local std::shared_ptr<ThreadData> data = [] {
+        auto created = std::make_shared<ThreadData>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->tid = static_cast<int32_t>(reg.threads.size()) + 1;
+        reg.threads.push_back(created);
+        return created;
+    }();
+    return *data;
+}
+
+int32_t register_name(std::vector<std::string>& names, const char* name) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return static_cast<int32_t>(it - names.begin());
+    }
+    names.emplace_back(name);
+    return static_cast<int32_t>(names.size()) - 1;
+}
+
+void open_hardware(Registry& reg) {
+#if defined(__linux__)
+    const std::pair<const char*, uint64_t> events[] = {
+        {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+        {"cache-misses", PERF_COUNT_HW_CACHE_MISSES},
+    };
+    for (const auto& [name, config] : events) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;  // Threads started after this count too
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            reg.hardware_error = std::string("perf_event_open failed: ") + std::strerror(errno);
+            break;
+        }
+        reg.hardware.push_back({name, static_cast<int>(fd)});
+    }
+    if (!reg.hardware_error.empty()) {
+        for (const auto& counter : reg.hardware) ::close(counter.fd);
+        reg.hardware.clear();
+        return;
+    }
+    for (const auto& counter : reg.hardware) {
+        ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    reg.hardware_error = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+int32_t Instrument::counter_id(const char* name) {
+    return register_name(registry().counter_names, name);
+}
+
+int32_t Instrument::scope_id(const char* name) {
+    return register_name(registry().scope_names, name);
+}
+
+void Instrument::add(int32_t counter, int64_t amount) {
+    ThreadData& data = local();
+    auto id = static_cast<size_t>(counter);
+    if (id >= data.counters.size()) data.counters.resize(id + 1, 0);
+    data.counters[id] += amount;
+}
+
+int64_t Instrument::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void Instrument::record(int32_t scope, int64_t start_ns, int64_t end_ns) {
+    ThreadData& data = local();
+    auto id = static_cast<size_t>(scope);
+    if (id >= data.scopes.size()) data.scopes.resize(id + 1);
+    int64_t duration = end_ns - start_ns;
+    ++data.scopes[id].calls;
+    data.scopes[id].total_ns += duration;
+
+    Registry& reg = registry();
+    if (reg.tracing.load(std::memory_order_relaxed) && duration >= reg.trace_min_ns) {
+        if (data.events.size() < kMaxTraceEvents) {
+            data.events.push_back({scope, start_ns, duration});
+        } else {
+            ++data.dropped;
+        }
+    }
+}
+
+void Instrument::start(const InstrumentOptions& options) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& data : reg.threads) {
+            data->counters.clear();
+            data->scopes.clear();
+            data->events.clear();
+            data->dropped = 0;
+        }
+        reg.trace_min_ns = options.trace_min_ns;
+    }
+    reg.tracing.store(options.trace, std::memory_order_relaxed);
+    if (options.hardware && reg.hardware.empty()) {
+        open_hardware(reg);
+    }
+}
+
+void Instrument::write_summary(std::ostream& out) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::ios saved(nullptr);
+    saved.copyfmt(out);
+
+    std::vector<ScopeStats> scopes(reg.scope_names.size());
+    std::vector<int64_t> counters(reg.counter_names.size(), 0);
+    int64_t dropped = 0;
+    for (const auto& data : reg.threads) {
+        for (size_t i = 0; i < data->scopes.size(); ++i) {
+            scopes[i].calls += data->scopes[i].calls;
+            scopes[i].total_ns += data->scopes[i].total_ns;
+        }
+        for (size_t i = 0; i < data->counters.size(); ++i) {
+            counters[i] += data->counters[i];
+        }
+        dropped += data->dropped;
+    }
+
+    out << std::left << std::setw(36) << "Scope" << std::right << std::setw(14) << "calls" << std::setw(14)
+        << "total ms" << std::setw(12) << "mean ns" << "\n";
+    for (size_t i = 0; i < scopes.size(); ++i) {
+        if (scopes[i].calls == 0) continue;
+        out << std::left << std::setw(36) << reg.scope_names[i] << std::right << std::setw(14) << scopes[i].calls
+            << std::setw(14) << std::fixed << std::setprecision(3) << static_cast<double>(scopes[i].total_ns) / 1e6
+            << std::setw(12) << scopes[i].total_ns / scopes[i].calls << "\n";
+    }
+    out << std::left << std::setw(36) << "Counter" << std::right << std::setw(14) << "value" << "\n";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        if (counters[i] == 0) continue;
+        out << std::left << std::setw(36) << reg.counter_names[i] << std::right << std::setw(14) << counters[i]
+            << "\n";
+    }
+    if (!reg.hardware.empty()) {
+        out << std::left << std::setw(36) << "Hardware" << std::right << std::setw(14) << "value" << "\n";
+        for (const auto& counter : reg.hardware) {
+            uint64_t value = 0;
+#if defined(__linux__)
+            if (::read(counter.fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) value = 0;
+#endif
+            out << std::left << std::setw(36) << counter.name << std::right << std::setw(14) << value << "\n";
+        }
+    } else if (!reg.hardware_error.empty()) {
+        out << "Hardware counters unavailable: " << reg.hardware_error << "\n";
+    }
+    if (dropped > 0) {
+        out << "Trace events dropped: " << dropped << "\n";
+    }
+    out.copyfmt(saved);
+}
+
+void Instrument::write_trace(std::ostream& out) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::ios saved(nullptr);
+    saved.copyfmt(out);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& data : reg.threads) {
+        for (const auto& event : data->events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            write_json_string(out, reg.scope_names[static_cast<size_t>(event.scope)]);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << data->tid << ",\"ts\":" << event.start_ns / 1000 << "."
+                << std::setw(3) << std::setfill('0') << event.start_ns % 1000 << ",\"dur\":"
+                << event.duration_ns / 1000 << "." << std::setw(3) << event.duration_ns % 1000 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    out.copyfmt(saved);
+}
+
+} // namespace game
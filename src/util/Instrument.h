@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Set by the GAME_INSTRUMENT CMake option; without it the macros below
+// expand to nothing and their arguments are not evaluated.
+#ifndef GAME_INSTRUMENT
+#define GAME_INSTRUMENT 0
+#endif
+
+namespace game {
+
+struct InstrumentOptions {
+    bool trace = false;          // Record scope events for write_trace
+    bool hardware = false;       // Count cycles and cache misses with perf_event_open
+    int64_t trace_min_ns = 1000; // Shorter scopes are only aggregated
+};
+
+// Process-wide counters and scope timers.
+//
+// Each thread accumulates into its own buffers, registered on first use, so
+// the hot paths take no locks. Counter and scope ids are registered once per
+// call site through the macros. Reports sum over all threads and should be
+// taken once the workers are idle.
+class Instrument {
+public:
+    static constexpr bool kEnabled = GAME_INSTRUMENT != 0;
+    static constexpr size_t kMaxTraceEvents = size_t{1} << 20;  // Per thread
+
+    static int32_t counter_id(const char* name);
+    static int32_t scope_id(const char* name);
+    static void add(int32_t counter, int64_t amount);
+
+    // Reset the counters, start the clock for trace timestamps and open the
+    // hardware counters
+    static void start(const InstrumentOptions& options);
+
+    // Scope calls and times, counters, and hardware counts if opened
+    static void write_summary(std::ostream& out);
+
+    // Chrome trace event JSON, loadable in chrome://tracing or Perfetto
+    static void write_trace(std::ostream& out);
+
+    // Internal: record one finished scope on the calling thread
+    static void record(int32_t scope, int64_t start_ns, int64_t end_ns);
+    static int64_t now_ns();
+};
+
+class ScopeTimer {
+public:
+    explicit ScopeTimer(int32_t scope)
+        : scope_(scope)
+        , start_ns_(Instrument::now_ns()) {}
+    ~ScopeTimer() { Instrument::record(scope_, start_ns_, Instrument::now_ns()); }
+
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    int32_t scope_;
+    int64_t start_ns_;
+};
+
+} // namespace game
+
+#if GAME_INSTRUMENT
+#define GAME_INSTRUMENT_CONCAT_(a, b) a##b
+#define GAME_INSTRUMENT_CONCAT(a, b) GAME_INSTRUMENT_CONCAT_(a, b)
+#define GAME_COUNT(name, amount)                                                      \
+    do {                                                                              \
+        static const int32_t game_counter_id_ = ::game::Instrument::counter_id(name); \
+        ::game::Instrument::add(game_counter_id_, static_cast<int64_t>(amount));      \
+    } while (0)
+// __COUNTER__ keeps two scopes on one line, e.g. from one macro, apart
+#define GAME_SCOPE(name) GAME_SCOPE_AT(name, __COUNTER__)
+#define GAME_SCOPE_AT(name, n)                                                                               \
+    static const int32_t GAME_INSTRUMENT_CONCAT(game_scope_id_, n) = ::game::Instrument::scope_id(name); \
+    ::game::ScopeTimer GAME_INSTRUMENT_CONCAT(game_scope_, n)(GAME_INSTRUMENT_CONCAT(game_scope_id_, n))
+#else
+#define GAME_COUNT(name, amount) ((void)0)
+#define GAME_SCOPE(name) ((void)0)
+#endif
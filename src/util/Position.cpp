@@ -0,0 +1,171 @@
+#include "util/Position.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace game {
+
+namespace {
+
+void count_marks(const Board& board, int32_t& maker, int32_t& breaker) {
+    maker = 0;
+    breaker = 0;
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < board.cols(); ++c) {
+            CellState state = board.get(r, c);
+            if (state == CellState::Maker) ++maker;
+            if (state == CellState::Breaker) ++breaker;
+        }
+    }
+}
+
+} // namespace
+
+Position PositionCodec::parse(std::string_view text, int32_t expected_rows) {
+    size_t space = text.find(' ');
+    std::string_view rows = text.substr(0, space);
+    std::string_view side = (space == std::string_view::npos) ? std::string_view{} : text.substr(space + 1);
+    while (!side.empty() && (side.back() == ' ' || side.back() == '\r')) {
+        side.remove_suffix(1);
+    }
+
+    // Decode each row into cell states, checking that all rows have one width
+    std::vector<CellState> cells;
+    int32_t num_rows = 0;
+    int32_t num_cols = -1;
+    size_t start = 0;
+    while (start <= rows.size()) {
+        size_t slash = rows.find('/', start);
+        std::string_view row = rows.substr(start, slash == std::string_view::npos ? slash : slash - start);
+        int32_t width = 0;
+        for (size_t i = 0; i < row.size();) {
+            char ch = row[i];
+            if (ch == 'M' || ch == 'B') {
+                cells.push_back(ch == 'M' ? CellState::Maker : CellState::Breaker);
+                ++width;
+                ++i;
+            } else if (ch >= '0' && ch <= '9') {
+                int32_t run = 0;
+                for (; i < row.size() && row[i] >= '0' && row[i] <= '9'; ++i) {
+                    run = run * 10 + (row[i] - '0');
+                    if (run > 1 << 20) throw std::invalid_argument("Empty run too long in position");
+                }
+                if (run == 0) throw std::invalid_argument("Empty run of length 0 in position");
+                cells.insert(cells.end(), static_cast<size_t>(run), CellState::Empty);
+                width += run;
+            } else {
+                throw std::invalid_argument(std::string("Invalid character '") + ch + "' in position");
+            }
+        }
+        if (num_cols >= 0 && width != num_cols) {
+            throw std::invalid_argument("Position rows have different widths");
+        }
+        num_cols = width;
+        ++num_rows;
+        if (slash == std::string_view::npos) break;
+        start = slash + 1;
+    }
+
+    Board board(num_cols > 0 ? num_cols : 1, expected_rows);
+    if (num_rows != board.rows() || num_cols <= 0) {
+        throw std::invalid_argument("Position must have " + std::to_string(board.rows()) +
+                                    " non-empty rows separated by '/'");
+    }
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < num_cols; ++c) {
+            board.set(r, c, cells[static_cast<size_t>(r * num_cols + c)]);
+        }
+    }
+
+    if (side.empty()) {
+        return {board, infer_to_move(board)};
+    }
+    if (side == "m") return {board, Player::Maker};
+    if (side == "b") return {board, Player::Breaker};
+    throw std::invalid_argument("Invalid side to move '" + std::string(side) + "': expected m or b");
+}
+
+std::string PositionCodec::format(const Board& board, Player to_move) {
+    std::string out;
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        if (r > 0) out += '/';
+        int32_t run = 0;
+        for (int32_t c = 0; c < board.cols(); ++c) {
+            CellState state = board.get(r, c);
+            if (state == CellState::Empty) {
+                ++run;
+                continue;
+            }
+            if (run > 0) out += std::to_string(run);
+            run = 0;
+            out += (state == CellState::Maker) ? 'M' : 'B';
+        }
+        if (run > 0) out += std::to_string(run);
+    }
+    out += (to_move == Player::Maker) ? " m" : " b";
+    return out;
+}
+
+void PositionCodec::pack(const Board& board, uint8_t* out) {
+    if (board.rows() != kDefaultRows) {
+        throw std::invalid_argument("Packed positions have " + std::to_string(kDefaultRows) + " rows");
+    }
+    std::memset(out, 0, packed_size(board.cols()));
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < board.cols(); ++c) {
+            auto id = static_cast<size_t>(r * board.cols() + c);
+            auto bits = static_cast<uint8_t>(board.get(r, c));
+            out[id / 4] = static_cast<uint8_t>(out[id / 4] | bits << (2 * (id % 4)));
+        }
+    }
+}
+
+Position PositionCodec::unpack(const uint8_t* data, int32_t num_cols) {
+    Board board(num_cols);
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        for (int32_t c = 0; c < num_cols; ++c) {
+            auto id = static_cast<size_t>(r * num_cols + c);
+            auto bits = (data[id / 4] >> (2 * (id % 4))) & 3;
+            if (bits == 3) {
+                throw std::invalid_argument("Invalid cell code in packed position");
+            }
+            board.set(r, c, static_cast<CellState>(bits));
+        }
+    }
+    return {board, infer_to_move(board)};
+}
+
+std::string PositionCodec::packed_header(int32_t num_cols) {
+    std::string header(kPackedMagic, sizeof(kPackedMagic));
+    header += static_cast<char>(kPackedVersion & 0xFF);
+    header += static_cast<char>(kPackedVersion >> 8);
+    header += static_cast<char>(num_cols & 0xFF);
+    header += static_cast<char>((num_cols >> 8) & 0xFF);
+    return header;
+}
+
+int32_t PositionCodec::parse_packed_header(std::string_view data) {
+    if (data.size() < kPackedHeaderBytes || data.substr(0, 4) != std::string_view(kPackedMagic, 4)) {
+        return 0;
+    }
+    auto byte = [&](size_t i) { return static_cast<int32_t>(static_cast<uint8_t>(data[i])); };
+    if ((byte(4) | byte(5) << 8) != kPackedVersion) {
+        throw std::invalid_argument("Unsupported packed position version");
+    }
+    int32_t num_cols = byte(6) | byte(7) << 8;
+    if (num_cols <= 0) {
+        throw std::invalid_argument("Packed position file has no columns");
+    }
+    return num_cols;
+}
+
+Player PositionCodec::infer_to_move(const Board& board) {
+    int32_t maker = 0;
+    int32_t breaker = 0;
+    count_marks(board, maker, breaker);
+    if (maker == breaker) return Player::Maker;
+    if (maker == breaker + 1) return Player::Breaker;
+    throw std::invalid_argument("Position has " + std::to_string(maker) + " Maker and " +
+                                std::to_string(breaker) + " Breaker cells; give the side to move");
+}
+
+} // namespace game
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Board.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace game {
+
+struct Position {
+    Board board;
+    Player to_move;
+};
+
+// Position encodings.
+//
+// Text: the rows (four by default) from row 0 down, separated by '/'. 'M' is a Maker
+// cell, 'B' a Breaker cell and a decimal number a run of empty cells, so
+// "M9/10/10/B9" is a 10-column board. An optional side to move follows
+// after a space, "m" or "b"; without it the side is inferred from the counts.
+//
+// Packed (4-row boards only): 2 bits per cell (0 empty, 1 Maker, 2 Breaker) in row-major cell
+// order, four cells per byte from the low bits up, so a record is exactly
+// `num_cols` bytes. The side to move is always inferred. A packed file is an
+// 8-byte header ("7RPK", u16 version, u16 columns, little-endian) followed by
+// back-to-back records.
+class PositionCodec {
+public:
+    static constexpr char kPackedMagic[4] = {'7', 'R', 'P', 'K'};
+    static constexpr uint16_t kPackedVersion = 1;
+    static constexpr size_t kPackedHeaderBytes = 8;
+
+    static Position parse(std::string_view text, int32_t expected_rows = kDefaultRows);
+    static std::string format(const Board& board, Player to_move);
+
+    static size_t packed_size(int32_t num_cols) { return static_cast<size_t>(num_cols); }
+    static void pack(const Board& board, uint8_t* out);
+    static Position unpack(const uint8_t* data, int32_t num_cols);
+
+    static std::string packed_header(int32_t num_cols);
+    // Column count of a packed file, or 0 if `data` does not start with the header
+    static int32_t parse_packed_header(std::string_view data);
+
+    // Maker moves first: equal counts mean Maker to move, one extra Maker
+    // cell means Breaker to move. Anything else cannot arise in play.
+    static Player infer_to_move(const Board& board);
+};
+
+} // namespace game
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game {
+
+// Peak resident set size of this process in bytes, or 0 if unavailable
+size_t peak_rss_bytes();
+
+} // namespace game
@@ -0,0 +1,108 @@
+#include "util/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+namespace game {
+
+ThreadPool::ThreadPool(int32_t threads)
+    : stopping_(false) {
+    if (threads <= 0) {
+        throw std::invalid_argument("Thread count must be positive");
+    }
+    for (int32_t t = 0; t < threads; ++t) {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    ready_.notify_one();
+}
+
+void ThreadPool::parallel_for(int64_t count, const std::function<void(int64_t)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    
+    // Shared with the helpers: one still queued when the call returns finds
+    // `closed` set and leaves without touching fn
+    struct State {
+        std::atomic<int64_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        int32_t running = 0;
+        bool closed = false;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    
+    auto drain = [count, &fn](State& s) {
+        for (int64_t i = s.next.fetch_add(1); i < count; i = s.next.fetch_add(1)) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.error) s.error = std::current_exception();
+                s.next.store(count);
+            }
+        }
+    };
+    const auto helpers = static_cast<int32_t>(std::min<int64_t>(count, size()));
+    for (int32_t t = 0; t < helpers; ++t) {
+        submit([state, drain] {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->closed) return;
+                ++state->running;
+            }
+            drain(*state);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (--state->running == 0) state->done.notify_one();
+        });
+    }
+    
+    // The caller works too and waits only for helpers that started, so a
+    // call from a pool worker, or with every worker busy, cannot starve
+    drain(*state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->closed = true;
+    state->done.wait(lock, [&] { return state->running == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+void ThreadPool::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace game
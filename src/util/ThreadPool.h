@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+// Fixed set of worker threads fed from a FIFO task queue.
+class ThreadPool {
+public:
+    explicit ThreadPool(int32_t threads);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    int32_t size() const { return static_cast<int32_t>(workers_.size()); }
+    
+    void submit(std::function<void()> task);
+    
+    // Run fn(i) for every i in [0, count) across the pool and wait for all
+    // of them. Indices are handed out dynamically, so uneven items balance.
+    // Safe to call from several threads at once and from inside pool tasks,
+    // since the caller runs items itself. If fn throws, no further indices
+    // are started and the first exception is rethrown here.
+    void parallel_for(int64_t count, const std::function<void(int64_t)>& fn);
+    
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_;
+    
+    void run();
+};
+
+} // namespace game
@@ -0,0 +1,216 @@
+#include "test_framework.h"
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "metrics/IncrementalPotential.h"
+#include "metrics/Potential.h"
+#include "search/Certifier.h"
+#include "search/MoveGenerator.h"
+#include "util/Cli.h"
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <set>
+
+void test_certification();
+
+namespace {
+
+void test_incremental_matches_full_scan() {
+    auto edges = game::EdgeGenerator::generate_edges(9);
+    game::Game g(9, edges);
+    game::IncrementalPotential inc(g.board(), edges);
+    std::mt19937 rng(7);
+    
+    while (!g.board().get_empty_cells().empty()) {
+        auto empty = g.board().get_empty_cells();
+        std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+        game::Cell cell = empty[dist(rng)];
+        game::CellState state = (g.current_player() == game::Player::Maker)
+            ? game::CellState::Maker : game::CellState::Breaker;
+        bool won = g.make_move(cell).maker_wins;
+        inc.place(cell, state);
+        
+        game::PotentialCalculator calc(g.board(), edges);
+        ASSERT_TRUE(calc.compute_histogram() == inc.histogram(), "Histogram diverged from full scan");
+        ASSERT_TRUE(std::abs(calc.compute_potential() - inc.potential()) < 1e-12, "Potential diverged from full scan");
+        ASSERT_EQ(won, inc.maker_won(), "Win flag diverged from Game");
+        if (won) break;
+    }
+    
+    while (inc.num_placed() > 0) {
+        inc.undo();
+    }
+    game::Board empty_board(9);
+    game::PotentialCalculator calc(empty_board, edges);
+    ASSERT_TRUE(calc.compute_histogram() == inc.histogram(), "Undo did not restore the empty board");
+    ASSERT_EQ(inc.num_empty(), 36, "Undo did not restore the empty count");
+    
+    TEST_PASS();
+}
+
+void test_incremental_generalized_game() {
+    // 5 rows and k = 8: the histogram widens to eight entries
+    const int32_t rows = 5;
+    const int32_t k = 8;
+    auto edges = game::EdgeGenerator::generate_edges(12, rows, k);
+    game::Game g(game::Board(12, rows), edges, game::Player::Maker);
+    game::IncrementalPotential inc(g.board(), edges, k);
+    ASSERT_EQ(inc.histogram().size(), size_t{8}, "Histogram has k entries");
+    std::mt19937 rng(5);
+    
+    while (!g.board().get_empty_cells().empty()) {
+        auto empty = g.board().get_empty_cells();
+        std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+        game::Cell cell = empty[dist(rng)];
+        game::CellState state = (g.current_player() == game::Player::Maker)
+            ? game::CellState::Maker : game::CellState::Breaker;
+        bool won = g.make_move(cell).maker_wins;
+        inc.place(cell, state);
+        
+        game::PotentialCalculator calc(g.board(), edges, k);
+        ASSERT_TRUE(calc.compute_histogram() == inc.histogram(), "Histogram diverged from full scan");
+        ASSERT_TRUE(std::abs(calc.compute_potential() - inc.potential()) < 1e-12, "Potential diverged from full scan");
+        ASSERT_EQ(won, inc.maker_won(), "Win flag diverged from Game");
+        if (won) break;
+    }
+    
+    // k = 6 keeps six entries when asked to; the default still reports seven
+    auto short_edges = game::EdgeGenerator::generate_edges(9, 4, 6);
+    game::Board board(9);
+    ASSERT_EQ(game::PotentialCalculator(board, short_edges, 6).compute_histogram().size(), size_t{6},
+              "Histogram sized to k");
+    ASSERT_EQ(game::PotentialCalculator(board, short_edges).compute_histogram().size(), size_t{7},
+              "Default histogram size");
+    
+    TEST_PASS();
+}
+
+void test_depth_zero_is_potential_rule() {
+    auto edges = game::EdgeGenerator::generate_edges(7);
+    game::Game g(7, edges);
+    std::mt19937 rng(3);
+    
+    for (int32_t move = 0; move < 16; ++move) {
+        auto empty = g.board().get_empty_cells();
+        std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+        if (g.make_move(empty[dist(rng)]).maker_wins) break;
+        if (g.current_player() != game::Player::Breaker) continue;
+        
+        game::PotentialCalculator calc(g.board(), edges);
+        game::Certifier certifier(g.board(), edges, {0, game::BreakerReplies::Greedy});
+        ASSERT_EQ(certifier.certify(game::Player::Breaker).certified, calc.has_breaker_certificate(),
+                  "Depth-0 certificate must equal pot < 1");
+    }
+    
+    TEST_PASS();
+}
+
+void test_lookahead_extends_certificate() {
+    // Breaker to move with pot = 1: no immediate certificate, but one greedy
+    // Breaker move and any Maker reply bring every line below 1
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Game g(4, edges);
+    for (const auto& cell : game::CliParser::parse_moves("0,1 0,0 3,3 3,2 3,0")) {
+        g.make_move(cell);
+    }
+    
+    game::Certifier shallow(g.board(), edges, {0, game::BreakerReplies::Greedy});
+    game::Certifier deep(g.board(), edges, {2, game::BreakerReplies::Greedy});
+    ASSERT_TRUE(!shallow.certify(game::Player::Breaker).certified, "Depth 0 should not certify pot = 1");
+    ASSERT_TRUE(deep.certify(game::Player::Breaker).certified, "Depth 2 should certify the position");
+    
+    TEST_PASS();
+}
+
+void test_exhaustive_dominates_greedy() {
+    auto edges = game::EdgeGenerator::generate_edges(5);
+    std::mt19937 rng(11);
+    
+    for (int32_t trial = 0; trial < 20; ++trial) {
+        game::Game g(5, edges);
+        for (int32_t move = 0; move < 10; ++move) {
+            auto empty = g.board().get_empty_cells();
+            std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+            g.make_move(empty[dist(rng)]);
+        }
+        if (g.check_maker_win()) continue;
+        
+        game::Certifier greedy(g.board(), edges, {3, game::BreakerReplies::Greedy});
+        game::Certifier exhaustive(g.board(), edges, {3, game::BreakerReplies::Exhaustive});
+        bool by_greedy = greedy.certify(g.current_player()).certified;
+        bool by_exhaustive = exhaustive.certify(g.current_player()).certified;
+        ASSERT_TRUE(!by_greedy || by_exhaustive, "Exhaustive search missed a greedy certificate");
+    }
+    
+    TEST_PASS();
+}
+
+std::set<int32_t> live_edges_of(const game::IncrementalPotential& state, int32_t cell) {
+    // Recomputed from the board rather than from the tracked counters
+    std::set<int32_t> live;
+    for (int32_t e : state.index().edges_of(cell)) {
+        bool has_breaker = false;
+        for (int32_t c : state.index().cells_of(e)) {
+            if (state.board().get(state.index().cell_at(c)) == game::CellState::Breaker) has_breaker = true;
+        }
+        if (!has_breaker) live.insert(e);
+    }
+    return live;
+}
+
+void test_move_generation_prunes_and_orders() {
+    auto edges = game::EdgeGenerator::generate_edges(8);
+    game::Board board(8);
+    game::IncrementalPotential state(board, edges);
+    std::mt19937 rng(5);
+    
+    for (int32_t ply = 0; ply < 24; ++ply) {
+        auto moves = game::MoveGenerator::generate(state);
+        if (moves.empty()) break;
+        
+        // Every live empty cell is generated or equivalent to a generated cell
+        for (int32_t c = 0; c < state.index().num_cells(); ++c) {
+            auto live = live_edges_of(state, c);
+            ASSERT_EQ(state.live_degree(c), static_cast<int32_t>(live.size()), "Live degree diverged from the board");
+            if (!state.is_empty(c) || live.empty()) {
+                ASSERT_TRUE(std::find(moves.begin(), moves.end(), c) == moves.end(), "Dead or occupied cell generated");
+                continue;
+            }
+            bool covered = false;
+            for (int32_t m : moves) {
+                if (live_edges_of(state, m) == live) covered = true;
+            }
+            ASSERT_TRUE(covered, "Live cell has no representative");
+        }
+        for (size_t i = 1; i < moves.size(); ++i) {
+            ASSERT_TRUE(state.breaker_gain(moves[i - 1]) >= state.breaker_gain(moves[i]), "Moves not ordered by gain");
+            ASSERT_TRUE(live_edges_of(state, moves[i - 1]) != live_edges_of(state, moves[i]), "Equivalent cells not merged");
+        }
+        
+        std::uniform_int_distribution<size_t> dist(0, moves.size() - 1);
+        int32_t cell = moves[dist(rng)];
+        game::CellState mark = (ply % 2 == 0) ? game::CellState::Maker : game::CellState::Breaker;
+        state.place(cell, mark);
+        
+        // Undo and redo keeps the tracked liveness consistent
+        if (ply % 3 == 1) {
+            state.undo();
+            state.place(cell, mark);
+        }
+        if (state.maker_won()) break;
+    }
+    
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_certification() {
+    test_incremental_matches_full_scan();
+    test_incremental_generalized_game();
+    test_depth_zero_is_potential_rule();
+    test_lookahead_extends_certificate();
+    test_exhaustive_dominates_greedy();
+    test_move_generation_prunes_and_orders();
+}
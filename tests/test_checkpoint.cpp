@@ -0,0 +1,307 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "metrics/Trajectory.h"
+#include "search/ProofNumber.h"
+#include "search/Tablebase.h"
+#include "service/Coordinator.h"
+#include "service/PlayoutPipeline.h"
+#include "service/WidthSweep.h"
+#include "util/Checkpoint.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+void test_checkpoint();
+
+namespace {
+
+bool throws(const std::function<void()>& fn) {
+    try {
+        fn();
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+// What interrupt_and_resume saw
+struct Resumed {
+    bool interrupted = false;    // The first run threw CheckpointInterrupted
+    bool saved = false;          // and left a checkpoint behind
+    int64_t units = 0;           // Units of work done by the resumed run
+};
+
+// Run `fn` with a checkpoint after every unit of work and a stop request
+// once `stop_after` units are done, then resume until it completes
+template <typename Fn>
+Resumed interrupt_and_resume(game::CheckpointOptions& options, game::CheckpointKind kind, int64_t stop_after,
+                             Fn fn) {
+    Resumed result;
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> units{0};
+    options.interval_seconds = 0.0;
+    options.stop = &stop;
+    options.on_unit = [&] {
+        if (units.fetch_add(1) + 1 == stop_after) stop.store(true);
+    };
+    try {
+        fn();
+    } catch (const game::CheckpointInterrupted&) {
+        result.interrupted = true;
+    }
+    result.saved = game::Checkpoint::read(options.path, kind).has_value();
+    stop.store(false);
+    units.store(0);
+    options.on_unit = [&] { units.fetch_add(1); };
+    options.resume = true;
+    fn();
+    result.units = units.load();
+    options.stop = nullptr;
+    options.on_unit = {};
+    return result;
+}
+
+// Units of work in an uninterrupted run of `fn`
+template <typename Fn>
+int64_t count_units(game::CheckpointOptions& options, Fn fn) {
+    std::atomic<int64_t> units{0};
+    options.on_unit = [&] { units.fetch_add(1); };
+    fn();
+    options.on_unit = {};
+    return units.load();
+}
+
+void test_checkpoint_file() {
+    std::string path = test::temp_path();
+    std::remove(path.c_str());
+    ASSERT_TRUE(!game::Checkpoint::read(path, game::CheckpointKind::Sweep), "Missing checkpoint reads as none");
+
+    game::CheckpointBuffer buffer;
+    buffer.put(int32_t{-7});
+    buffer.put(2.5);
+    buffer.put_bytes("abc", 3);
+    game::Checkpoint::write(path, game::CheckpointKind::Sweep, buffer.data());
+    auto payload = game::Checkpoint::read(path, game::CheckpointKind::Sweep);
+    ASSERT_TRUE(payload.has_value(), "Checkpoint reads back");
+    game::CheckpointReader in(*payload);
+    ASSERT_EQ(in.get<int32_t>(), -7, "Integer round trip");
+    ASSERT_TRUE(in.get<double>() == 2.5, "Double round trip");
+    char text[3];
+    in.get_bytes(text, 3);
+    ASSERT_EQ(std::string(text, 3), std::string("abc"), "Bytes round trip");
+    ASSERT_TRUE(in.at_end(), "Payload fully consumed");
+    ASSERT_TRUE(throws([&] { in.get<int32_t>(); }), "Reading past the payload throws");
+
+    ASSERT_TRUE(throws([&] { game::Checkpoint::read(path, game::CheckpointKind::Tablebase); }),
+                "Checkpoint of another kind rejected");
+    std::string bytes = test::read_file(path);
+    bytes[game::Checkpoint::kHeaderBytes + 1] ^= 1;
+    std::ofstream(path, std::ios::binary) << bytes;
+    ASSERT_TRUE(throws([&] { game::Checkpoint::read(path, game::CheckpointKind::Sweep); }),
+                "Corrupt payload fails the checksum");
+    std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 1);
+    ASSERT_TRUE(throws([&] { game::Checkpoint::read(path, game::CheckpointKind::Sweep); }),
+                "Truncated checkpoint rejected");
+
+    game::Checkpoint::remove(path);
+    TEST_PASS();
+}
+
+void test_sweep_resume() {
+    game::SweepOptions options;
+    options.from = 5;
+    options.to = 60;
+    options.games = 30;
+    options.threads = 2;
+    std::ostringstream reference;
+    int64_t total = count_units(options.checkpoint, [&] {
+        game::WidthSweep plain(options);
+        plain.write_csv(plain.run(), reference);
+    });
+    ASSERT_EQ(total, int64_t{56}, "One unit per width");
+
+    options.checkpoint.path = test::temp_path();
+    std::ostringstream resumed;
+    auto run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::Sweep, 10, [&] {
+        game::WidthSweep sweep(options);
+        auto rows = sweep.run();
+        resumed.str("");
+        sweep.write_csv(rows, resumed);
+    });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped sweep leaves a checkpoint");
+    ASSERT_TRUE(run.units > 0 && run.units <= total - 10, "Resumed sweep skips the finished widths");
+    ASSERT_EQ(resumed.str(), reference.str(), "Resumed sweep equals an uninterrupted one");
+    ASSERT_TRUE(!game::Checkpoint::read(options.checkpoint.path, game::CheckpointKind::Sweep),
+                "Checkpoint removed after completion");
+
+    // A checkpoint of another sweep is refused
+    std::atomic<bool> stop{true};
+    game::SweepOptions stopped = options;
+    stopped.checkpoint.stop = &stop;
+    stopped.checkpoint.resume = false;
+    ASSERT_TRUE(throws([&] { game::WidthSweep(stopped).run(); }), "Stopped sweep throws");
+    game::SweepOptions other = options;
+    other.checkpoint.stop = nullptr;
+    other.seed = options.seed + 1;
+    ASSERT_TRUE(throws([&] { game::WidthSweep(other).run(); }), "Checkpoint for another seed rejected");
+    game::Checkpoint::remove(options.checkpoint.path);
+
+    TEST_PASS();
+}
+
+void test_tablebase_resume() {
+    const int32_t num_cols = 3;
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    std::string reference_path = test::temp_path();
+    game::TablebaseOptions options;
+    game::TablebaseStats reference_stats;
+    int64_t total = count_units(options.checkpoint, [&] {
+        reference_stats = game::Tablebase::build(num_cols, edges, reference_path, options);
+    });
+
+    std::string path = test::temp_path();
+    options.threads = 2;
+    options.checkpoint.path = test::temp_path();
+    game::TablebaseStats stats;
+    auto run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::Tablebase, 5,
+                                    [&] { stats = game::Tablebase::build(num_cols, edges, path, options); });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped build leaves a checkpoint");
+    ASSERT_TRUE(run.units > 0 && run.units <= total - 5, "Resumed build skips the finished blocks");
+    ASSERT_TRUE(test::read_file(path) == test::read_file(reference_path), "Resumed table equals an uninterrupted one");
+    ASSERT_EQ(stats.positions, reference_stats.positions, "Position count");
+    ASSERT_EQ(stats.evaluated, reference_stats.evaluated, "Solved count");
+    ASSERT_EQ(stats.maker_wins, reference_stats.maker_wins, "Maker win count");
+
+    std::remove(reference_path.c_str());
+    std::remove(path.c_str());
+    game::Checkpoint::remove(options.checkpoint.path);
+    TEST_PASS();
+}
+
+void test_proof_number_resume() {
+    // A tight arena makes the checkpoints span garbage collections
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Game opening(4, edges);
+    opening.make_move(game::Cell{0, 0});
+    opening.make_move(game::Cell{3, 3});
+    const game::Board& board = opening.board();
+    game::PnOptions options;
+    options.memory_limit_bytes = 2000 * sizeof(game::PnNode);
+    game::PnResult reference = game::ProofNumberSearch(board, edges, game::Player::Maker, options).solve();
+    ASSERT_TRUE(reference.value != game::PnValue::Unknown && reference.gc_runs > 0, "Reference search collects");
+
+    options.checkpoint.path = test::temp_path();
+    game::PnResult result;
+    auto run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::ProofNumber, 500, [&] {
+        result = game::ProofNumberSearch(board, edges, game::Player::Maker, options).solve();
+    });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped search leaves a checkpoint");
+    ASSERT_EQ(run.units, reference.expansions - 500, "Resumed search skips the saved expansions");
+    ASSERT_EQ(result.value, reference.value, "Resumed search reaches the same result");
+    ASSERT_EQ(result.expansions, reference.expansions, "Expansion count");
+    ASSERT_EQ(result.gc_runs, reference.gc_runs, "Collection count");
+    ASSERT_EQ(result.nodes_collected, reference.nodes_collected, "Collected node count");
+    ASSERT_EQ(result.peak_nodes, reference.peak_nodes, "Peak node count");
+    ASSERT_TRUE(!game::Checkpoint::read(options.checkpoint.path, game::CheckpointKind::ProofNumber),
+                "Checkpoint removed once solved");
+
+    // A search out of budget keeps its checkpoint for a larger budget
+    options.checkpoint.interval_seconds = 3600.0;
+    options.checkpoint.resume = false;
+    options.max_expansions = 300;
+    result = game::ProofNumberSearch(board, edges, game::Player::Maker, options).solve();
+    ASSERT_TRUE(result.value == game::PnValue::Unknown, "Budget stops the search");
+    options.checkpoint.resume = true;
+    options.max_expansions = 0;
+    result = game::ProofNumberSearch(board, edges, game::Player::Maker, options).solve();
+    ASSERT_EQ(result.expansions, reference.expansions, "Budgeted search continues where it stopped");
+    ASSERT_EQ(result.value, reference.value, "Continued search reaches the same result");
+    TEST_PASS();
+}
+
+void test_coordinator_resume() {
+    game::Board board(4);
+    game::PnValue expected = game::ProofNumberSearch(board, game::EdgeGenerator::generate_edges(4),
+                                                     game::Player::Maker, game::PnOptions{}).solve().value;
+    game::CoordinatorOptions options;
+    options.workers = 2;
+    options.split_depth = 1;
+    options.unit_expansions = 300;
+    options.checkpoint.path = test::temp_path();
+    game::CoordinatorStats stats;
+    game::CoordinatorStats first;
+    bool resumed = false;
+    auto run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::SolveDist, 3, [&] {
+        stats = game::Coordinator(board, game::Player::Maker, options).run();
+        if (!resumed) first = stats;
+        resumed = true;
+    });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped search leaves a checkpoint");
+    ASSERT_EQ(stats.value, expected, "Resumed search reaches the same result");
+    ASSERT_TRUE(stats.units >= run.units + 3, "Units sent before the stop are counted");
+    ASSERT_TRUE(!game::Checkpoint::read(options.checkpoint.path, game::CheckpointKind::SolveDist),
+                "Checkpoint removed once solved");
+    TEST_PASS();
+}
+
+void test_pipeline_resume() {
+    game::PipelineOptions options;
+    options.num_cols = 8;
+    options.games = 300;
+    options.games_per_block = 7;
+    options.queue_blocks = 2;
+    options.evaluate_threads = 2;
+    std::ostringstream reference;
+    game::PipelineStats reference_stats = game::PlayoutPipeline(options).run(reference);
+
+    // Rows go to a file, which the resumed run reopens and continues
+    std::string path = test::temp_path();
+    options.write_threads = 2;
+    options.checkpoint.path = test::temp_path();
+    game::PipelineStats stats;
+    auto run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::Simulate, 10, [&] {
+        std::fstream file(path, options.checkpoint.resume ? std::ios::binary | std::ios::in | std::ios::out
+                                                          : std::ios::binary | std::ios::out | std::ios::trunc);
+        stats = game::PlayoutPipeline(options).run(file);
+    });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped pipeline leaves a checkpoint");
+    ASSERT_TRUE(run.units > 0 && run.units <= 43 - 10, "Resumed pipeline skips the written blocks");
+    ASSERT_TRUE(test::read_file(path) == reference.str(), "Resumed rows equal an uninterrupted run");
+    ASSERT_EQ(stats.positions, reference_stats.positions, "Position count");
+    ASSERT_EQ(stats.maker_wins, reference_stats.maker_wins, "Maker win count");
+
+    // Statistics are saved with the checkpoint
+    game::PlayoutPipeline pipeline(options);
+    game::TrajectoryStats expected(pipeline.max_plies(), options.line_length);
+    game::PlayoutPipeline(options).run(expected);
+    std::ostringstream expected_json;
+    expected.write_json(expected_json);
+    std::ostringstream json;
+    options.checkpoint.resume = false;
+    run = interrupt_and_resume(options.checkpoint, game::CheckpointKind::Simulate, 10, [&] {
+        game::TrajectoryStats trajectories(pipeline.max_plies(), options.line_length);
+        game::PlayoutPipeline(options).run(trajectories);
+        json.str("");
+        trajectories.write_json(json);
+    });
+    ASSERT_TRUE(run.interrupted && run.saved, "Stopped summary leaves a checkpoint");
+    ASSERT_TRUE(run.units <= 43 - 10, "Resumed summary skips the folded blocks");
+    ASSERT_TRUE(json.str() == expected_json.str(), "Resumed statistics equal an uninterrupted run");
+
+    std::remove(path.c_str());
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_checkpoint() {
+    test_checkpoint_file();
+    test_sweep_resume();
+    test_tablebase_resume();
+    test_proof_number_resume();
+    test_coordinator_resume();
+    test_pipeline_resume();
+}
@@ -0,0 +1,133 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "search/ProofNumber.h"
+#include "service/Coordinator.h"
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+void test_coordinator();
+
+namespace {
+
+game::PnValue solve_locally(const game::Board& board, const std::vector<game::Hyperedge>& edges,
+                            game::Player to_move) {
+    game::ProofNumberSearch search(board, edges, to_move, game::PnOptions{});
+    return search.solve().value;
+}
+
+// The reference value of the empty 4-column board, solved once
+game::PnValue empty_board_value() {
+    static const game::PnValue value =
+        solve_locally(game::Board(4), game::EdgeGenerator::generate_edges(4), game::Player::Maker);
+    return value;
+}
+
+void test_distributed_matches_pns() {
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Board empty(4);
+    game::PnValue expected = empty_board_value();
+
+    // A small budget forces units to be split again and again
+    game::CoordinatorOptions options;
+    options.workers = 2;
+    options.split_depth = 1;
+    options.unit_expansions = 300;
+    game::Coordinator coordinator(empty, game::Player::Maker, options);
+    ASSERT_EQ(coordinator.socket_path(), "/tmp/game-coordinator-" + std::to_string(::getpid()) + ".sock",
+              "An empty socket option resolves to a path under /tmp");
+    auto stats = coordinator.run();
+    ASSERT_TRUE(expected != game::PnValue::Unknown, "Reference search should finish");
+    ASSERT_EQ(stats.value, expected, "Distributed result differs from a single search");
+    ASSERT_TRUE(stats.budget_splits > 0, "Units over budget should be split");
+    ASSERT_EQ(stats.workers.size(), size_t{2}, "Both workers should connect");
+
+    int64_t units = 0;
+    int64_t expansions = 0;
+    for (const auto& worker : stats.workers) {
+        units += worker.units;
+        expansions += worker.expansions;
+    }
+    ASSERT_TRUE(units <= stats.units && units > 0, "Workers report the units they solved");
+    ASSERT_EQ(expansions, stats.expansions, "Expansions add up over workers");
+
+    // Both outcomes, from random openings
+    std::mt19937 rng(5);
+    int32_t proved = 0;
+    int32_t disproved = 0;
+    for (int32_t trial = 0; trial < 12; ++trial) {
+        game::Game g(4, edges);
+        bool won = false;
+        for (int32_t move = 0; move < 8 && !won; ++move) {
+            auto cells = g.board().get_empty_cells();
+            std::uniform_int_distribution<size_t> dist(0, cells.size() - 1);
+            won = g.make_move(cells[dist(rng)]).maker_wins;
+        }
+        if (won) continue;
+        options.unit_expansions = 50;
+        game::Coordinator search(g.board(), g.current_player(), options);
+        game::PnValue value = search.run().value;
+        ASSERT_EQ(value, solve_locally(g.board(), edges, g.current_player()), "Distributed result differs");
+        (value == game::PnValue::Proved ? proved : disproved)++;
+    }
+    ASSERT_TRUE(proved > 0 && disproved > 0, "Sample should contain both outcomes");
+
+    TEST_PASS();
+}
+
+void test_straggler_split() {
+    // One unit, no budget splits: the idle workers only get work by
+    // splitting the unit that is running
+    game::Board empty(4);
+    game::CoordinatorOptions options;
+    options.workers = 3;
+    options.split_depth = 0;
+    options.unit_expansions = 1000000;
+    options.straggler_seconds = 0.0;
+    game::Coordinator coordinator(empty, game::Player::Maker, options);
+    auto stats = coordinator.run();
+    ASSERT_EQ(stats.value, empty_board_value(), "Straggler splits keep the result");
+    ASSERT_TRUE(stats.straggler_splits > 0, "Idle workers should trigger a straggler split");
+    ASSERT_EQ(stats.budget_splits, int64_t{0}, "No unit should exhaust the budget");
+
+    TEST_PASS();
+}
+
+void test_external_worker() {
+    // Workers started separately, as `game worker --socket PATH` would be
+    game::Board empty(4);
+    game::CoordinatorOptions options;
+    options.workers = 0;
+    options.socket_path = "/tmp/coordinator_test_" + std::to_string(::getpid()) + ".sock";
+    options.unit_expansions = 2000;
+    std::thread worker([&] {
+        while (true) {
+            try {
+                game::DistWorker::run(options.socket_path);
+                return;
+            } catch (const std::exception&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    });
+    game::Coordinator coordinator(empty, game::Player::Maker, options);
+    auto stats = coordinator.run();
+    worker.join();
+    ASSERT_EQ(coordinator.socket_path(), options.socket_path, "An explicit socket path is kept");
+    ASSERT_EQ(stats.value, empty_board_value(), "External worker solves the position");
+    ASSERT_EQ(stats.workers.size(), size_t{1}, "One worker connected");
+    ASSERT_TRUE(::access(options.socket_path.c_str(), F_OK) != 0, "Socket removed afterwards");
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_coordinator() {
+    test_distributed_matches_pns();
+    test_straggler_split();
+    test_external_worker();
+}
@@ -0,0 +1,97 @@
+#include "test_framework.h"
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/Potential.h"
+#include "search/Decomposition.h"
+#include <cmath>
+
+void test_decomposition();
+
+namespace {
+
+void block_column(game::Board& board, int32_t col) {
+    for (int32_t r = 0; r < board.rows(); ++r) {
+        board.set(r, col, game::CellState::Breaker);
+    }
+}
+
+void test_empty_board_is_one_component() {
+    game::Board board(10);
+    auto edges = game::EdgeGenerator::generate_edges(10);
+    auto parts = game::Decomposer::decompose(board, edges);
+    
+    ASSERT_EQ(parts.size(), size_t{1}, "Empty board should be a single component");
+    ASSERT_EQ(parts[0].first_col, 0, "Component should start at column 0");
+    ASSERT_EQ(parts[0].last_col, 9, "Component should end at column 9");
+    ASSERT_EQ(parts[0].edges.size(), edges.size(), "All edges are live on an empty board");
+    ASSERT_EQ(parts[0].empty_cells, 40, "All cells are empty");
+    
+    TEST_PASS();
+}
+
+void test_blocked_columns_split_board() {
+    game::Board board(20);
+    auto edges = game::EdgeGenerator::generate_edges(20);
+    block_column(board, 6);
+    block_column(board, 13);
+    board.set(1, 2, game::CellState::Maker);
+    
+    auto parts = game::Decomposer::decompose(board, edges);
+    ASSERT_EQ(parts.size(), size_t{3}, "Two blocked columns should leave three components");
+    ASSERT_EQ(parts[0].last_col, 5, "First component should end before column 6");
+    ASSERT_EQ(parts[1].first_col, 7, "Second component should start after column 6");
+    ASSERT_EQ(parts[1].last_col, 12, "Second component should end before column 13");
+    ASSERT_EQ(parts[2].first_col, 14, "Third component should start after column 13");
+    
+    // Components are independent: their potentials add up to the whole
+    game::PotentialCalculator whole(board, edges);
+    double sum = 0.0;
+    for (const auto& part : parts) {
+        game::PotentialCalculator calc(part.board, part.edges);
+        sum += calc.compute_potential();
+    }
+    ASSERT_TRUE(std::abs(sum - whole.compute_potential()) < 1e-12, "Component potentials should sum to the whole");
+    ASSERT_TRUE(parts[0].key != parts[1].key, "Different components should have different keys");
+    
+    TEST_PASS();
+}
+
+void test_keys_are_translation_invariant() {
+    // The same interior pattern at two offsets yields the same key
+    game::Board board(30);
+    auto edges = game::EdgeGenerator::generate_edges(30);
+    for (int32_t col : {6, 13, 20}) {
+        block_column(board, col);
+    }
+    
+    auto parts = game::Decomposer::decompose(board, edges);
+    ASSERT_EQ(parts.size(), size_t{4}, "Three blocked columns should leave four components");
+    ASSERT_EQ(parts[1].key, parts[2].key, "Identical interior components should share a key");
+    
+    TEST_PASS();
+}
+
+void test_sum_rule() {
+    using game::SubgameOutcome;
+    std::vector<SubgameOutcome> none = {{false, false}, {false, false}};
+    std::vector<SubgameOutcome> one = {{true, false}, {false, false}};
+    std::vector<SubgameOutcome> two = {{true, false}, {true, false}};
+    std::vector<SubgameOutcome> strong = {{true, true}, {false, false}};
+    
+    ASSERT_TRUE(!game::Decomposer::maker_wins_sum(none, game::Player::Maker), "No winning component");
+    ASSERT_TRUE(game::Decomposer::maker_wins_sum(one, game::Player::Maker), "Maker moves first in the winning component");
+    ASSERT_TRUE(!game::Decomposer::maker_wins_sum(one, game::Player::Breaker), "Breaker spends the tempo on it");
+    ASSERT_TRUE(game::Decomposer::maker_wins_sum(two, game::Player::Breaker), "Breaker cannot answer two threats");
+    ASSERT_TRUE(game::Decomposer::maker_wins_sum(strong, game::Player::Breaker), "Maker wins it even moving second");
+    
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_decomposition() {
+    test_empty_board_is_one_component();
+    test_blocked_columns_split_board();
+    test_keys_are_translation_invariant();
+    test_sum_rule();
+}
@@ -0,0 +1,111 @@
+#include "test_framework.h"
+#include "core/EdgeIndex.h"
+#include "core/Edges.h"
+#include "util/EdgeFile.h"
+#include "util/Format.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+
+void test_edge_file();
+
+namespace {
+
+template <typename Fn>
+std::string write_to_file(const std::string& path, Fn write) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+    write(fd);
+    ::close(fd);
+    return test::read_file(path);
+}
+
+bool rejected(const std::string& path) {
+    try {
+        game::EdgeList list(path);
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+void test_text_writer_matches_formatter() {
+    std::string path = test::temp_path();
+    // Enough edges to flush the buffer several times
+    for (int32_t n : {7, 300}) {
+        auto edges = game::EdgeGenerator::generate_edges(n);
+        std::string text = write_to_file(path, [&](int fd) { game::EdgeWriter::write_text(fd, edges); });
+        ASSERT_EQ(text, game::Formatter::format_all_edges(edges), "Streamed text equals format_all_edges");
+    }
+    std::remove(path.c_str());
+    TEST_PASS();
+}
+
+void test_binary_round_trip() {
+    std::string path = test::temp_path();
+    struct Shape { int32_t rows, cols, k; };
+    for (Shape shape : {Shape{4, 200, 7}, Shape{3, 12, 5}, Shape{5, 9, 7}, Shape{4, 20000, 7}}) {
+        auto edges = game::EdgeGenerator::generate_edges(shape.cols, shape.rows, shape.k);
+        std::string bytes = write_to_file(path, [&](int fd) {
+            game::EdgeWriter::write_binary(fd, edges, shape.rows, shape.cols, shape.k);
+        });
+        size_t cells = 0;
+        for (const auto& edge : edges) cells += edge.size();
+        size_t id_bytes = shape.rows * shape.cols > 0x10000 ? 4 : 2;
+        ASSERT_EQ(bytes.size(), game::EdgeList::kHeaderBytes + 8 * (edges.size() + 1) + id_bytes * cells,
+                  "Header, offsets and cell ids");
+
+        game::EdgeList list(path);
+        ASSERT_EQ(list.rows(), shape.rows, "Rows round trip");
+        ASSERT_EQ(list.cols(), shape.cols, "Columns round trip");
+        ASSERT_EQ(list.line_length(), shape.k, "Line length round trip");
+        ASSERT_EQ(list.size(), edges.size(), "Edge count round trip");
+        ASSERT_TRUE(list.edge(edges.size() / 2) == edges[edges.size() / 2], "Edges round trip");
+
+        auto index = list.index();
+        game::EdgeIndex expected(shape.cols, edges, shape.rows);
+        ASSERT_EQ(index->num_edges(), expected.num_edges(), "Index holds every edge");
+        bool same = true;
+        for (int32_t e = 0; e < expected.num_edges(); ++e) {
+            auto cells = index->cells_of(e);
+            auto want = expected.cells_of(e);
+            same = same && std::equal(cells.begin(), cells.end(), want.begin(), want.end());
+        }
+        for (int32_t c = 0; c < expected.num_cells(); ++c) {
+            auto ids = index->edges_of(c);
+            auto want = expected.edges_of(c);
+            same = same && std::equal(ids.begin(), ids.end(), want.begin(), want.end());
+        }
+        ASSERT_TRUE(same, "Mapped index matches one built from the edges");
+    }
+
+    // Damaged files are refused
+    std::string bytes = test::read_file(path);
+    std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 2);
+    ASSERT_TRUE(rejected(path), "Truncated edge list rejected");
+    std::string wrong = bytes;
+    wrong[0] = 'X';
+    std::ofstream(path, std::ios::binary) << wrong;
+    ASSERT_TRUE(rejected(path), "Bad magic rejected");
+    wrong = bytes;
+    wrong[game::EdgeList::kHeaderBytes + 8] = 0x7F;
+    std::ofstream(path, std::ios::binary) << wrong;
+    ASSERT_TRUE(rejected(path), "Inconsistent offsets rejected");
+    wrong = bytes;
+    uint64_t count = (bytes.size() - game::EdgeList::kHeaderBytes) / 8;
+    std::memcpy(wrong.data() + 24, &count, sizeof(count));
+    std::ofstream(path, std::ios::binary) << wrong;
+    ASSERT_TRUE(rejected(path), "Edge count whose offsets overrun the file rejected");
+
+    std::remove(path.c_str());
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_edge_file() {
+    test_text_writer_matches_formatter();
+    test_binary_round_trip();
+}
@@ -1,7 +1,12 @@
 #include "test_framework.h"
 #include "core/Edges.h"
 #include "core/Board.h"
+#include "core/EdgeIndex.h"
 #include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
 
 void test_edge_generation();
 
@@ -97,6 +102,72 @@ void test_edge_cells_in_bounds() {
     test::TestRunner::instance().add_result({"test_edge_cells_in_bounds", true, ""});
 }
 
+// Edge count of the (r, n, k^tr) game from the definition in Edges.h
+size_t expected_edge_count(int32_t rows, int32_t n, int32_t k) {
+    int32_t d = std::min(rows, k);
+    int32_t count = rows * std::max(0, n - k + 1);
+    for (int32_t len = d; len < k && len <= n; ++len) {
+        count += rows;                                         // Left truncated
+        if (n - len >= k || (n < k && len < n)) count += rows; // Right truncated, unless equal to the left one
+    }
+    count += n * (rows - d + 1);                               // Vertical
+    count += 2 * (rows - d + 1) * std::max(0, n - d + 1);      // Diagonal
+    return static_cast<size_t>(count);
+}
+
+void test_generalized_edges() {
+    // The default shape and its neighbours, then r > k, d < 4 and wide k
+    const std::pair<int32_t, int32_t> shapes[] = {{4, 7}, {5, 7}, {4, 6}, {4, 8}, {3, 5}, {6, 4}, {2, 9}, {5, 12}};
+    for (const auto& [rows, k] : shapes) {
+        for (int32_t n = 1; n <= 20; ++n) {
+            auto edges = game::EdgeGenerator::generate_edges(n, rows, k);
+            ASSERT_EQ(edges.size(), expected_edge_count(rows, n, k),
+                      "Edge count of (" + std::to_string(rows) + ", " + std::to_string(n) + ", " +
+                      std::to_string(k) + ")");
+            game::Board board(n, rows);
+            for (const auto& edge : edges) {
+                ASSERT_TRUE(static_cast<int32_t>(edge.size()) <= k, "Edge longer than k");
+                ASSERT_TRUE(std::is_sorted(edge.begin(), edge.end()), "Edge not canonical");
+                for (const auto& cell : edge) {
+                    ASSERT_TRUE(board.is_valid(cell), "Edge cell out of bounds");
+                }
+            }
+        }
+    }
+    ASSERT_TRUE(game::EdgeGenerator::generate_edges(13, 4, 7) == game::EdgeGenerator::generate_edges(13),
+                "(4, n, 7) is the default game");
+    
+    TEST_PASS();
+}
+
+void test_maker_completed_edge() {
+    // Against a scan of every edge, on random fills of several shapes
+    std::mt19937 rng(9);
+    for (auto [rows, n, k] : {std::tuple{4, 9, 7}, std::tuple{5, 6, 4}, std::tuple{1, 5, 3}}) {
+        auto edges = game::EdgeGenerator::generate_edges(n, rows, k);
+        game::EdgeIndex index(n, edges, rows);
+        std::uniform_int_distribution<int> fill(0, 3);
+        for (int32_t trial = 0; trial < 200; ++trial) {
+            game::Board board(n, rows);
+            for (int32_t r = 0; r < rows; ++r) {
+                for (int32_t c = 0; c < n; ++c) {
+                    int v = fill(rng);
+                    if (v > 0) board.set(r, c, v == 3 ? game::CellState::Breaker : game::CellState::Maker);
+                }
+            }
+            bool expected = std::any_of(edges.begin(), edges.end(), [&](const game::Hyperedge& edge) {
+                return std::all_of(edge.begin(), edge.end(),
+                                   [&](const game::Cell& cell) { return board.get(cell) == game::CellState::Maker; });
+            });
+            ASSERT_EQ(index.maker_completed_edge(board), expected, "Completed edge matches a full scan");
+        }
+    }
+    ASSERT_TRUE(!game::EdgeIndex(7, game::EdgeGenerator::generate_edges(7)).maker_completed_edge(game::Board(7)),
+                "Empty board");
+
+    TEST_PASS();
+}
+
 } // namespace
 
 void test_edge_generation() {
@@ -104,4 +175,6 @@ void test_edge_generation() {
     test_edges_are_canonical();
     test_vertical_edges_n7();
     test_edge_cells_in_bounds();
+    test_generalized_edges();
+    test_maker_completed_edge();
 }
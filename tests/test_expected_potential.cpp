@@ -0,0 +1,111 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "metrics/ExpectedPotential.h"
+#include "metrics/IncrementalPotential.h"
+#include "metrics/Potential.h"
+#include <algorithm>
+#include <cmath>
+
+void test_expected_potential();
+
+namespace {
+
+bool near(long double a, long double b, long double tolerance = 1e-12L) {
+    return std::fabs(a - b) <= tolerance * std::max(1.0L, std::fabs(b));
+}
+
+// Average histogram over every placement of `maker` Maker and `breaker`
+// Breaker cells on the empty board
+void enumerate(game::IncrementalPotential& state, int32_t first, int32_t maker, int32_t breaker, bool placing_maker,
+               std::vector<long double>& sums, int64_t& placements) {
+    if (placing_maker && maker == 0) {
+        enumerate(state, 0, 0, breaker, false, sums, placements);
+        return;
+    }
+    if (!placing_maker && breaker == 0) {
+        const auto& hist = state.histogram();
+        for (size_t l = 0; l < hist.size(); ++l) {
+            sums[l] += hist[l];
+        }
+        sums.back() += state.potential();
+        ++placements;
+        return;
+    }
+    for (int32_t c = first; c < state.index().num_cells(); ++c) {
+        if (!state.is_empty(c)) continue;
+        state.place(c, placing_maker ? game::CellState::Maker : game::CellState::Breaker);
+        if (placing_maker) {
+            enumerate(state, c + 1, maker - 1, breaker, true, sums, placements);
+        } else {
+            enumerate(state, c + 1, 0, breaker - 1, false, sums, placements);
+        }
+        state.undo();
+    }
+}
+
+void test_expected_matches_enumeration() {
+    const int32_t n = 4;
+    auto edges = game::EdgeGenerator::generate_edges(n);
+    game::ExpectedPotential expected(edges, 4 * n);
+    game::IncrementalPotential state(game::Board(n), edges);
+
+    // Ply 0 is the empty board itself
+    auto empty = expected.at(0);
+    game::Board board(n);
+    game::PotentialCalculator calc(board, edges);
+    auto hist = calc.compute_histogram();
+    for (size_t l = 0; l < hist.size(); ++l) {
+        ASSERT_TRUE(near(empty.lines[l], hist[l]), "Ply 0 histogram is the empty board's");
+    }
+    ASSERT_TRUE(near(empty.potential, calc.compute_potential()), "Ply 0 potential is the empty board's");
+
+    for (int32_t ply = 1; ply <= 5; ++ply) {
+        std::vector<long double> sums(8, 0.0L);
+        int64_t placements = 0;
+        enumerate(state, 0, (ply + 1) / 2, ply / 2, true, sums, placements);
+        auto row = expected.at(ply);
+        for (size_t l = 0; l < 7; ++l) {
+            ASSERT_TRUE(near(row.lines[l], sums[l] / static_cast<long double>(placements)),
+                        "E[x_l] equals the average over all placements");
+        }
+        ASSERT_TRUE(near(row.potential, sums[7] / static_cast<long double>(placements)),
+                    "E[pot] equals the average over all placements");
+    }
+
+    auto full = expected.at(4 * n);
+    ASSERT_TRUE(full.potential == 0.0L, "A full board has no l-lines");
+    ASSERT_TRUE(near(game::ExpectedPotential::line_probability(3, 3, 0, 0, 10), 1.0L),
+                "An edge on the empty board is an s-line");
+
+    TEST_PASS();
+}
+
+void test_expected_matches_sampling() {
+    // Within a few standard errors at every ply, also for another board shape
+    struct Shape { int32_t rows, cols, k; };
+    for (Shape shape : {Shape{4, 12, 7}, Shape{5, 8, 6}}) {
+        auto edges = game::EdgeGenerator::generate_edges(shape.cols, shape.rows, shape.k);
+        game::ExpectedPotential expected(edges, shape.rows * shape.cols, shape.k);
+        auto sampled = game::ExpectedPotential::sample(shape.cols, shape.rows, edges, shape.k, 2000, 9);
+        ASSERT_EQ(sampled.size(), static_cast<size_t>(shape.rows * shape.cols + 1), "One sample per ply");
+        double worst = 0.0;
+        for (size_t ply = 0; ply < sampled.size(); ++ply) {
+            auto row = expected.at(static_cast<int32_t>(ply));
+            double error = std::fabs(static_cast<double>(row.potential) - sampled[ply].potential);
+            if (sampled[ply].potential_stderr > 0.0) {
+                worst = std::max(worst, error / sampled[ply].potential_stderr);
+            } else {
+                ASSERT_TRUE(error < 1e-9, "Deterministic plies match exactly");
+            }
+        }
+        ASSERT_TRUE(worst < 5.0, "Monte-Carlo mean within five standard errors");
+    }
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_expected_potential() {
+    test_expected_matches_enumeration();
+    test_expected_matches_sampling();
+}
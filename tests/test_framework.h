@@ -1,7 +1,15 @@
 #pragma once
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <unistd.h>
 #include <vector>
 
 namespace test {
@@ -45,6 +53,32 @@ private:
     std::vector<TestResult> results_;
 };
 
+// A fresh empty file under /tmp; the caller removes it
+inline std::string temp_path(const std::string& prefix = "game_test") {
+    std::string path = "/tmp/" + prefix + "_XXXXXX";
+    int fd = ::mkstemp(path.data());
+    if (fd < 0) {
+        throw std::runtime_error("mkstemp failed for " + path + ": " + std::strerror(errno));
+    }
+    ::close(fd);
+    return path;
+}
+
+inline std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+inline std::vector<std::string> split(const std::string& line, char separator) {
+    std::vector<std::string> fields;
+    std::istringstream iss(line);
+    std::string field;
+    while (std::getline(iss, field, separator)) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
 #define ASSERT_TRUE(cond, msg) \
     do { \
         if (!(cond)) { \
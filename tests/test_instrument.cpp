@@ -0,0 +1,82 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "util/Instrument.h"
+#include <sstream>
+
+void test_instrument();
+
+namespace {
+
+int64_t touched = 0;
+
+[[maybe_unused]] int64_t touch() {
+    ++touched;
+    return 1;
+}
+
+void test_macros_match_build() {
+    touched = 0;
+    for (int i = 0; i < 3; ++i) {
+        GAME_SCOPE("test.scope");
+        GAME_SCOPE("test.inner"); GAME_SCOPE("test.same_line");
+        GAME_COUNT("test.counter", touch());
+    }
+    ASSERT_EQ(touched, game::Instrument::kEnabled ? int64_t{3} : int64_t{0},
+              "Counter arguments are evaluated only in instrumented builds");
+
+    TEST_PASS();
+}
+
+void test_summary_and_trace() {
+    if (!game::Instrument::kEnabled) {
+        TEST_PASS();
+        return;
+    }
+
+    game::InstrumentOptions options;
+    options.trace = true;
+    options.trace_min_ns = 0;
+    game::Instrument::start(options);
+    auto edges = game::EdgeGenerator::generate_edges(9);
+    for (int i = 0; i < 5; ++i) {
+        GAME_SCOPE("test.scope");
+        GAME_COUNT("test.counter", 2);
+    }
+
+    std::ostringstream summary;
+    game::Instrument::write_summary(summary);
+    std::string text = summary.str();
+    ASSERT_TRUE(text.find("EdgeGenerator::generate_edges") != std::string::npos, "Library scope reported");
+    ASSERT_TRUE(text.find("edges.generated") != std::string::npos, "Library counter reported");
+    std::istringstream lines(text);
+    std::string line;
+    bool counted = false;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        int64_t value = 0;
+        if (fields >> name >> value && name == "test.counter") counted = value == 10;
+    }
+    ASSERT_TRUE(counted, "Counter sums every add since start");
+
+    std::ostringstream trace;
+    game::Instrument::write_trace(trace);
+    std::string json = trace.str();
+    ASSERT_TRUE(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0, "Trace header");
+    ASSERT_TRUE(json.find("{\"name\":\"test.scope\",\"ph\":\"X\"") != std::string::npos, "Scope event traced");
+    ASSERT_TRUE(json.size() >= 4 && json.compare(json.size() - 4, 4, "\n]}\n") == 0, "Trace closed");
+
+    game::Instrument::start(game::InstrumentOptions{});
+    std::ostringstream cleared;
+    game::Instrument::write_trace(cleared);
+    ASSERT_EQ(cleared.str(), std::string("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n"), "start resets events");
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_instrument() {
+    test_macros_match_build();
+    test_summary_and_trace();
+}
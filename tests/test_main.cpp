@@ -3,12 +3,46 @@
 // Test declarations
 void test_edge_generation();
 void test_potential_calculation();
+void test_certification();
+void test_decomposition();
+void test_mcts();
+void test_proof_number_search();
+void test_serve();
+void test_position_codec();
+void test_perft();
+void test_tablebase();
+void test_pairing();
+void test_sweep();
+void test_instrument();
+void test_checkpoint();
+void test_coordinator();
+void test_edge_file();
+void test_expected_potential();
+void test_pipeline();
+void test_trajectory();
 
 int main() {
     std::cout << "Running tests...\n\n";
     
     test_edge_generation();
     test_potential_calculation();
+    test_certification();
+    test_decomposition();
+    test_mcts();
+    test_proof_number_search();
+    test_serve();
+    test_position_codec();
+    test_perft();
+    test_tablebase();
+    test_pairing();
+    test_sweep();
+    test_instrument();
+    test_checkpoint();
+    test_coordinator();
+    test_edge_file();
+    test_expected_potential();
+    test_pipeline();
+    test_trajectory();
     
     return test::TestRunner::instance().run();
 }
@@ -0,0 +1,85 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "search/Mcts.h"
+#include "util/Cli.h"
+
+void test_mcts();
+
+namespace {
+
+game::Game threat_position(const std::vector<game::Hyperedge>& edges) {
+    // Maker holds (0,0),(0,1),(0,2); (0,3) completes the left truncated edge
+    game::Game g(7, edges);
+    for (const auto& cell : game::CliParser::parse_moves("0,0 3,6 0,1 3,5 0,2 2,6")) {
+        g.make_move(cell);
+    }
+    return g;
+}
+
+void test_mcts_finds_winning_move(game::MctsMode mode, const char* name) {
+    auto edges = game::EdgeGenerator::generate_edges(7);
+    game::Game g = threat_position(edges);
+    
+    game::MctsOptions options;
+    options.iterations = 4000;
+    options.threads = 2;
+    options.mode = mode;
+    options.max_nodes = 1 << 16;
+    game::MctsEngine engine(g, options);
+    auto result = engine.search();
+    
+    if (result.principal_variation.empty() || !(result.principal_variation[0] == game::Cell{0, 3})) {
+        test::TestRunner::instance().add_result({name, false, "MCTS should complete the edge at (0,3)"});
+        return;
+    }
+    if (result.playouts != options.iterations) {
+        test::TestRunner::instance().add_result({name, false, "Playout count should match the iteration budget"});
+        return;
+    }
+    test::TestRunner::instance().add_result({name, true, ""});
+}
+
+void test_mcts_small_arena() {
+    // A full arena stops expansion but the search still completes
+    auto edges = game::EdgeGenerator::generate_edges(10);
+    game::Game g(10, edges);
+    
+    game::MctsOptions options;
+    options.iterations = 500;
+    options.max_nodes = 64;
+    game::MctsEngine engine(g, options);
+    auto result = engine.search();
+    
+    ASSERT_EQ(result.playouts, int64_t{500}, "All playouts should run");
+    ASSERT_TRUE(result.nodes <= 64, "Arena capacity exceeded");
+    ASSERT_TRUE(!result.principal_variation.empty(), "Root should have been expanded");
+    
+    TEST_PASS();
+}
+
+void test_mcts_needs_budget() {
+    // Time only (-i 0) without a deadline would never stop
+    auto edges = game::EdgeGenerator::generate_edges(7);
+    game::Game g(7, edges);
+    game::MctsOptions options;
+    options.iterations = 0;
+    try {
+        game::MctsEngine engine(g, options);
+        ASSERT_TRUE(false, "No iteration or time budget should throw");
+    } catch (const std::invalid_argument&) {
+    }
+    options.time_ms = 20;
+    game::MctsEngine engine(g, options);
+    ASSERT_TRUE(engine.search().playouts > 0, "Time-only search runs until the deadline");
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_mcts() {
+    test_mcts_finds_winning_move(game::MctsMode::TreeParallel, "test_mcts_tree_parallel_finds_win");
+    test_mcts_finds_winning_move(game::MctsMode::RootParallel, "test_mcts_root_parallel_finds_win");
+    test_mcts_small_arena();
+    test_mcts_needs_budget();
+}
@@ -0,0 +1,152 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "search/Pairing.h"
+#include <algorithm>
+#include <random>
+
+void test_pairing();
+
+namespace {
+
+// Exhaustive search over partial matchings of the cells, as a reference
+bool reference_exists(int32_t num_cols, const std::vector<game::Hyperedge>& edges, std::vector<int32_t>& partner,
+                      int32_t cell) {
+    int32_t num_cells = 4 * num_cols;
+    if (cell == num_cells) {
+        for (const auto& edge : edges) {
+            bool covered = false;
+            for (const auto& a : edge) {
+                for (const auto& b : edge) {
+                    covered = covered || partner[static_cast<size_t>(a.row * num_cols + a.col)] == b.row * num_cols + b.col;
+                }
+            }
+            if (!covered) return false;
+        }
+        return true;
+    }
+    // Already paired, or left unpaired
+    if (reference_exists(num_cols, edges, partner, cell + 1)) return true;
+    if (partner[static_cast<size_t>(cell)] >= 0) return false;
+    for (int32_t other = cell + 1; other < num_cells; ++other) {
+        if (partner[static_cast<size_t>(other)] >= 0) continue;
+        // Pairs outside every edge never help
+        bool shared = false;
+        for (const auto& edge : edges) {
+            bool has_cell = false;
+            bool has_other = false;
+            for (const auto& c : edge) {
+                has_cell = has_cell || c.row * num_cols + c.col == cell;
+                has_other = has_other || c.row * num_cols + c.col == other;
+            }
+            shared = shared || (has_cell && has_other);
+        }
+        if (!shared) continue;
+        partner[static_cast<size_t>(cell)] = other;
+        partner[static_cast<size_t>(other)] = cell;
+        bool found = reference_exists(num_cols, edges, partner, cell + 1);
+        partner[static_cast<size_t>(cell)] = -1;
+        partner[static_cast<size_t>(other)] = -1;
+        if (found) return true;
+    }
+    return false;
+}
+
+void test_pairing_game_edges() {
+    // Each column needs a vertical pair, and from n=4 on the diagonals and
+    // rows need more pairs than the cells left over can supply
+    game::PairingFinder finder(game::PairingOptions{});
+    for (int32_t n = 1; n <= 3; ++n) {
+        auto edges = game::EdgeGenerator::generate_edges(n);
+        auto result = finder.find(n, edges);
+        ASSERT_TRUE(result.pairing.has_value(), "Vertical pairs suffice below n=4");
+        ASSERT_TRUE(!result.pairing->find_uncovered(n, edges).has_value(), "Found pairing covers every edge");
+    }
+    for (int32_t n : {4, 7, 12}) {
+        ASSERT_TRUE(!finder.find(n, game::EdgeGenerator::generate_edges(n)).pairing.has_value(), "No pairing");
+    }
+    auto strip = finder.find_periodic(game::PairingFinder::strip_templates());
+    ASSERT_TRUE(!strip.pairing.has_value(), "No periodic pairing of the strip");
+
+    TEST_PASS();
+}
+
+void test_pairing_matches_reference() {
+    // Random short edges on narrow boards
+    std::mt19937 rng(9);
+    int32_t found = 0;
+    for (int32_t trial = 0; trial < 60; ++trial) {
+        int32_t num_cols = 2 + trial % 2;
+        std::uniform_int_distribution<int32_t> row(0, 3);
+        std::uniform_int_distribution<int32_t> col(0, num_cols - 1);
+        std::vector<game::Hyperedge> edges;
+        for (int32_t e = 0; e < 1 + trial % 5; ++e) {
+            game::Hyperedge edge;
+            while (edge.size() < 3) {
+                game::Cell cell{row(rng), col(rng)};
+                if (std::find(edge.begin(), edge.end(), cell) == edge.end()) edge.push_back(cell);
+            }
+            std::sort(edge.begin(), edge.end());
+            edges.push_back(edge);
+        }
+
+        std::vector<int32_t> partner(static_cast<size_t>(4 * num_cols), -1);
+        bool expected = reference_exists(num_cols, edges, partner, 0);
+        auto result = game::PairingFinder(game::PairingOptions{}).find(num_cols, edges);
+        ASSERT_EQ(result.pairing.has_value(), expected, "Existence matches exhaustive search");
+        if (result.pairing) {
+            ++found;
+            ASSERT_TRUE(!result.pairing->find_uncovered(num_cols, edges).has_value(), "Pairing is valid");
+        }
+    }
+    ASSERT_TRUE(found > 0 && found < 60, "Trials include both outcomes");
+
+    TEST_PASS();
+}
+
+void test_pairing_periodic_and_format() {
+    // Length-4 rows alone: pairs of adjacent cells with period 2
+    std::vector<game::Hyperedge> templates;
+    for (int32_t r = 0; r < 4; ++r) {
+        templates.push_back({{r, 0}, {r, 1}, {r, 2}, {r, 3}});
+    }
+    game::PairingOptions options;
+    options.span = 3;
+    auto result = game::PairingFinder(options).find_periodic(templates);
+    ASSERT_TRUE(result.pairing.has_value(), "Periodic pairing exists");
+    ASSERT_EQ(result.period, 2, "Shortest period");
+
+    const int32_t width = 20;
+    std::vector<game::Hyperedge> edges;
+    for (int32_t s = 0; s + 4 <= width; ++s) {
+        for (auto edge : templates) {
+            for (auto& cell : edge) cell.col += s;
+            edges.push_back(edge);
+        }
+    }
+    auto parsed = game::Pairing::parse("# strip\n" + result.pairing->format());
+    ASSERT_EQ(parsed.format(), result.pairing->format(), "Format round trip");
+    ASSERT_TRUE(!parsed.find_uncovered(width, edges).has_value(), "Translates cover the board");
+
+    game::Pairing broken = game::Pairing::parse("pairing width 4\n0,0 0,1\n");
+    ASSERT_TRUE(broken.find_uncovered(width, edges).has_value(), "A missing pair is reported");
+    try {
+        game::Pairing::parse("pairing width 4\n0,0 0,1\n0,1 0,2\n").expand(4);
+        ASSERT_TRUE(false, "Overlapping pairs should throw");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        game::Pairing::parse("pairing width 4\n0,0 0,x\n");
+        ASSERT_TRUE(false, "Malformed pair should throw");
+    } catch (const std::invalid_argument&) {
+    }
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_pairing() {
+    test_pairing_game_edges();
+    test_pairing_matches_reference();
+    test_pairing_periodic_and_format();
+}
@@ -0,0 +1,109 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "metrics/Potential.h"
+#include "search/Perft.h"
+#include "util/Cli.h"
+#include <set>
+
+void test_perft();
+
+namespace {
+
+// Plain recursion over Board copies with full rescans, as a reference
+void reference_perft(const game::Board& board, const std::vector<game::Hyperedge>& edges, game::Player to_move,
+                     int32_t ply, int32_t depth, bool stop_at_certificate,
+                     std::vector<game::PerftPly>& counts, std::vector<std::set<std::string>>& seen) {
+    for (const auto& cell : board.get_empty_cells()) {
+        game::Board next = board;
+        next.set(cell, to_move == game::Player::Maker ? game::CellState::Maker : game::CellState::Breaker);
+        game::Player opponent = to_move == game::Player::Maker ? game::Player::Breaker : game::Player::Maker;
+        auto& c = counts[static_cast<size_t>(ply)];
+        ++c.sequences;
+        seen[static_cast<size_t>(ply)].insert(next.to_string());
+
+        game::Game check(next, edges, opponent);
+        if (check.check_maker_win()) {
+            ++c.maker_wins;
+        } else if (stop_at_certificate && opponent == game::Player::Breaker &&
+                   game::PotentialCalculator(next, edges).has_breaker_certificate()) {
+            ++c.certificates;
+        } else if (ply < depth) {
+            reference_perft(next, edges, opponent, ply + 1, depth, stop_at_certificate, counts, seen);
+        }
+    }
+}
+
+void test_perft_empty_board() {
+    // No edge can be completed in 3 plies, so every sequence continues
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Game g(4, edges);
+    game::PerftOptions options;
+    options.depth = 3;
+    options.threads = 3;
+    auto result = game::Perft(g, options).run();
+
+    ASSERT_EQ(result.plies[1].sequences, int64_t{16}, "Ply 1 sequences");
+    ASSERT_EQ(result.plies[2].sequences, int64_t{16 * 15}, "Ply 2 sequences");
+    ASSERT_EQ(result.plies[3].sequences, int64_t{16 * 15 * 14}, "Ply 3 sequences");
+    ASSERT_EQ(result.plies[2].distinct, int64_t{16 * 15}, "Ply 2 positions");
+    ASSERT_EQ(result.plies[3].distinct, int64_t{120 * 14}, "Ply 3 positions: two Maker cells, one Breaker");
+    ASSERT_EQ(result.nodes, int64_t{16 + 240 + 3360}, "Node total");
+
+    TEST_PASS();
+}
+
+void test_perft_matches_reference() {
+    // Maker holds (0,1),(1,1),(2,1): every Breaker move but (3,1) loses at once
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    for (bool stop : {false, true}) {
+        game::Game g(4, edges);
+        for (const auto& cell : game::CliParser::parse_moves("0,1 0,0 1,1 3,3 2,1")) {
+            g.make_move(cell);
+        }
+        game::PerftOptions options;
+        options.depth = 4;
+        options.stop_at_certificate = stop;
+        options.threads = 2;
+        auto result = game::Perft(g, options).run();
+
+        std::vector<game::PerftPly> counts(5);
+        std::vector<std::set<std::string>> seen(5);
+        reference_perft(g.board(), edges, g.current_player(), 1, 4, stop, counts, seen);
+        for (size_t ply = 1; ply <= 4; ++ply) {
+            ASSERT_EQ(result.plies[ply].sequences, counts[ply].sequences, "Sequences per ply");
+            ASSERT_EQ(result.plies[ply].maker_wins, counts[ply].maker_wins, "Maker wins per ply");
+            ASSERT_EQ(result.plies[ply].certificates, counts[ply].certificates, "Certificate stops per ply");
+            ASSERT_EQ(result.plies[ply].distinct, static_cast<int64_t>(seen[ply].size()), "Distinct positions per ply");
+        }
+        ASSERT_TRUE(counts[2].maker_wins > 0, "Position should contain immediate wins");
+    }
+
+    TEST_PASS();
+}
+
+void test_game_undo() {
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Game g(4, edges);
+    for (const auto& cell : game::CliParser::parse_moves("0,1 0,0 1,1 3,3 2,1 2,2")) {
+        g.make_move(cell);
+    }
+    std::string before = g.board().to_string();
+
+    ASSERT_TRUE(g.make_move({3, 1}).maker_wins, "Completing the column wins");
+    g.undo_move();
+    ASSERT_EQ(g.board().to_string(), before, "Undo restores the board");
+    ASSERT_TRUE(g.current_player() == game::Player::Maker, "Undo restores the side to move");
+    ASSERT_EQ(g.move_count(), 6, "Undo restores the move count");
+    ASSERT_TRUE(!g.make_move({3, 2}).maker_wins, "The undone win is forgotten");
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_perft() {
+    test_perft_empty_board();
+    test_perft_matches_reference();
+    test_game_undo();
+}
@@ -0,0 +1,153 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "metrics/Potential.h"
+#include "service/PlayoutPipeline.h"
+#include "util/BoundedQueue.h"
+#include "util/Format.h"
+#include <optional>
+#include <sstream>
+#include <thread>
+
+void test_pipeline();
+
+namespace {
+
+std::string run_pipeline(game::PipelineOptions options, game::PipelineStats* stats = nullptr) {
+    std::ostringstream out;
+    game::PlayoutPipeline pipeline(options);
+    auto result = pipeline.run(out);
+    if (stats) *stats = result;
+    return out.str();
+}
+
+void test_queue_many_producers() {
+    // Every item arrives exactly once through a ring far smaller than the load
+    game::BoundedQueue<int64_t> queue(4);
+    ASSERT_EQ(queue.capacity(), static_cast<size_t>(4), "Capacity is a power of two");
+    const int64_t per_producer = 20000;
+    std::vector<std::thread> producers;
+    for (int64_t p = 0; p < 3; ++p) {
+        producers.emplace_back([&queue, p, per_producer] {
+            for (int64_t i = 0; i < per_producer; ++i) {
+                queue.push(p * per_producer + i + 1);
+            }
+        });
+    }
+    std::vector<int64_t> sums(2, 0);
+    std::vector<int64_t> counts(2, 0);
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < 2; ++c) {
+        consumers.emplace_back([&queue, &sums, &counts, c] {
+            int64_t value = 0;
+            while (queue.pop(value)) {
+                sums[c] += value;
+                ++counts[c];
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    queue.close();
+    for (auto& t : consumers) t.join();
+
+    int64_t n = 3 * per_producer;
+    ASSERT_EQ(counts[0] + counts[1], n, "Every item popped once");
+    ASSERT_EQ(sums[0] + sums[1], n * (n + 1) / 2, "No item lost or duplicated");
+    auto stats = queue.stats();
+    ASSERT_EQ(stats.pushes, n, "Pushes counted");
+    ASSERT_TRUE(stats.max_occupancy <= 4, "Occupancy bounded by the capacity");
+    TEST_PASS();
+}
+
+void test_pipeline_thread_independent() {
+    // Small blocks and rings force backpressure; the bytes must not change
+    game::PipelineOptions options;
+    options.num_cols = 8;
+    options.games = 300;
+    options.games_per_block = 7;
+    options.queue_blocks = 2;
+    std::string serial = run_pipeline(options);
+
+    options.generate_threads = 2;
+    options.evaluate_threads = 3;
+    options.write_threads = 2;
+    game::PipelineStats stats;
+    std::string parallel = run_pipeline(options, &stats);
+    ASSERT_TRUE(serial == parallel, "Output independent of stage thread counts");
+    ASSERT_EQ(stats.generate.items, int64_t{300}, "Every game generated");
+    ASSERT_EQ(stats.generate.blocks, int64_t{43}, "Games handed over in blocks");
+    ASSERT_EQ(stats.write.items, stats.positions, "Every position written");
+    ASSERT_TRUE(stats.moves_queue.max_occupancy <= 2 && stats.results_queue.max_occupancy <= 2,
+                "Rings stay within their capacity");
+
+    // Single-block rings leave the reorder window barely wider than the threads
+    options.queue_blocks = 1;
+    options.evaluate_threads = 4;
+    options.write_threads = 3;
+    ASSERT_TRUE(serial == run_pipeline(options), "Output unchanged with a narrow reorder window");
+    TEST_PASS();
+}
+
+void test_pipeline_matches_game() {
+    // Replay every row on a Game and rescan the potential from scratch
+    game::PipelineOptions options;
+    options.num_cols = 7;
+    options.games = 40;
+    options.games_per_block = 3;
+    options.evaluate_threads = 2;
+    game::PipelineStats stats;
+    std::istringstream in(run_pipeline(options, &stats));
+    auto edges = game::EdgeGenerator::generate_edges(options.num_cols);
+
+    std::string line;
+    std::getline(in, line);
+    ASSERT_TRUE(line == "game,move,player,row,col,x1,x2,x3,x4,x5,x6,x7,pot,maker_win,breaker_cert",
+                "CSV header");
+    std::optional<game::Game> g;
+    int64_t current = -1;
+    bool finished = true;
+    int64_t rows = 0;
+    int64_t wins = 0;
+    while (std::getline(in, line)) {
+        auto f = test::split(line, ',');
+        ASSERT_EQ(f.size(), static_cast<size_t>(15), "Row has every column");
+        int64_t index = std::stoll(f[0]);
+        if (index != current) {
+            ASSERT_TRUE(finished, "Previous game ran to a win, a full board or max moves");
+            ASSERT_EQ(index, current + 1, "Games in order");
+            current = index;
+            g.emplace(game::Board(options.num_cols), edges, game::Player::Maker);
+        }
+        ASSERT_EQ(std::stoi(f[1]), g->move_count() + 1, "Moves numbered from 1");
+        bool breaker = g->current_player() == game::Player::Breaker;
+        ASSERT_TRUE(f[2] == (breaker ? "b" : "m"), "Players alternate, Maker first");
+        bool cert = breaker && game::PotentialCalculator(g->board(), edges).has_breaker_certificate();
+        auto result = g->make_move(game::Cell{std::stoi(f[3]), std::stoi(f[4])});
+
+        game::PotentialCalculator calc(g->board(), edges);
+        auto hist = calc.compute_histogram();
+        for (size_t l = 0; l < hist.size(); ++l) {
+            ASSERT_EQ(std::stoi(f[5 + l]), hist[l], "Histogram matches a full rescan");
+        }
+        ASSERT_TRUE(f[12] == game::Formatter::format_potential(calc.compute_potential()),
+                    "Potential matches a full rescan");
+        ASSERT_TRUE(f[13] == (result.maker_wins ? "1" : "0"), "Maker win flag");
+        ASSERT_TRUE(f[14] == (cert ? "1" : "0"), "Certificate checked before Breaker's move");
+        finished = result.maker_wins || g->move_count() == options.max_moves ||
+                   g->board().get_empty_cells().empty();
+        ++rows;
+        wins += result.maker_wins ? 1 : 0;
+    }
+    ASSERT_TRUE(finished && current == options.games - 1, "Every game played to its end");
+    ASSERT_EQ(stats.positions, rows, "One row per position");
+    ASSERT_EQ(stats.maker_wins, wins, "Maker wins counted");
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_pipeline() {
+    test_queue_many_producers();
+    test_pipeline_thread_independent();
+    test_pipeline_matches_game();
+}
@@ -0,0 +1,190 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "metrics/Potential.h"
+#include "search/Certifier.h"
+#include "service/BulkEvaluator.h"
+#include "util/Cli.h"
+#include "util/Format.h"
+#include "util/Position.h"
+#include <cstring>
+#include <random>
+#include <sstream>
+
+void test_position_codec();
+
+namespace {
+
+game::Board random_position(int32_t num_cols, int32_t num_moves, std::mt19937& rng) {
+    game::Board board(num_cols);
+    auto empty = board.get_empty_cells();
+    for (int32_t i = 0; i < num_moves && !empty.empty(); ++i) {
+        std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+        size_t pick = dist(rng);
+        board.set(empty[pick], i % 2 == 0 ? game::CellState::Maker : game::CellState::Breaker);
+        empty.erase(empty.begin() + static_cast<std::ptrdiff_t>(pick));
+    }
+    return board;
+}
+
+bool same_board(const game::Board& a, const game::Board& b) {
+    return a.cols() == b.cols() && a.to_string() == b.to_string();
+}
+
+bool throws_on(const std::string& text) {
+    try {
+        game::PositionCodec::parse(text);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void test_position_text_notation() {
+    auto position = game::PositionCodec::parse("M9/10/3B6/10");
+    ASSERT_EQ(position.board.cols(), 10, "Width from the row lengths");
+    ASSERT_TRUE(position.board.get(0, 0) == game::CellState::Maker, "M at (0,0)");
+    ASSERT_TRUE(position.board.get(2, 3) == game::CellState::Breaker, "B at (2,3)");
+    ASSERT_TRUE(position.to_move == game::Player::Maker, "Equal counts mean Maker to move");
+    ASSERT_EQ(game::PositionCodec::format(position.board, position.to_move), std::string("M9/10/3B6/10 m"),
+              "Round trip through the notation");
+
+    ASSERT_TRUE(game::PositionCodec::parse("12/12/12/M11").to_move == game::Player::Breaker,
+                "One extra Maker cell means Breaker to move");
+    ASSERT_TRUE(game::PositionCodec::parse("MM5/7/7/7 m").to_move == game::Player::Maker,
+                "An explicit side overrides the counts");
+
+    ASSERT_TRUE(throws_on("M9/10/10"), "Three rows");
+    ASSERT_TRUE(throws_on("M9/10/10/9"), "Ragged rows");
+    ASSERT_TRUE(throws_on("X9/10/10/10"), "Unknown cell character");
+    ASSERT_TRUE(throws_on("MM8/10/10/10"), "Counts that cannot arise in play");
+    ASSERT_TRUE(throws_on("M9/10/10/10 x"), "Unknown side");
+
+    TEST_PASS();
+}
+
+void test_position_packing() {
+    std::mt19937 rng(7);
+    for (int32_t trial = 0; trial < 50; ++trial) {
+        int32_t num_cols = 1 + trial % 13;
+        game::Board board = random_position(num_cols, trial % (4 * num_cols + 1), rng);
+        std::vector<uint8_t> packed(game::PositionCodec::packed_size(num_cols));
+        game::PositionCodec::pack(board, packed.data());
+        auto unpacked = game::PositionCodec::unpack(packed.data(), num_cols);
+        ASSERT_TRUE(same_board(board, unpacked.board), "Packed round trip");
+
+        std::string text = game::PositionCodec::format(board, unpacked.to_move);
+        ASSERT_TRUE(same_board(board, game::PositionCodec::parse(text).board), "Text round trip");
+    }
+    ASSERT_EQ(game::PositionCodec::parse_packed_header(game::PositionCodec::packed_header(300)), 300,
+              "Header round trip");
+    ASSERT_EQ(game::PositionCodec::parse_packed_header("M9/10/10/10\n"), 0, "Text is not a packed file");
+
+    TEST_PASS();
+}
+
+void test_bulk_evaluation() {
+    // Same positions as text and as packed records; tiny chunks force many tasks
+    std::mt19937 rng(11);
+    const int32_t num_cols = 8;
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    std::string text = "# generated\n";
+    std::string packed = game::PositionCodec::packed_header(num_cols);
+    std::string expected = "index,to_move,x1,x2,x3,x4,x5,x6,x7,pot,maker_won,certified\n";
+    const int32_t count = 40;
+    std::vector<std::string> pots;
+    for (int32_t i = 0; i < count; ++i) {
+        game::Board board = random_position(num_cols, i % 12, rng);
+        game::Player to_move = (i % 12) % 2 == 0 ? game::Player::Maker : game::Player::Breaker;
+        text += game::PositionCodec::format(board, to_move) + (i % 5 == 0 ? "\n\n" : "\n");
+        std::vector<uint8_t> record(game::PositionCodec::packed_size(num_cols));
+        game::PositionCodec::pack(board, record.data());
+        packed.append(record.begin(), record.end());
+
+        game::PotentialCalculator calc(board, edges);
+        auto hist = calc.compute_histogram();
+        expected += std::to_string(i) + (to_move == game::Player::Maker ? ",m" : ",b");
+        for (int32_t x : hist) expected += "," + std::to_string(x);
+        expected += "," + game::Formatter::format_potential(calc.compute_potential());
+        bool certified = to_move == game::Player::Breaker && calc.has_breaker_certificate();
+        expected += certified ? ",0,1\n" : ",0,0\n";
+        pots.push_back(game::Formatter::format_potential(calc.compute_potential()));
+    }
+
+    game::BulkOptions options;
+    options.threads = 3;
+    options.depth = 0;
+    options.chunk_bytes = 64;
+    game::BulkEvaluator evaluator(options);
+
+    std::ostringstream from_text;
+    auto stats = evaluator.run(text, from_text);
+    ASSERT_EQ(stats.positions, int64_t{count}, "Comments and blank lines are skipped");
+    ASSERT_EQ(from_text.str(), expected, "CSV from the text file");
+
+    std::ostringstream from_packed;
+    evaluator.run(packed, from_packed);
+    ASSERT_EQ(from_packed.str(), expected, "CSV from the packed file");
+
+    // Columnar: walk the row groups and check the potential column
+    options.format = game::BulkFormat::Columnar;
+    game::BulkEvaluator columnar(options);
+    std::ostringstream binary;
+    columnar.run(packed, binary);
+    std::string data = binary.str();
+    ASSERT_TRUE(data.compare(0, 4, "7REV") == 0, "Columnar magic");
+    size_t offset = 8;
+    uint64_t rows_seen = 0;
+    while (offset < data.size()) {
+        uint32_t rows = 0;
+        uint64_t first = 0;
+        std::memcpy(&rows, data.data() + offset, 4);
+        std::memcpy(&first, data.data() + offset + 4, 8);
+        ASSERT_EQ(first, rows_seen, "Row groups are written in input order");
+        for (uint32_t r = 0; r < rows; ++r) {
+            double pot = 0.0;
+            std::memcpy(&pot, data.data() + offset + 12 + 8 * size_t{r}, 8);
+            ASSERT_EQ(game::Formatter::format_potential(pot), pots[first + r], "Potential column");
+        }
+        offset += 12 + size_t{rows} * (8 + 4 * 7 + 3);
+        rows_seen += rows;
+    }
+    ASSERT_EQ(offset, data.size(), "Row groups tile the output");
+    ASSERT_EQ(rows_seen, uint64_t{count}, "Every position has a row");
+
+    // pot < 1 is a certificate only on Breaker's turn, as in Certifier
+    const std::string blocked = "BBBBBB1/BBBBBBB/BBBBBBB/BBBBBBB";
+    auto blocked_edges = game::EdgeGenerator::generate_edges(7);
+    for (int32_t depth : {0, 2}) {
+        game::BulkOptions shallow;
+        shallow.depth = depth;
+        game::BulkEvaluator bulk(shallow);
+        std::ostringstream rows;
+        bulk.run(blocked + " m\n" + blocked + " b\n", rows);
+        std::string zero = ",0,0,0,0,0,0,0,0.000000,0,";
+        game::Board board = game::PositionCodec::parse(blocked + " m").board;
+        game::Certifier maker_to_move(board, blocked_edges, {depth, game::BreakerReplies::Greedy});
+        bool certified = maker_to_move.certify(game::Player::Maker).certified;
+        ASSERT_EQ(rows.str(), expected.substr(0, expected.find('\n') + 1) + "0,m" + zero +
+                                  (certified ? "1" : "0") + "\n1,b" + zero + "1\n",
+                  "Certificate column matches Certifier for either side to move");
+        ASSERT_TRUE(depth > 0 || !certified, "Maker to move with pot < 1 is not certified at depth 0");
+    }
+
+    std::ostringstream ignored;
+    try {
+        evaluator.run("M7/8/8/8\n8/8/8\n", ignored);
+        ASSERT_TRUE(false, "Malformed line should throw");
+    } catch (const std::invalid_argument& e) {
+        ASSERT_TRUE(std::string(e.what()).rfind("Line 2:", 0) == 0, "Error should name the line");
+    }
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_position_codec() {
+    test_position_text_notation();
+    test_position_packing();
+    test_bulk_evaluation();
+}
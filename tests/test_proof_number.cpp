@@ -0,0 +1,104 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "core/Game.h"
+#include "metrics/IncrementalPotential.h"
+#include "search/ProofNumber.h"
+#include <random>
+
+void test_proof_number_search();
+
+namespace {
+
+// Plain minimax over every empty cell, with the same terminal rules
+bool maker_wins_bruteforce(game::IncrementalPotential& state, game::Player to_move) {
+    if (state.maker_won()) return true;
+    if (state.num_empty() == 0) return false;
+    if (to_move == game::Player::Breaker && state.has_breaker_certificate()) return false;
+    
+    for (int32_t c = 0; c < state.index().num_cells(); ++c) {
+        if (!state.is_empty(c)) continue;
+        bool maker = to_move == game::Player::Maker;
+        state.place(c, maker ? game::CellState::Maker : game::CellState::Breaker);
+        bool wins = maker_wins_bruteforce(state, maker ? game::Player::Breaker : game::Player::Maker);
+        state.undo();
+        if (maker && wins) return true;
+        if (!maker && !wins) return false;
+    }
+    return to_move == game::Player::Breaker;
+}
+
+void test_pns_matches_bruteforce() {
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    std::mt19937 rng(17);
+    int32_t proved = 0;
+    int32_t disproved = 0;
+    
+    for (int32_t trial = 0; trial < 40; ++trial) {
+        game::Game g(4, edges);
+        bool won = false;
+        for (int32_t move = 0; move < 8 && !won; ++move) {
+            auto empty = g.board().get_empty_cells();
+            std::uniform_int_distribution<size_t> dist(0, empty.size() - 1);
+            won = g.make_move(empty[dist(rng)]).maker_wins;
+        }
+        if (won) continue;
+        
+        game::IncrementalPotential state(g.board(), edges);
+        bool expected = maker_wins_bruteforce(state, g.current_player());
+        game::ProofNumberSearch search(g.board(), edges, g.current_player(), game::PnOptions{});
+        auto result = search.solve();
+        
+        ASSERT_TRUE(result.value != game::PnValue::Unknown, "Search should finish without a budget");
+        ASSERT_EQ(result.value == game::PnValue::Proved, expected, "Proof-number result differs from minimax");
+        (expected ? proved : disproved)++;
+    }
+    ASSERT_TRUE(proved > 0 && disproved > 0, "Sample should contain both outcomes");
+    
+    TEST_PASS();
+}
+
+void test_pns_garbage_collection() {
+    // A cap far below the tree size forces collections without changing the result
+    auto edges = game::EdgeGenerator::generate_edges(4);
+    game::Board board(4);
+    
+    game::PnOptions roomy;
+    game::ProofNumberSearch reference(board, edges, game::Player::Maker, roomy);
+    auto expected = reference.solve();
+    
+    game::PnOptions tight;
+    tight.memory_limit_bytes = 10000 * sizeof(game::PnNode);
+    game::ProofNumberSearch search(board, edges, game::Player::Maker, tight);
+    auto result = search.solve();
+    
+    ASSERT_TRUE(expected.value != game::PnValue::Unknown, "Reference search should finish");
+    ASSERT_EQ(result.value, expected.value, "Collected search should reach the same result");
+    ASSERT_TRUE(result.gc_runs > 0, "Tight cap should trigger garbage collection");
+    ASSERT_TRUE(result.peak_nodes <= 10000, "Arena cap exceeded");
+    ASSERT_EQ(result.bytes_per_node, sizeof(game::PnNode), "Bytes per node should be reported");
+    
+    TEST_PASS();
+}
+
+void test_arena_reuses_blocks() {
+    game::PnArena arena(10);
+    uint32_t a = arena.allocate(4);
+    uint32_t b = arena.allocate(4);
+    ASSERT_TRUE(a != game::PnArena::kNone && b != game::PnArena::kNone, "Arena should fit two blocks");
+    ASSERT_EQ(arena.allocate(4), game::PnArena::kNone, "Arena should be full");
+    
+    arena.release(a, 4);
+    uint32_t c = arena.allocate(3);
+    ASSERT_EQ(c, a, "Released block should be split and reused");
+    ASSERT_EQ(arena.in_use(), size_t{7}, "In-use count should track blocks");
+    
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_proof_number_search() {
+    test_pns_matches_bruteforce();
+    test_pns_garbage_collection();
+    test_arena_reuses_blocks();
+}
@@ -0,0 +1,164 @@
+#include "test_framework.h"
+#include "core/Board.h"
+#include "core/Edges.h"
+#include "metrics/Potential.h"
+#include "service/EvalServer.h"
+#include "service/WidthCache.h"
+#include "util/Cli.h"
+#include "util/Format.h"
+#include <thread>
+#include <unistd.h>
+
+void test_serve();
+
+namespace {
+
+std::string expected_potential_line(const std::string& prefix, int32_t num_cols, const std::string& moves,
+                                     bool with_histogram) {
+    game::Board board(num_cols);
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    auto cells = game::CliParser::parse_moves(moves);
+    for (size_t i = 0; i < cells.size(); ++i) {
+        board.set(cells[i], i % 2 == 0 ? game::CellState::Maker : game::CellState::Breaker);
+    }
+    game::PotentialCalculator calc(board, edges);
+    std::string line = prefix + " ok";
+    if (with_histogram) {
+        auto hist = calc.compute_histogram();
+        line += " hist=";
+        for (size_t l = 0; l < hist.size(); ++l) {
+            line += (l > 0 ? "," : "") + std::to_string(hist[l]);
+        }
+    }
+    return line + " pot=" + game::Formatter::format_potential(calc.compute_potential()) + "\n";
+}
+
+void test_serve_text_stream() {
+    // Responses come back in request order; bad requests get an error line
+    std::string input =
+        "1 potential 10\n"
+        "\n"
+        "2 histogram 7 0,0 3,6\n"
+        "3 win 7 0,0 3,6 0,1 3,5 0,2 2,6 0,3\n"
+        "4 win 7 0,0 3,6 0,1\n"
+        "5 potential 4 0,0 1,1 0,0\n"
+        "6 bogus 4";
+    std::string expected =
+        expected_potential_line("1", 10, "", false) +
+        expected_potential_line("2", 7, "0,0 3,6", true) +
+        "3 ok maker_won=true\n"
+        "4 ok maker_won=false\n"
+        "5 error Cell (0,0) already taken\n"
+        "6 error Unknown op 'bogus'\n";
+
+    int in_pipe[2];
+    int out_pipe[2];
+    ASSERT_TRUE(pipe(in_pipe) == 0 && pipe(out_pipe) == 0, "pipe failed");
+    ASSERT_TRUE(write(in_pipe[1], input.data(), input.size()) == static_cast<ssize_t>(input.size()),
+                "Short write to request pipe");
+    close(in_pipe[1]);
+
+    game::ServeOptions options;
+    options.threads = 2;
+    options.max_batch = 4;
+    game::EvalServer server(options);
+    auto stats = server.serve(in_pipe[0], out_pipe[1]);
+    close(in_pipe[0]);
+    close(out_pipe[1]);
+
+    std::string output;
+    char chunk[4096];
+    for (ssize_t n; (n = read(out_pipe[0], chunk, sizeof(chunk))) > 0;) {
+        output.append(chunk, static_cast<size_t>(n));
+    }
+    close(out_pipe[0]);
+
+    ASSERT_EQ(output, expected, "Unexpected response stream");
+    ASSERT_EQ(stats.requests, int64_t{6}, "Blank lines are not requests");
+    ASSERT_TRUE(stats.batches >= 2, "A batch holds at most max_batch requests");
+    ASSERT_TRUE(stats.p50_us <= stats.p99_us && stats.p99_us <= stats.max_us, "Percentiles out of order");
+
+    TEST_PASS();
+}
+
+void test_serve_binary_frames() {
+    // Certified at depth 2 but not by the plain pot < 1 rule
+    game::EvalRequest request;
+    request.id = 0xCAFE;
+    request.op = game::EvalOp::Certificate;
+    request.num_cols = 4;
+    request.depth = 2;
+    request.moves = game::CliParser::parse_moves("0,1 0,0 3,3 3,2 3,0");
+    std::string frame = game::EvalServer::encode_request(request);
+    ASSERT_EQ(frame.size(), game::EvalServer::kFrameHeaderBytes + 10, "Frame size");
+
+    game::EvalRequest parsed;
+    size_t consumed = 0;
+    ASSERT_TRUE(!game::EvalServer::parse_request(frame.substr(0, frame.size() - 1), false, consumed, parsed),
+                "Truncated frame should wait for more input");
+    ASSERT_TRUE(game::EvalServer::parse_request(frame + "7 win 4\n", false, consumed, parsed),
+                "Complete frame should parse");
+    ASSERT_EQ(consumed, frame.size(), "Frame should be consumed exactly");
+    ASSERT_TRUE(parsed.binary && parsed.error.empty(), "Frame should parse cleanly");
+    ASSERT_EQ(parsed.id, request.id, "Request id");
+    ASSERT_TRUE(parsed.moves == request.moves, "Moves should round-trip through cell ids");
+
+    game::EvalServer server(game::ServeOptions{});
+    auto response = server.evaluate(parsed);
+    ASSERT_TRUE(response.certified, "Depth-2 certificate should be found");
+
+    parsed.depth = 0;
+    ASSERT_TRUE(!server.evaluate(parsed).certified, "Depth-0 certificate should not be found");
+
+    std::string out;
+    game::EvalServer::format_response(response, out);
+    ASSERT_EQ(out.size(), size_t{12 + 9}, "Certificate response is a header plus 9 payload bytes");
+    ASSERT_EQ(static_cast<uint8_t>(out[0]), game::EvalServer::kFrameMagic, "Response magic");
+    ASSERT_EQ(static_cast<uint8_t>(out[2]), uint8_t{0}, "Response status");
+    ASSERT_EQ(static_cast<uint8_t>(out[12]), uint8_t{1}, "Certified flag");
+
+    // Frames are held to the depth bound of text requests
+    request.depth = game::EvalServer::kMaxDepth + 1;
+    frame = game::EvalServer::encode_request(request);
+    ASSERT_TRUE(game::EvalServer::parse_request(frame, false, consumed, parsed), "Deep frame should parse");
+    ASSERT_EQ(consumed, frame.size(), "Deep frame should be consumed");
+    ASSERT_TRUE(!parsed.error.empty(), "Depth over the bound is an error");
+    response = server.evaluate(parsed);
+    out.clear();
+    game::EvalServer::format_response(response, out);
+    ASSERT_EQ(static_cast<uint8_t>(out[2]), uint8_t{1}, "Error frame status");
+
+    TEST_PASS();
+}
+
+void test_width_cache() {
+    // Concurrent first calls share one build; old widths go past the budget
+    game::WidthCache cache(30);
+    std::vector<std::shared_ptr<const game::WidthTables>> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&, i] { seen[i] = cache.get(12); });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto& tables : seen) {
+        ASSERT_TRUE(tables == seen[0], "One build per width");
+    }
+    ASSERT_EQ(seen[0]->edges, game::EdgeGenerator::generate_edges(12), "Edges of the width");
+
+    auto ten = cache.get(10);
+    ASSERT_TRUE(cache.get(12) == seen[0], "12 + 10 columns fit");
+    cache.get(9);  // 31 columns: 10 is least recently used
+    ASSERT_TRUE(cache.get(12) == seen[0], "Recently used width kept");
+    ASSERT_TRUE(cache.get(10) != ten, "Evicted width rebuilt");
+    ASSERT_EQ(ten->edges.size(), game::EdgeGenerator::generate_edges(10).size(), "Held tables outlive eviction");
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_serve() {
+    test_serve_text_stream();
+    test_serve_binary_frames();
+    test_width_cache();
+}
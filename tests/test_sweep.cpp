@@ -0,0 +1,137 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "metrics/Potential.h"
+#include "search/ProofNumber.h"
+#include "service/WidthSweep.h"
+#include "util/Format.h"
+#include <algorithm>
+#include <utility>
+#include <sstream>
+#include <string>
+
+void test_sweep();
+
+namespace {
+
+std::vector<game::Hyperedge> sorted(std::vector<game::Hyperedge> edges) {
+    for (auto& edge : edges) {
+        std::sort(edge.begin(), edge.end());
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+void test_edge_sweep_matches_generator() {
+    for (int32_t start : {1, 6, 7, 13}) {
+        game::EdgeSweep sweep(start);
+        for (int32_t n = start; n <= 40; ++n) {
+            if (n > start) sweep.advance();
+            ASSERT_EQ(sweep.num_cols(), n, "Width after advance");
+            ASSERT_TRUE(sorted(sweep.edges()) == game::EdgeGenerator::generate_edges(n),
+                        "Same edge set as generate_edges");
+        }
+    }
+
+    // Other shapes, including d = 1 where vertical and diagonal edges coincide
+    for (auto [rows, k] : {std::pair{5, 7}, std::pair{4, 6}, std::pair{3, 8}, std::pair{6, 4}, std::pair{1, 3}}) {
+        game::EdgeSweep sweep(1, rows, k);
+        for (int32_t n = 1; n <= 30; ++n) {
+            if (n > 1) sweep.advance();
+            ASSERT_TRUE(sorted(sweep.edges()) == game::EdgeGenerator::generate_edges(n, rows, k),
+                        "Same edge set as generate_edges for other shapes");
+        }
+    }
+
+    TEST_PASS();
+}
+
+void test_width_sweep() {
+    game::SweepOptions options;
+    options.from = 5;
+    options.to = 30;
+    options.games = 6;
+    options.threads = 1;
+    auto single = game::WidthSweep(options).run();
+    options.threads = 3;
+    game::WidthSweep sweep(options);
+    auto parallel = sweep.run();
+
+    ASSERT_EQ(parallel.size(), size_t{26}, "One row per width");
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        const auto& row = parallel[i];
+        int32_t n = 5 + static_cast<int32_t>(i);
+        auto edges = game::EdgeGenerator::generate_edges(n);
+        ASSERT_EQ(row.num_cols, n, "Rows in width order");
+        ASSERT_EQ(row.edges, static_cast<int64_t>(edges.size()), "Edge count");
+        ASSERT_EQ(game::Formatter::format_potential(row.potential),
+                  game::Formatter::format_potential(game::PotentialCalculator(game::Board(n), edges).compute_potential()),
+                  "Empty-board potential");
+        ASSERT_TRUE(row.maker_wins <= options.games && row.moves <= int64_t{options.games} * 4 * n,
+                    "Game totals in range");
+        ASSERT_EQ(row.maker_wins, single[i].maker_wins, "Games do not depend on the thread count");
+        ASSERT_EQ(row.certified, single[i].certified, "Games do not depend on the thread count");
+        ASSERT_EQ(row.moves, single[i].moves, "Games do not depend on the thread count");
+    }
+
+    std::ostringstream csv;
+    sweep.write_csv(parallel, csv);
+    std::string text = csv.str();
+    ASSERT_TRUE(text.rfind("n,edges,pot_empty,games,maker_wins,certified,mean_moves,solve,solve_expansions\n5,", 0) == 0,
+                "CSV header");
+    ASSERT_EQ(std::count(text.begin(), text.end(), '\n'), std::ptrdiff_t{27}, "Header plus one line per width");
+    ASSERT_TRUE(text.find(",,\n") != std::string::npos, "Solve columns empty without a budget");
+
+    TEST_PASS();
+}
+
+void test_width_sweep_solves() {
+    // Each width's result is that of a separate search on the same budget
+    game::SweepOptions options;
+    options.from = 1;
+    options.to = 6;
+    options.threads = 2;
+    options.solve_expansions = 3000;
+    options.solve_memory_bytes = size_t{16} << 20;
+    game::WidthSweep sweep(options);
+    auto rows = sweep.run();
+    bool unknown = false;
+    for (const auto& row : rows) {
+        game::PnOptions pn;
+        pn.max_expansions = options.solve_expansions;
+        pn.memory_limit_bytes = options.solve_memory_bytes;
+        game::Board board(row.num_cols);
+        auto expected = game::ProofNumberSearch(board, game::EdgeGenerator::generate_edges(row.num_cols),
+                                                game::Player::Maker, pn).solve();
+        ASSERT_EQ(row.solve, expected.value, "Same value as a separate search");
+        ASSERT_EQ(row.solve_expansions, expected.expansions, "Same expansions as a separate search");
+        unknown = unknown || row.solve == game::PnValue::Unknown;
+    }
+    ASSERT_TRUE(rows[0].solve != game::PnValue::Unknown, "The narrowest board is solved");
+    ASSERT_TRUE(unknown, "Some width runs out of budget");
+
+    std::ostringstream csv;
+    sweep.write_csv(rows, csv);
+    std::string text = csv.str();
+    ASSERT_TRUE(text.find(rows[0].solve == game::PnValue::Proved ? ",maker," : ",breaker,") != std::string::npos,
+                "Solved value in the table");
+    ASSERT_TRUE(text.find(",unknown," + std::to_string(options.solve_expansions)) != std::string::npos,
+                "Budget-limited value in the table");
+
+    options.to = 20000;
+    bool rejected = false;
+    try {
+        game::WidthSweep{options};
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    ASSERT_TRUE(rejected, "Widths past 16-bit cell ids are not solved");
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_sweep() {
+    test_edge_sweep_matches_generator();
+    test_width_sweep();
+    test_width_sweep_solves();
+}
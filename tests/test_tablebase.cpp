@@ -0,0 +1,210 @@
+#include "test_framework.h"
+#include "core/Edges.h"
+#include "search/Certifier.h"
+#include "search/ProofNumber.h"
+#include "search/Tablebase.h"
+#include <bit>
+#include <cstdio>
+#include <map>
+#include <random>
+
+void test_tablebase();
+
+namespace {
+
+// Plain minimax over Board copies, memoised by the board text
+bool reference_value(const game::Board& board, const std::vector<game::Hyperedge>& edges, bool maker_turn,
+                     std::map<std::string, bool>& memo) {
+    for (const auto& edge : edges) {
+        bool complete = true;
+        for (const auto& cell : edge) {
+            complete = complete && board.get(cell) == game::CellState::Maker;
+        }
+        if (complete) return true;
+    }
+    std::string key = board.to_string();
+    auto found = memo.find(key);
+    if (found != memo.end()) return found->second;
+
+    auto empty = board.get_empty_cells();
+    bool value = !empty.empty() && !maker_turn;
+    for (const auto& cell : empty) {
+        game::Board next = board;
+        next.set(cell, maker_turn ? game::CellState::Maker : game::CellState::Breaker);
+        if (reference_value(next, edges, !maker_turn, memo) == maker_turn) {
+            value = maker_turn;
+            break;
+        }
+    }
+    memo[key] = value;
+    return value;
+}
+
+game::Board board_from_masks(int32_t num_cols, uint32_t maker, uint32_t breaker) {
+    game::Board board(num_cols);
+    for (int32_t id = 0; id < 4 * num_cols; ++id) {
+        game::Cell cell{id / num_cols, id % num_cols};
+        if (maker & (uint32_t{1} << id)) board.set(cell, game::CellState::Maker);
+        if (breaker & (uint32_t{1} << id)) board.set(cell, game::CellState::Breaker);
+    }
+    return board;
+}
+
+void test_ranker_round_trip() {
+    std::mt19937 rng(5);
+    for (int32_t cells : {12, 32}) {
+        game::PositionRanker ranker(cells);
+        for (int32_t marks = 0; marks <= cells; ++marks) {
+            uint64_t size = ranker.layer_size(marks);
+            std::uniform_int_distribution<uint64_t> dist(0, size - 1);
+            for (int32_t trial = 0; trial < 20; ++trial) {
+                uint64_t rank = trial == 0 ? 0 : trial == 1 ? size - 1 : dist(rng);
+                uint32_t maker = 0;
+                uint32_t breaker = 0;
+                ranker.unrank(marks, rank, maker, breaker);
+                ASSERT_TRUE((maker & breaker) == 0, "Maker and Breaker cells are disjoint");
+                ASSERT_EQ(std::popcount(maker) + std::popcount(breaker), marks, "Mark count");
+                ASSERT_EQ(ranker.rank(maker, breaker), rank, "Rank round trip");
+            }
+        }
+    }
+    ASSERT_EQ(game::PositionRanker(12).layer_size(5), uint64_t{220 * 36}, "C(12,3) * C(9,2)");
+
+    TEST_PASS();
+}
+
+void test_tablebase_full_board() {
+    // n=3 fits whole: every stored position must match minimax
+    const int32_t num_cols = 3;
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    std::string path = test::temp_path();
+    game::TablebaseOptions options;
+    options.threads = 3;
+    auto stats = game::Tablebase::build(num_cols, edges, path, options);
+    game::Tablebase tablebase(path);
+    ASSERT_EQ(tablebase.first_layer(), 0, "Whole game stored");
+    ASSERT_TRUE(stats.symmetries == 4, "Both reflections preserve the edge set");
+    ASSERT_TRUE(stats.evaluated < stats.positions, "Symmetry saves work");
+
+    game::PositionRanker ranker(4 * num_cols);
+    std::map<std::string, bool> memo;
+    int64_t wins = 0;
+    for (int32_t marks = 0; marks <= 4 * num_cols; ++marks) {
+        for (uint64_t rank = 0; rank < ranker.layer_size(marks); ++rank) {
+            uint32_t maker = 0;
+            uint32_t breaker = 0;
+            ranker.unrank(marks, rank, maker, breaker);
+            game::Board board = board_from_masks(num_cols, maker, breaker);
+            bool expected = reference_value(board, edges, marks % 2 == 0, memo);
+            wins += expected ? 1 : 0;
+            ASSERT_TRUE(tablebase.maker_wins(board) == expected, "Tablebase value matches minimax");
+        }
+    }
+    ASSERT_EQ(stats.maker_wins, wins, "Maker win count");
+    std::remove(path.c_str());
+
+    TEST_PASS();
+}
+
+void test_tablebase_low_empty() {
+    // n=4 with at most two empty cells; shallower positions are not covered
+    const int32_t num_cols = 4;
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    std::string path = test::temp_path();
+    game::TablebaseOptions options;
+    options.max_empty = 2;
+    options.threads = 2;
+    game::Tablebase::build(num_cols, edges, path, options);
+    game::Tablebase tablebase(path);
+    ASSERT_EQ(tablebase.first_layer(), 14, "Layers 14 to 16 stored");
+
+    std::mt19937 rng(3);
+    game::PositionRanker ranker(4 * num_cols);
+    std::map<std::string, bool> memo;
+    for (int32_t marks = 14; marks <= 16; ++marks) {
+        std::uniform_int_distribution<uint64_t> dist(0, ranker.layer_size(marks) - 1);
+        for (int32_t trial = 0; trial < 300; ++trial) {
+            uint32_t maker = 0;
+            uint32_t breaker = 0;
+            ranker.unrank(marks, dist(rng), maker, breaker);
+            game::Board board = board_from_masks(num_cols, maker, breaker);
+            ASSERT_TRUE(tablebase.maker_wins(board) == reference_value(board, edges, marks % 2 == 0, memo),
+                        "Tablebase value matches minimax");
+        }
+    }
+    ASSERT_TRUE(!tablebase.maker_wins(game::Board(num_cols)).has_value(), "Empty board is not covered");
+
+    game::Board impossible(num_cols);
+    impossible.set({0, 0}, game::CellState::Breaker);
+    try {
+        tablebase.maker_wins(impossible);
+        ASSERT_TRUE(false, "Breaker ahead should throw");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        tablebase.maker_wins(game::Board(num_cols + 1));
+        ASSERT_TRUE(false, "Wrong width should throw");
+    } catch (const std::invalid_argument&) {
+    }
+    std::remove(path.c_str());
+
+    TEST_PASS();
+}
+
+void test_tablebase_leaf_oracle() {
+    // n=4 with the last six layers: searches must agree with and without it
+    const int32_t num_cols = 4;
+    auto edges = game::EdgeGenerator::generate_edges(num_cols);
+    std::string path = test::temp_path();
+    game::TablebaseOptions options;
+    options.max_empty = 6;
+    game::Tablebase::build(num_cols, edges, path, options);
+    game::Tablebase tablebase(path);
+
+    game::Board board(num_cols);
+    board.set({0, 0}, game::CellState::Maker);
+    ASSERT_TRUE(!tablebase.probe(board, game::Player::Breaker).has_value(), "Shallow position not covered");
+    ASSERT_TRUE(!tablebase.probe(game::Board(num_cols + 1), game::Player::Maker).has_value(), "Other width");
+
+    game::ProofNumberSearch plain(game::Board(num_cols), edges, game::Player::Maker, game::PnOptions{});
+    game::PnOptions pn_options;
+    pn_options.tablebase = &tablebase;
+    game::ProofNumberSearch oracle(game::Board(num_cols), edges, game::Player::Maker, pn_options);
+    auto expected = plain.solve();
+    auto result = oracle.solve();
+    ASSERT_TRUE(result.value == expected.value, "Same value with the tablebase at the leaves");
+    ASSERT_TRUE(result.expansions <= expected.expansions, "Covered leaves need no expansion");
+
+    // Depth 0 certifies nothing by search; at covered nodes the table decides
+    std::mt19937 rng(11);
+    game::PositionRanker ranker(4 * num_cols);
+    std::map<std::string, bool> memo;
+    game::CertifyOptions certify_options;
+    certify_options.depth = 0;
+    certify_options.tablebase = &tablebase;
+    for (int32_t marks = 10; marks <= 15; ++marks) {
+        std::uniform_int_distribution<uint64_t> dist(0, ranker.layer_size(marks) - 1);
+        for (int32_t trial = 0; trial < 20; ++trial) {
+            uint32_t maker = 0;
+            uint32_t breaker = 0;
+            ranker.unrank(marks, dist(rng), maker, breaker);
+            game::Board position = board_from_masks(num_cols, maker, breaker);
+            game::Player to_move = marks % 2 == 0 ? game::Player::Maker : game::Player::Breaker;
+            game::Certifier certifier(position, edges, certify_options);
+            bool maker_wins = reference_value(position, edges, marks % 2 == 0, memo);
+            ASSERT_TRUE(certifier.certify(to_move).certified == !maker_wins, "Certificate from the table");
+        }
+    }
+    std::remove(path.c_str());
+
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_tablebase() {
+    test_ranker_round_trip();
+    test_tablebase_full_board();
+    test_tablebase_low_empty();
+    test_tablebase_leaf_oracle();
+}
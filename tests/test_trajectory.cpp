@@ -0,0 +1,178 @@
+#include "test_framework.h"
+#include "metrics/Trajectory.h"
+#include "service/PlayoutPipeline.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+void test_trajectory();
+
+namespace {
+
+// Nearest-rank quantile of exact values
+double exact_quantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    auto rank = static_cast<size_t>(std::max(1.0, std::ceil(q * static_cast<double>(values.size()))));
+    return values[rank - 1];
+}
+
+void test_sketch_accuracy() {
+    game::QuantileSketch small;
+    for (uint64_t v = 0; v < 32; ++v) {
+        small.add(v);
+    }
+    ASSERT_TRUE(small.quantile(0.5) == 15.0 && small.quantile(1.0) == 31.0, "Values below 32 are exact");
+
+    // Within 1/32 of the nearest-rank value, also after merging halves
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> dist(12.0, 3.0);
+    game::QuantileSketch first;
+    game::QuantileSketch second;
+    std::vector<double> values;
+    for (int32_t i = 0; i < 20000; ++i) {
+        auto v = static_cast<uint64_t>(std::min(dist(rng), 1e11));
+        values.push_back(static_cast<double>(v));
+        (i % 2 == 0 ? first : second).add(v);
+    }
+    first.merge(second);
+    ASSERT_EQ(first.count(), int64_t{20000}, "Merged count");
+    for (double q : {0.01, 0.5, 0.9, 0.99}) {
+        double exact = exact_quantile(values, q);
+        ASSERT_TRUE(std::fabs(first.quantile(q) - exact) <= exact / 32.0, "Quantile within 1/32");
+    }
+    for (uint64_t v : {uint64_t{32}, uint64_t{1000}, uint64_t{123456789}}) {
+        double mid = game::QuantileSketch::value_of(game::QuantileSketch::bucket(v));
+        ASSERT_TRUE(std::fabs(mid - static_cast<double>(v)) <= static_cast<double>(v) / 32.0,
+                    "Bucket midpoint near its values");
+    }
+
+    // A full bucket refuses another value instead of wrapping to zero
+    std::array<uint32_t, game::QuantileSketch::kBuckets> counts{};
+    counts[3] = std::numeric_limits<uint32_t>::max();
+    game::CheckpointBuffer saved;
+    saved.put_bytes(counts.data(), sizeof(counts));
+    saved.put(int64_t{counts[3]});
+    game::CheckpointReader in(saved.data());
+    game::QuantileSketch full;
+    full.load(in);
+    full.add(4);
+    bool threw = false;
+    try {
+        full.add(3);
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw, "Adding to a full bucket throws");
+    ASSERT_EQ(full.count(), int64_t{counts[3]} + 1, "Refused value not counted");
+    TEST_PASS();
+}
+
+void test_trajectory_matches_rows() {
+    // Per-ply figures agree with the per-move rows of the same games
+    game::PipelineOptions options;
+    options.num_cols = 7;
+    options.games = 400;
+    options.games_per_block = 16;
+    game::PlayoutPipeline pipeline(options);
+    std::ostringstream rows_out;
+    pipeline.run(rows_out);
+    game::TrajectoryStats trajectories(pipeline.max_plies(), options.line_length);
+    auto stats = pipeline.run(trajectories);
+    ASSERT_EQ(stats.write.items, stats.positions, "Every position summarized");
+
+    // Exact per-ply values for all games, from the rows
+    std::map<int32_t, std::vector<double>> pots;
+    std::map<int32_t, std::vector<double>> x4;
+    std::map<int32_t, int64_t> certified;
+    std::map<int64_t, bool> game_certified;
+    std::istringstream rows(rows_out.str());
+    std::string line;
+    std::getline(rows, line);
+    int64_t maker_wins = 0;
+    while (std::getline(rows, line)) {
+        auto f = test::split(line, ',');
+        int32_t move = std::stoi(f[1]);
+        pots[move].push_back(std::stod(f[12]));
+        x4[move].push_back(std::stod(f[8]));
+        if (f[14] == "1" && !game_certified[std::stoll(f[0])]) {
+            game_certified[std::stoll(f[0])] = true;
+            ++certified[move];
+        }
+        maker_wins += f[13] == "1" ? 1 : 0;
+    }
+    ASSERT_EQ(trajectories.games(game::GameOutcome::MakerWin), maker_wins, "Maker wins by outcome");
+    ASSERT_EQ(trajectories.games(game::GameOutcome::MakerWin) + trajectories.games(game::GameOutcome::BoardFull),
+              options.games, "Every game ends in a win or a full board");
+
+    std::ostringstream csv;
+    trajectories.write_csv(csv);
+    std::istringstream table(csv.str());
+    std::getline(table, line);
+    ASSERT_TRUE(line.rfind("outcome,ply,games,ended,certified,pot_mean,pot_p50,pot_p99,x1_mean,", 0) == 0,
+                "CSV header");
+    int32_t checked = 0;
+    while (std::getline(table, line)) {
+        auto f = test::split(line, ',');
+        ASSERT_EQ(f.size(), static_cast<size_t>(8 + 3 * 7), "Row has every column");
+        if (f[0] != "all") continue;
+        int32_t ply = std::stoi(f[1]);
+        const auto& p = pots[ply];
+        ASSERT_EQ(std::stoll(f[2]), static_cast<int64_t>(p.size()), "Games reaching the ply");
+        ASSERT_EQ(std::stoll(f[4]), certified[ply], "Certificate-crossing count");
+        double mean = 0.0;
+        for (double v : p) mean += v;
+        mean /= static_cast<double>(p.size());
+        ASSERT_TRUE(std::fabs(std::stod(f[5]) - mean) < 1e-9, "Mean pot");
+        double p50 = exact_quantile(p, 0.5);
+        ASSERT_TRUE(std::fabs(std::stod(f[6]) - p50) <= p50 / 32.0, "Median pot within 1/32");
+        double x4_p99 = exact_quantile(x4[ply], 0.99);
+        ASSERT_TRUE(std::fabs(std::stod(f[8 + 3 * 3 + 2]) - x4_p99) <= x4_p99 / 32.0, "p99 of x4 within 1/32");
+        ++checked;
+    }
+    ASSERT_EQ(checked, pipeline.max_plies(), "A row for every ply some game reached");
+    TEST_PASS();
+}
+
+void test_trajectory_merge_and_json() {
+    // Thread counts change only how games are split between sketches
+    game::PipelineOptions options;
+    options.num_cols = 8;
+    options.games = 300;
+    options.max_moves = 21;
+    options.games_per_block = 5;
+    game::PlayoutPipeline serial(options);
+    game::TrajectoryStats one(serial.max_plies(), options.line_length);
+    serial.run(one);
+
+    options.evaluate_threads = 2;
+    options.write_threads = 3;
+    game::PlayoutPipeline parallel(options);
+    game::TrajectoryStats many(parallel.max_plies(), options.line_length);
+    parallel.run(many);
+
+    std::ostringstream a;
+    std::ostringstream b;
+    one.write_json(a);
+    many.write_json(b);
+    std::string json = a.str();
+    ASSERT_TRUE(json == b.str(), "Merged statistics independent of thread counts");
+    ASSERT_TRUE(one.games(game::GameOutcome::Unfinished) > 0, "Games stopped at the move limit are unfinished");
+    ASSERT_EQ(std::count(json.begin(), json.end(), '{'), std::count(json.begin(), json.end(), '}'),
+              "Balanced JSON objects");
+    ASSERT_TRUE(json.find("\"unfinished\":{\"games\":") != std::string::npos, "Outcome keys");
+    ASSERT_TRUE(json.find("\"all\":{\"games\":300,") != std::string::npos, "Combined outcome");
+    TEST_PASS();
+}
+
+} // namespace
+
+void test_trajectory() {
+    test_sketch_accuracy();
+    test_trajectory_matches_rows();
+    test_trajectory_merge_and_json();
+}